@@ -1,10 +1,46 @@
 #include "ushell_core.h"
+#include "ushell_core_transport.h"
+#include "ushell_core_utils.h"
 #include "uart_access.h"
 
+#if ((1 == uSHELL_IMPLEMENTS_LOG_SINK) && defined(ESP_PLATFORM))
+#include "esp_log.h"
+#endif /*((1 == uSHELL_IMPLEMENTS_LOG_SINK) && defined(ESP_PLATFORM))*/
+
+#if (((1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT) || (1 == uSHELL_IMPLEMENTS_UART_CONFIG)) && defined(ESP_PLATFORM))
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+/* called by the long commands through uShellYield() and by the long waits of the UART driver */
+static void appShellYield(void)
+{
+    /* a busy command lets the idle task run (it feeds the task watchdog) every 100 ms */
+    static TickType_t xLast = 0;
+    const TickType_t xNow = xTaskGetTickCount();
+    if ((xNow - xLast) >= pdMS_TO_TICKS(100)) {
+        xLast = xNow;
+        vTaskDelay(1);
+    }
+}
+#endif /*(((1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT) || (1 == uSHELL_IMPLEMENTS_UART_CONFIG)) && defined(ESP_PLATFORM))*/
+
 int main(void)
 {
     uart_setup();
-    Microshell::getShellPtr(pluginEntry(), "root")->Run();
+    /* the console UART instance as transport of the shell (see ushell_core_transport.h for the other backends) */
+    static uShellUartTransport sConsole(uart_console());
+    static const uShellIo_s sIo = uShellTransport<uShellUartTransport>::Io(&sConsole);
+    static Microshell sShell(pluginEntry(), &sIo, "root");
+#if ((1 == uSHELL_IMPLEMENTS_LOG_SINK) && defined(ESP_PLATFORM))
+    esp_log_set_vprintf(uShellLogVprintf);  /* the ESP_LOGx output is printed above the edited line */
+#endif /*((1 == uSHELL_IMPLEMENTS_LOG_SINK) && defined(ESP_PLATFORM))*/
+#if ((1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT) && defined(ESP_PLATFORM))
+    uShellSetYieldHook(appShellYield);
+#endif /*((1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT) && defined(ESP_PLATFORM))*/
+#if ((1 == uSHELL_IMPLEMENTS_UART_CONFIG) && defined(ESP_PLATFORM))
+    uart_set_yield(appShellYield);          /* '#B' waits seconds for the confirmation, with or without the time budgets */
+#endif /*((1 == uSHELL_IMPLEMENTS_UART_CONFIG) && defined(ESP_PLATFORM))*/
+    sShell.Run();
     return 0;
 }
 
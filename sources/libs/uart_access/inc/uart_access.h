@@ -6,9 +6,122 @@ extern "C" {
 #endif
 
 #include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include "ushell_core_printout.h"
 
+/* frame format and flow control, the stop values are the ones of UART_CONF0 */
+typedef struct {
+    uint8_t data_bits;          /* 5 .. 8 */
+    uint8_t parity;             /* UART_PARITY_xxx */
+    uint8_t stop;               /* UART_STOP_xxx */
+    uint8_t flow;               /* UART_FLOW_xxx */
+} uart_format_t;
+
+#define UART_PARITY_NONE        0
+#define UART_PARITY_EVEN        1
+#define UART_PARITY_ODD         2
+#define UART_STOP_1             1
+#define UART_STOP_1_5           2
+#define UART_STOP_2             3
+#define UART_FLOW_NONE          0
+#define UART_FLOW_RTS_CTS       1       /* by the hardware: CTS gates the transmitter, RTS follows the RX FIFO fill */
+#define UART_FLOW_XON_XOFF      2       /* by the RX path, against the fill of the RX ring */
+#define UART_XON                0x11
+#define UART_XOFF               0x13
+#define UART_FORMAT_8N1         { 8, UART_PARITY_NONE, UART_STOP_1, UART_FLOW_NONE }
+
+/* divisor of a baud rate: baud = clk / (clkdiv + frag / 16), the UART is clocked by APB */
+#define UART_APB_HZ             80000000
+typedef struct {
+    uint32_t requested;
+    uint32_t baud;              /* achieved rate, rounded */
+    int32_t  error_ppm;         /* achieved vs requested */
+    uint32_t clkdiv;            /* integer part */
+    uint32_t frag;              /* fractional part, in 1/16 */
+} uart_baud_t;
+
+/* counters of a UART, since it was opened or the last reset */
+typedef struct {
+    uint32_t tx_bytes;
+    uint32_t rx_bytes;
+    uint32_t rx_overflows;      /* RX FIFO overflows, the bytes received meanwhile are lost */
+    uint32_t rx_dropped;        /* received with the RX ring full (XON/XOFF not honoured by the other side) */
+    uint32_t frame_errors;
+    uint32_t parity_errors;
+    uint32_t rx_peak;           /* highest RX ring fill */
+    uint32_t xoff_sent;
+    uint32_t xoff_received;
+    uint32_t tx_dropped;        /* left in the TX ring by a rate switch while XOFF or CTS held the line */
+    uint64_t tx_wait_us;        /* busy-waiting on a full TX ring */
+} uart_stats_t;
+
+/* port, pins and rings of an instance */
+typedef struct {
+    uint8_t  port;              /* 0 or 1 */
+    int8_t   tx_pin;            /* GPIO numbers, routed by the GPIO matrix */
+    int8_t   rx_pin;
+    int8_t   rts_pin;           /* -1: not routed, no UART_FLOW_RTS_CTS */
+    int8_t   cts_pin;
+    uint8_t *rx_ring;           /* owned by the caller, sizes are powers of 2 */
+    uint32_t rx_size;
+    uint8_t *tx_ring;
+    uint32_t tx_size;
+} uart_inst_cfg_t;
+
+/* state of an instance, only accessed through the uart_inst_xxx() functions */
+typedef struct {
+    uintptr_t base;             /* register block */
+    uint8_t  port;
+    bool     has_rts_cts;
+    bool     tx_paused;         /* XOFF received */
+    bool     xoff_sent;
+    uint8_t *rx_ring;
+    uint8_t *tx_ring;
+    uint32_t rx_size;
+    uint32_t tx_size;
+    uint32_t rx_head, rx_tail;  /* free running, the fill is head - tail */
+    uint32_t tx_head, tx_tail;
+    uart_format_t format;
+    uart_baud_t rate;
+    uart_stats_t stats;
+    uint64_t tx_wait_cycles;
+} uart_inst_t;
+
+/* instances: any port, pins and ring sizes, opened at 115200 8N1 */
+int  uart_inst_open(uart_inst_t *uart, const uart_inst_cfg_t *cfg);     /* -1 invalid port or ring size, or the port of the ESP-IDF console */
+int  uart_inst_getchar(uart_inst_t *uart);
+int  uart_inst_trygetchar(uart_inst_t *uart);                           /* -1 when nothing was received */
+int  uart_inst_txfree(uart_inst_t *uart);                               /* free bytes in the TX ring */
+void uart_inst_putchar(uart_inst_t *uart, char c);
+int  uart_inst_read(uart_inst_t *uart, void *buf, int maxlen);          /* never blocks, bytes read */
+int  uart_inst_write(uart_inst_t *uart, const void *buf, int len);      /* blocks until all is queued */
+int  uart_inst_configure(uart_inst_t *uart, uint32_t baud, uart_format_t format, uart_baud_t *rate);
+void uart_inst_config_get(uart_inst_t *uart, uart_format_t *format, uart_baud_t *rate);
+int  uart_inst_switch(uart_inst_t *uart, uint32_t baud, uart_format_t format, uint32_t timeout_ms);
+void uart_set_yield(void (*yield)(void));                              /* called by the long waits, i.e. lets the idle task feed the watchdog */
+void uart_inst_stats_get(uart_inst_t *uart, uart_stats_t *stats);
+void uart_inst_stats_reset(uart_inst_t *uart);
+
+/* the console: UART1, TX GPIO17, RX GPIO21, RTS GPIO18, CTS GPIO16, used by uart_getchar(), uart_read(), uart_printf() ... */
 void uart_setup(void);
+uart_inst_t *uart_console(void);
+
+/* pure helpers, no register access: they build on the host too */
+int  uart_baud_calc(uint32_t clk_hz, uint32_t baud, uart_baud_t *rate);    /* -1 out of the divisor range */
+int  uart_format_parse(const char *str, uart_format_t *format);             /* "8N1", "7E2", "8O1.5", -1 if invalid, flow unchanged */
+void uart_format_name(uart_format_t format, char name[6]);
+/* the formatter of the shell on the target: flags - 0 + space, width, precision, l ll z h, d i u x X c s p %; always terminated */
+int  uart_vsnprintf(char *buf, int maxlen, const char *fmt, va_list args);
+int  uart_snprintf(char *buf, int maxlen, const char *fmt, ...);
+
+/* rate, format and counters of the console */
+int  uart_configure(uint32_t baud, uart_format_t format, uart_baud_t *rate);   /* rate may be NULL */
+void uart_config_get(uart_format_t *format, uart_baud_t *rate);
+/* switches and waits for an Enter at the new rate, 0 kept, 1 reverted (no Enter in time), -1 invalid */
+int  uart_switch(uint32_t baud, uart_format_t format, uint32_t timeout_ms);
+void uart_stats_get(uart_stats_t *stats);
+void uart_stats_reset(void);
 
 
 #ifdef __cplusplus
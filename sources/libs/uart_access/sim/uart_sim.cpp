@@ -0,0 +1,316 @@
+#include "uart_sim.h"
+#include "uart_access.h"
+#include <stdint.h>
+#include <string.h>
+
+// Register offsets and fields, as used by uart_access.cpp
+#define SIM_FIFO                0x00
+#define SIM_INT_RAW             0x04
+#define SIM_INT_ST              0x08
+#define SIM_INT_ENA             0x0C
+#define SIM_INT_CLR             0x10
+#define SIM_CLKDIV              0x14
+#define SIM_STATUS              0x1C
+#define SIM_CONF0               0x20
+#define SIM_CONF1               0x24
+#define SIM_MEM_CONF            0x60
+#define SIM_REGS_SIZE           0x80
+
+#define SIM_CONF0_PARITY_EN     (1 << 1)
+#define SIM_CONF0_TX_FLOW_EN    (1 << 15)
+#define SIM_CONF1_RX_FLOW_EN    (1 << 20)
+
+typedef struct {
+    uint32_t regs[SIM_REGS_SIZE / 4];
+    uint8_t  rx_fifo[UART_SIM_FIFO_SIZE];
+    uint8_t  tx_fifo[UART_SIM_FIFO_SIZE];
+    uint32_t rx_head, rx_tail;                  // free running, the count is head - tail
+    uint32_t tx_head, tx_tail;
+    uint64_t tx_free_ps;                        // the transmitter is busy until then
+    uint64_t rx_next_ps;                        // end of the next frame of the other side
+    uint8_t  in[UART_SIM_LINE_SIZE];            // queued by the other side
+    uint8_t  out[UART_SIM_LINE_SIZE];           // sent by the UART
+    uint32_t in_head, in_tail;
+    uint32_t out_head, out_tail;
+    bool     cts;
+    bool     remote_paused;                     // the other side got an XOFF
+    int      remote_flow;
+    uint32_t pending_err;
+    void   (*isr)(int port);
+    bool     in_isr;
+} uart_sim_port_t;
+
+uint32_t g_uart_sim_io_mux[64];
+uint32_t g_uart_sim_gpio[512];
+
+static uart_sim_port_t g_sim[UART_SIM_PORTS];
+static uint64_t g_now_ps;
+
+static void sim_process(bool isr);
+
+
+/*--------------------------------------------------*/
+static inline uart_sim_port_t *sim_port(uintptr_t base)
+{
+    return &g_sim[(UART_SIM_UART1_BASE == base) ? 1 : 0];
+}
+
+
+/*--------------------------------------------------*/
+static uint64_t sim_frame_ps(const uart_sim_port_t *p)
+{
+    // start + data + parity + stop bits, in half bits for the 1.5 stop bits
+    const uint32_t conf0 = p->regs[SIM_CONF0 / 4];
+    const uint32_t half_bits = 2 * (1 + (5 + ((conf0 >> 2) & 3)) + ((conf0 & SIM_CONF0_PARITY_EN) ? 1 : 0)) + (1 + ((conf0 >> 4) & 3));
+    const uint32_t clkdiv = p->regs[SIM_CLKDIV / 4];
+    uint64_t div16 = ((uint64_t)(clkdiv & 0xFFFFF) << 4) | ((clkdiv >> 20) & 0xF);
+    if (div16 < 16) {
+        div16 = 16;
+    }
+    // half_bits * (div16 / 16) / APB / 2, in ps
+    return ((uint64_t)half_bits * div16 * 1000000000000ULL) / ((uint64_t)UART_APB_HZ * 32);
+}
+
+
+/*--------------------------------------------------*/
+static inline bool sim_rts(const uart_sim_port_t *p)
+{
+    // asserted (ready to receive) below the RX flow threshold
+    if (0 == (p->regs[SIM_CONF1 / 4] & SIM_CONF1_RX_FLOW_EN)) {
+        return true;
+    }
+    return (p->rx_head - p->rx_tail) < ((p->regs[SIM_MEM_CONF / 4] >> 7) & 0x1FF);
+}
+
+
+/*--------------------------------------------------*/
+UartSimReg::operator uint32_t() const
+{
+    uart_sim_port_t *p = sim_port(m_base);
+    uint32_t value;
+
+    g_now_ps += UART_SIM_ACCESS_NS * 1000ULL;
+    sim_process(false);
+    switch (m_offset) {
+        case SIM_FIFO:
+            value = (p->rx_head != p->rx_tail) ? p->rx_fifo[p->rx_tail++ % UART_SIM_FIFO_SIZE] : 0;
+            break;
+        case SIM_INT_ST:
+            value = p->regs[SIM_INT_RAW / 4] & p->regs[SIM_INT_ENA / 4];
+            break;
+        case SIM_STATUS:
+            value = (p->rx_head - p->rx_tail) | ((p->tx_head - p->tx_tail) << 16);
+            break;
+        default:
+            value = p->regs[(m_offset % SIM_REGS_SIZE) / 4];
+            break;
+    }
+    return value;
+}
+
+
+/*--------------------------------------------------*/
+UartSimReg &UartSimReg::operator=(uint32_t value)
+{
+    uart_sim_port_t *p = sim_port(m_base);
+
+    g_now_ps += UART_SIM_ACCESS_NS * 1000ULL;
+    sim_process(false);
+    switch (m_offset) {
+        case SIM_FIFO:
+            if ((p->tx_head - p->tx_tail) < UART_SIM_FIFO_SIZE) {
+                if ((p->tx_head == p->tx_tail) && (p->tx_free_ps < g_now_ps)) {
+                    p->tx_free_ps = g_now_ps;   // idle line: the frame starts now
+                }
+                p->tx_fifo[p->tx_head++ % UART_SIM_FIFO_SIZE] = (uint8_t)value;
+            }
+            break;
+        case SIM_INT_CLR:
+            p->regs[SIM_INT_RAW / 4] &= ~value;
+            break;
+        case SIM_INT_RAW:
+        case SIM_INT_ST:
+        case SIM_STATUS:
+            break;                              // read only
+        default:
+            p->regs[(m_offset % SIM_REGS_SIZE) / 4] = value;
+            break;
+    }
+    sim_process(false);
+    return *this;
+}
+
+
+/*--------------------------------------------------*/
+void uart_sim_reset(void)
+{
+    memset(g_sim, 0, sizeof(g_sim));
+    memset(g_uart_sim_io_mux, 0, sizeof(g_uart_sim_io_mux));
+    memset(g_uart_sim_gpio, 0, sizeof(g_uart_sim_gpio));
+    g_now_ps = 0;
+    for (int i = 0; i < UART_SIM_PORTS; ++i) {
+        g_sim[i].regs[SIM_CLKDIV / 4]  = 694;               // reset values of the ESP32-S2
+        g_sim[i].regs[SIM_CONF0 / 4]   = 0x1C00001C;
+        g_sim[i].regs[SIM_CONF1 / 4]   = 0x0000C060;
+        g_sim[i].cts = true;
+    }
+}
+
+
+/*--------------------------------------------------*/
+uint64_t uart_sim_now_ns(void)
+{
+    return g_now_ps / 1000;
+}
+
+
+/*--------------------------------------------------*/
+uint32_t uart_sim_cycles(void)
+{
+    // reading the counter takes time too, so a busy-wait on it ends
+    g_now_ps += UART_SIM_ACCESS_NS * 1000ULL;
+    sim_process(false);
+    return (uint32_t)((g_now_ps * UART_SIM_CPU_MHZ) / 1000000);
+}
+
+
+/*--------------------------------------------------*/
+void uart_sim_advance_ns(uint64_t ns)
+{
+    g_now_ps += ns * 1000;
+    sim_process(true);
+}
+
+
+/*--------------------------------------------------*/
+int uart_sim_send(int port, const void *data, int len)
+{
+    uart_sim_port_t *p = &g_sim[port];
+    const uint8_t *src = (const uint8_t *)data;
+    int n = 0;
+
+    if ((p->in_head == p->in_tail) && (p->rx_next_ps < g_now_ps)) {
+        p->rx_next_ps = g_now_ps + sim_frame_ps(p);
+    }
+    for (; (n < len) && ((p->in_head - p->in_tail) < UART_SIM_LINE_SIZE); ++n) {
+        p->in[p->in_head++ % UART_SIM_LINE_SIZE] = src[n];
+    }
+    return n;
+}
+
+
+/*--------------------------------------------------*/
+int uart_sim_recv(int port, void *buf, int maxlen)
+{
+    uart_sim_port_t *p = &g_sim[port];
+    uint8_t *dst = (uint8_t *)buf;
+    int n = 0;
+
+    for (; (n < maxlen) && (p->out_tail != p->out_head); ++n) {
+        dst[n] = p->out[p->out_tail++ % UART_SIM_LINE_SIZE];
+    }
+    return n;
+}
+
+
+/*--------------------------------------------------*/
+int uart_sim_pending(int port)
+{
+    return (int)(g_sim[port].in_head - g_sim[port].in_tail);
+}
+
+
+/*--------------------------------------------------*/
+void uart_sim_set_cts(int port, bool ready)
+{
+    g_sim[port].cts = ready;
+    sim_process(false);
+}
+
+
+/*--------------------------------------------------*/
+bool uart_sim_get_rts(int port)
+{
+    return sim_rts(&g_sim[port]);
+}
+
+
+/*--------------------------------------------------*/
+void uart_sim_remote_flow(int port, int flow)
+{
+    g_sim[port].remote_flow = flow;
+    g_sim[port].remote_paused = false;
+}
+
+
+/*--------------------------------------------------*/
+void uart_sim_error(int port, uint32_t int_bits)
+{
+    g_sim[port].pending_err |= int_bits & (UART_SIM_INT_FRM_ERR | UART_SIM_INT_PARITY_ERR);
+}
+
+
+/*--------------------------------------------------*/
+void uart_sim_set_isr(int port, void (*isr)(int port))
+{
+    g_sim[port].isr = isr;
+}
+
+
+/*--------------------------------------------------*/
+static void sim_process(bool isr)
+{
+    for (int i = 0; i < UART_SIM_PORTS; ++i) {
+        uart_sim_port_t *p = &g_sim[i];
+        const uint64_t frame = sim_frame_ps(p);
+
+        // TX FIFO -> line, one frame after the other, CTS checked before each frame
+        const bool blocked = (0 != (p->regs[SIM_CONF0 / 4] & SIM_CONF0_TX_FLOW_EN)) && !p->cts;
+        while (!blocked && (p->tx_head != p->tx_tail) && ((p->tx_free_ps + frame) <= g_now_ps)) {
+            const uint8_t c = p->tx_fifo[p->tx_tail++ % UART_SIM_FIFO_SIZE];
+            p->tx_free_ps += frame;
+            if ((p->out_head - p->out_tail) < UART_SIM_LINE_SIZE) {
+                p->out[p->out_head++ % UART_SIM_LINE_SIZE] = c;
+            }
+            if ((UART_FLOW_XON_XOFF == p->remote_flow) && ((UART_XOFF == c) || (UART_XON == c))) {
+                p->remote_paused = (UART_XOFF == c);
+            }
+        }
+        if ((blocked || (p->tx_head == p->tx_tail)) && (p->tx_free_ps < g_now_ps)) {
+            p->tx_free_ps = g_now_ps;
+        }
+
+        // line -> RX FIFO, the other side holds on RTS or XOFF if it honours them
+        while ((p->in_head != p->in_tail) && (p->rx_next_ps <= g_now_ps)) {
+            if (((UART_FLOW_RTS_CTS == p->remote_flow) && !sim_rts(p)) ||
+                ((UART_FLOW_XON_XOFF == p->remote_flow) && p->remote_paused)) {
+                p->rx_next_ps = g_now_ps + frame;
+                break;
+            }
+            const uint8_t c = p->in[p->in_tail++ % UART_SIM_LINE_SIZE];
+            p->regs[SIM_INT_RAW / 4] |= p->pending_err;
+            p->pending_err = 0;
+            if ((p->rx_head - p->rx_tail) >= UART_SIM_FIFO_SIZE) {
+                p->regs[SIM_INT_RAW / 4] |= UART_SIM_INT_RXFIFO_OVF;   // lost
+            } else {
+                p->rx_fifo[p->rx_head++ % UART_SIM_FIFO_SIZE] = c;
+            }
+            p->rx_next_ps += frame;
+        }
+
+        // level interrupts from the FIFO thresholds of CONF1
+        const uint32_t conf1 = p->regs[SIM_CONF1 / 4];
+        const uint32_t rx_full = conf1 & 0x1FF;
+        if ((0 != rx_full) && ((p->rx_head - p->rx_tail) >= rx_full)) {
+            p->regs[SIM_INT_RAW / 4] |= UART_SIM_INT_RXFIFO_FULL;
+        }
+        if ((p->tx_head - p->tx_tail) < ((conf1 >> 9) & 0x1FF)) {
+            p->regs[SIM_INT_RAW / 4] |= UART_SIM_INT_TXFIFO_EMPTY;
+        }
+        if (isr && (NULL != p->isr) && !p->in_isr && (0 != (p->regs[SIM_INT_RAW / 4] & p->regs[SIM_INT_ENA / 4]))) {
+            p->in_isr = true;
+            p->isr(i);
+            p->in_isr = false;
+        }
+    }
+}
@@ -0,0 +1,80 @@
+#ifndef UART_SIM_H
+#define UART_SIM_H
+
+/*
+    Simulated ESP32-S2 UART for the host build of the driver (UART_SIMULATION):
+    the register macros of uart_access.cpp land here. Two ports with 128 byte
+    FIFOs, frames timed from CLKDIV and CONF0 on a virtual clock, RTS/CTS,
+    the raw/enabled interrupt bits and an ISR hook, run between two driver
+    calls as if the driver masked its interrupt. Every register access costs
+    UART_SIM_ACCESS_NS, so a busy-waiting driver moves the clock too.
+
+    The uart_sim_xxx() functions are the other end of the line.
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define UART_SIM_UART0_BASE     0x60000000
+#define UART_SIM_UART1_BASE     0x60010000
+#define UART_SIM_PORTS          2
+#define UART_SIM_FIFO_SIZE      128
+#define UART_SIM_LINE_SIZE      65536           // bytes queued by the other side / captured from the line, per port
+#define UART_SIM_CPU_MHZ        240
+#define UART_SIM_ACCESS_NS      25              // one register access over the peripheral bus
+
+// UART_INT_RAW / UART_INT_ENA / UART_INT_ST bits modelled
+#define UART_SIM_INT_RXFIFO_FULL    (1 << 0)
+#define UART_SIM_INT_TXFIFO_EMPTY   (1 << 1)
+#define UART_SIM_INT_PARITY_ERR     (1 << 2)
+#define UART_SIM_INT_FRM_ERR        (1 << 3)
+#define UART_SIM_INT_RXFIFO_OVF     (1 << 4)
+
+// pads and GPIO matrix, only stored
+extern uint32_t g_uart_sim_io_mux[64];
+extern uint32_t g_uart_sim_gpio[512];
+
+#ifdef __cplusplus
+
+/* one register: reads and writes have the side effects of the hardware (FIFO pop/push, clear on write) */
+class UartSimReg
+{
+public:
+    UartSimReg(uintptr_t base, uint32_t offset) : m_base(base), m_offset(offset) {}
+    operator uint32_t() const;
+    UartSimReg &operator=(uint32_t value);
+    UartSimReg &operator=(const UartSimReg &other) { return *this = (uint32_t)other; }
+
+private:
+    uintptr_t m_base;
+    uint32_t m_offset;
+};
+
+static inline UartSimReg uart_sim_reg(uintptr_t base, uint32_t offset)
+{
+    return UartSimReg(base, offset);
+}
+
+extern "C" {
+#endif
+
+void     uart_sim_reset(void);                                  // ports at their reset values, clock at 0
+uint64_t uart_sim_now_ns(void);
+uint32_t uart_sim_cycles(void);                                 // CPU cycles at UART_SIM_CPU_MHZ, wraps like ccount, costs one access
+void     uart_sim_advance_ns(uint64_t ns);                      // time spent by the CPU outside the driver
+
+// the other end of the line
+int      uart_sim_send(int port, const void *data, int len);    // sent at the line rate from now on, bytes queued
+int      uart_sim_recv(int port, void *buf, int maxlen);        // what the UART has sent, in order
+int      uart_sim_pending(int port);                            // queued by uart_sim_send(), not delivered yet
+void     uart_sim_set_cts(int port, bool ready);                // the RTS of the other side
+bool     uart_sim_get_rts(int port);
+void     uart_sim_remote_flow(int port, int flow);              // UART_FLOW_xxx honoured by the other side
+void     uart_sim_error(int port, uint32_t int_bits);           // UART_SIM_INT_FRM_ERR / _PARITY_ERR raised with the next byte
+void     uart_sim_set_isr(int port, void (*isr)(int port));     // called while INT_RAW & INT_ENA, from uart_sim_advance_ns() only
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*UART_SIM_H*/
@@ -1,177 +1,561 @@
 #include "uart_access.h"
+#include <stddef.h>
 #include <stdint.h>
-
-// Full Bare-Metal UART1 Setup (ESP32-S2)
-
+#include <string.h>
+
+#if defined(ESP_PLATFORM)
+#include "sdkconfig.h"
+#endif
+#if defined(UART_SIMULATION)
+#include "uart_sim.h"
+#endif
+
+// Bare-Metal UART driver (ESP32-S2), one instance per port
+
+#if defined(UART_SIMULATION)
+// host build: the registers are modelled by sim/uart_sim.cpp
+#define DR_REG_UART0_BASE       UART_SIM_UART0_BASE
+#define DR_REG_UART1_BASE       UART_SIM_UART1_BASE
+#define DR_REG_IO_MUX_BASE      ((uintptr_t)g_uart_sim_io_mux)
+#define DR_REG_GPIO_BASE        ((uintptr_t)g_uart_sim_gpio)
+#define UART_REG(u, off)        uart_sim_reg((u), (off))
+#else
+#define DR_REG_UART0_BASE       0x60000000
 #define DR_REG_UART1_BASE       0x60010000
 #define DR_REG_IO_MUX_BASE      0x60009000
 #define DR_REG_GPIO_BASE        0x60004000
-#define DPORT_PERIP_CLK_EN0_REG 0x3F400000  // Adjust if you're in IDF, else not used here
+#define UART_REG(u, off)        (*(volatile uint32_t *)((u) + (off)))
+#endif
+
+#define UART_TXFIFO_SIZE        128
+#define UART_RTS_LEVEL          96              // RX FIFO fill releasing RTS
 
 // UART Registers
-#define UART_FIFO(u)            (*(volatile uint32_t *)((u) + 0x0))
-#define UART_INT_CLR(u)         (*(volatile uint32_t *)((u) + 0x10))
-#define UART_CLKDIV(u)          (*(volatile uint32_t *)((u) + 0x14))
-#define UART_CONF0(u)           (*(volatile uint32_t *)((u) + 0x20))
-#define UART_CONF1(u)           (*(volatile uint32_t *)((u) + 0x24))
-#define UART_STATUS(u)          (*(volatile uint32_t *)((u) + 0x1C))
+#define UART_FIFO(u)            UART_REG(u, 0x0)
+#define UART_INT_RAW(u)         UART_REG(u, 0x04)
+#define UART_INT_CLR(u)         UART_REG(u, 0x10)
+#define UART_CLKDIV(u)          UART_REG(u, 0x14)
+#define UART_CONF0(u)           UART_REG(u, 0x20)
+#define UART_CONF1(u)           UART_REG(u, 0x24)
+#define UART_STATUS(u)          UART_REG(u, 0x1C)
+#define UART_MEM_CONF(u)        UART_REG(u, 0x60)
+
+// UART_STATUS fields
+#define UART_RXFIFO_CNT(s)      ((s) & 0x3FF)
+#define UART_TXFIFO_CNT(s)      (((s) >> 16) & 0x3FF)
+
+// UART_CONF0 fields
+#define UART_PARITY_BIT         (1 << 0)        // 1: odd
+#define UART_PARITY_EN          (1 << 1)
+#define UART_BIT_NUM_S          2               // data bits - 5
+#define UART_STOP_BIT_NUM_S     4               // 1, 1.5 or 2 stop bits
+#define UART_TX_FLOW_EN         (1 << 15)       // CTS gates the transmitter
+#define UART_TICK_REF_ALWAYS_ON (1 << 27)       // clocked by APB, not by REF_TICK
+#define UART_FORMAT_MASK        (UART_PARITY_BIT | UART_PARITY_EN | (3 << UART_BIT_NUM_S) | (3 << UART_STOP_BIT_NUM_S))
+
+// UART_CONF1 / UART_MEM_CONF fields
+#define UART_RX_FLOW_EN         (1 << 20)       // RTS driven by the RX FIFO fill
+#define UART_RX_FLOW_THRHD_S    7
+#define UART_RX_FLOW_THRHD_M    (0x1FF << UART_RX_FLOW_THRHD_S)
+
+// UART_INT_RAW / UART_INT_CLR bits
+#define UART_PARITY_ERR_INT     (1 << 2)
+#define UART_FRM_ERR_INT        (1 << 3)
+#define UART_RXFIFO_OVF_INT     (1 << 4)
+#define UART_ERR_INTS           (UART_PARITY_ERR_INT | UART_FRM_ERR_INT | UART_RXFIFO_OVF_INT)
+
+// CPU cycles for the busy-wait time
+#if defined(CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ)
+#define UART_CPU_MHZ            CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ
+#elif defined(CONFIG_ESP32S2_DEFAULT_CPU_FREQ_MHZ)
+#define UART_CPU_MHZ            CONFIG_ESP32S2_DEFAULT_CPU_FREQ_MHZ
+#elif defined(UART_SIMULATION)
+#define UART_CPU_MHZ            UART_SIM_CPU_MHZ
+#else
+#define UART_CPU_MHZ            240
+#endif
+
+// Pads: function 1 hands the pad to the GPIO matrix, which connects it to the UART signals
+#define IO_MUX_GPIO_REG(n)      ((uintptr_t)DR_REG_IO_MUX_BASE + 0x04 + 0x04 * (n))
+#define IO_MUX_MCU_SEL_M        (7 << 12)
+#define IO_MUX_MCU_SEL_GPIO     (1 << 12)
+#define IO_MUX_FUN_IE           (1 << 9)
+#define GPIO_ENABLE_W1TS_REG    (DR_REG_GPIO_BASE + 0x24)
+#define GPIO_ENABLE1_W1TS_REG   (DR_REG_GPIO_BASE + 0x30)
+#define GPIO_FUNC_IN_SEL_REG(s) ((uintptr_t)DR_REG_GPIO_BASE + 0x154 + 0x04 * (s))
+#define GPIO_FUNC_OUT_SEL_REG(n) ((uintptr_t)DR_REG_GPIO_BASE + 0x554 + 0x04 * (n))
+#define GPIO_SIG_IN_SEL         (1 << 7)
+
+// Console: UART1, GPIO17 (TX1), GPIO21 (RX1), GPIO18 (RTS1), GPIO16 (CTS1)
+#define UART_CONSOLE_PORT       1
+#define UART_CONSOLE_RX_RING    256
+#define UART_CONSOLE_TX_RING    512
+
+#define UART_BAUD_DEFAULT       115200
+
+// the ESP-IDF console (boot ROM, ESP_LOG, printf) keeps its UART, see CONFIG_ESP_CONSOLE_xxx
+#if defined(CONFIG_ESP_CONSOLE_UART) && defined(CONFIG_ESP_CONSOLE_UART_NUM)
+#define UART_IS_IDF_CONSOLE(p)  (CONFIG_ESP_CONSOLE_UART_NUM == (p))
+#else
+#define UART_IS_IDF_CONSOLE(p)  false
+#endif
+#define UART_SWITCH_CONFIRM     '\r'
+#define UART_FLUSH_IDLE_MS      250             // a flush without progress for that long gives up (XOFF or CTS), > 1 frame at 77 baud
+
+// register block and GPIO matrix signals of the ports
+typedef struct {
+    uintptr_t base;
+    uint8_t  txd_out, rxd_in, rts_out, cts_in;
+} uart_port_desc_t;
+
+static const uart_port_desc_t g_ports[] = {
+    { DR_REG_UART0_BASE, 14, 14, 15, 15 },
+    { DR_REG_UART1_BASE, 17, 17, 18, 18 },
+};
+
+// output of the formatter: a bounded buffer, or the console when buf is NULL
+typedef struct {
+    char *buf;
+    int   maxlen;
+    int   pos;
+} uart_fmt_out_t;
+
+static void uart_format(uart_fmt_out_t *out, const char *fmt, va_list args);
+static void uart_fmt_putc(uart_fmt_out_t *out, char c);
+static void uart_fmt_field(uart_fmt_out_t *out, const char *prefix, const char *body, int len, int width, bool left, char pad);
+static void uart_check_errors(uart_inst_t *uart);
+static inline uint32_t uart_cycles(void);
+static void uart_wait_cycles(uint64_t cycles);
+static void uart_tx_flush(uart_inst_t *uart);
+static void uart_rx_flush(uart_inst_t *uart);
+static void uart_poll(uart_inst_t *uart);
+static void uart_send_now(uart_inst_t *uart, uint8_t c);
+static void uart_pin_out(int pin, uint32_t signal);
+static void uart_pin_in(int pin, uint32_t signal);
+
+static uint8_t g_console_rx[UART_CONSOLE_RX_RING];
+static uint8_t g_console_tx[UART_CONSOLE_TX_RING];
+static uart_inst_t g_console;
+static void (*g_yield)(void) = NULL;
+
+
+/*--------------------------------------------------*/
+int uart_inst_open(uart_inst_t *uart, const uart_inst_cfg_t *cfg)
+{
+    if ((cfg->port >= sizeof(g_ports) / sizeof(g_ports[0])) || UART_IS_IDF_CONSOLE(cfg->port) ||
+        (cfg->rx_size < 4) || (0 != (cfg->rx_size & (cfg->rx_size - 1))) ||
+        (cfg->tx_size < 1) || (0 != (cfg->tx_size & (cfg->tx_size - 1)))) {
+        return -1;
+    }
+
+    memset(uart, 0, sizeof(*uart));
+    uart->base        = g_ports[cfg->port].base;
+    uart->port        = cfg->port;
+    uart->has_rts_cts = (cfg->rts_pin >= 0) && (cfg->cts_pin >= 0);
+    uart->rx_ring     = cfg->rx_ring;
+    uart->rx_size     = cfg->rx_size;
+    uart->tx_ring     = cfg->tx_ring;
+    uart->tx_size     = cfg->tx_size;
+
+    // Enable TX and RX FIFO, default FIFO thresholds
+    UART_CONF1(uart->base) = 0x60;  // TXFIFO empty threshold = 96
+
+    // Configure 115200 8N1, the divisor has a fractional part (see uart_inst_configure)
+    const uart_format_t format = UART_FORMAT_8N1;
+    uart_inst_configure(uart, UART_BAUD_DEFAULT, format, NULL);
+
+    // Clear all pending interrupts
+    UART_INT_CLR(uart->base) = 0xFFFFFFFF;
+
+    // Pins, RTS/CTS only used with UART_FLOW_RTS_CTS
+    const uart_port_desc_t *desc = &g_ports[cfg->port];
+    uart_pin_out(cfg->tx_pin, desc->txd_out);
+    uart_pin_in(cfg->rx_pin, desc->rxd_in);
+    if (uart->has_rts_cts) {
+        uart_pin_out(cfg->rts_pin, desc->rts_out);
+        uart_pin_in(cfg->cts_pin, desc->cts_in);
+    }
+    return 0;
+}
+
+
+/*--------------------------------------------------*/
+int uart_inst_configure(uart_inst_t *uart, uint32_t baud, uart_format_t format, uart_baud_t *rate)
+{
+    // baud = APB_CLK / (CLKDIV + CLKDIV_FRAG / 16), no oversampling factor:
+    // 115200 -> 694 + 7/16 (+10 ppm), 921600 -> 86 + 13/16 (-80 ppm), 2000000 -> 40
+    uart_baud_t calc;
+    if ((0 != uart_baud_calc(UART_APB_HZ, baud, &calc)) ||
+        (format.data_bits < 5) || (format.data_bits > 8) ||
+        (format.parity > UART_PARITY_ODD) || (format.stop < UART_STOP_1) || (format.stop > UART_STOP_2) ||
+        (format.flow > UART_FLOW_XON_XOFF) || ((UART_FLOW_RTS_CTS == format.flow) && !uart->has_rts_cts)) {
+        return -1;
+    }
+
+    uint32_t conf0 = (uint32_t)(format.data_bits - 5) << UART_BIT_NUM_S;
+    conf0 |= (uint32_t)format.stop << UART_STOP_BIT_NUM_S;
+    if (UART_PARITY_NONE != format.parity) {
+        conf0 |= UART_PARITY_EN | ((UART_PARITY_ODD == format.parity) ? UART_PARITY_BIT : 0);
+    }
+    uint32_t conf1 = UART_CONF1(uart->base) & ~UART_RX_FLOW_EN;
+    if (UART_FLOW_RTS_CTS == format.flow) {
+        conf0 |= UART_TX_FLOW_EN;
+        conf1 |= UART_RX_FLOW_EN;
+        UART_MEM_CONF(uart->base) = (UART_MEM_CONF(uart->base) & ~UART_RX_FLOW_THRHD_M) | (UART_RTS_LEVEL << UART_RX_FLOW_THRHD_S);
+    }
+    UART_CLKDIV(uart->base) = calc.clkdiv | (calc.frag << 20);
+    UART_CONF0(uart->base)  = (UART_CONF0(uart->base) & ~(UART_FORMAT_MASK | UART_TX_FLOW_EN)) | conf0 | UART_TICK_REF_ALWAYS_ON;
+    UART_CONF1(uart->base)  = conf1;
+
+    // a new setting starts without a pending XOFF on either side
+    uart->tx_paused = false;
+    uart->xoff_sent = false;
+
+    uart->format = format;
+    uart->rate = calc;
+    if (NULL != rate) {
+        *rate = calc;
+    }
+    return 0;
+}
+
+
+/*--------------------------------------------------*/
+void uart_inst_config_get(uart_inst_t *uart, uart_format_t *format, uart_baud_t *rate)
+{
+    *format = uart->format;
+    *rate = uart->rate;
+}
+
+
+/*--------------------------------------------------*/
+int uart_inst_switch(uart_inst_t *uart, uint32_t baud, uart_format_t format, uint32_t timeout_ms)
+{
+    const uart_format_t old_format = uart->format;
+    const uint32_t old_baud = uart->rate.requested;
+    uart_baud_t calc;
+
+    if (0 != uart_baud_calc(UART_APB_HZ, baud, &calc)) {
+        return -1;
+    }
+
+    // the pending output leaves at the old rate, what arrives meanwhile is garbage
+    uart_tx_flush(uart);
+    if (0 != uart_inst_configure(uart, baud, format, NULL)) {
+        return -1;
+    }
+    uart_rx_flush(uart);
+
+    // the other side confirms with an Enter at the new rate, noise at a wrong rate hardly decodes as one
+    const uint64_t limit = (uint64_t)timeout_ms * 1000 * UART_CPU_MHZ;
+    uint64_t elapsed = 0;
+    uint32_t last = uart_cycles();
+    while (elapsed < limit) {
+        if (0 != UART_RXFIFO_CNT(UART_STATUS(uart->base))) {
+            if (UART_SWITCH_CONFIRM == (UART_FIFO(uart->base) & 0xFF)) {
+                return 0;
+            }
+        }
+        if (NULL != g_yield) {
+            g_yield();                              // seconds of waiting: longer than the task watchdog
+        }
+        const uint32_t now = uart_cycles();
+        elapsed += (uint32_t)(now - last);
+        last = now;
+    }
+
+    uart_tx_flush(uart);
+    uart_inst_configure(uart, old_baud, old_format, NULL);
+    uart_rx_flush(uart);
+    return 1;
+}
+
+
+/*--------------------------------------------------*/
+void uart_set_yield(void (*yield)(void))
+{
+    g_yield = yield;
+}
+
+
+/*--------------------------------------------------*/
+void uart_inst_stats_get(uart_inst_t *uart, uart_stats_t *stats)
+{
+    uart_check_errors(uart);
+    uart->stats.tx_wait_us = uart->tx_wait_cycles / UART_CPU_MHZ;
+    *stats = uart->stats;
+}
+
+
+/*--------------------------------------------------*/
+void uart_inst_stats_reset(uart_inst_t *uart)
+{
+    memset(&uart->stats, 0, sizeof(uart->stats));
+    uart->tx_wait_cycles = 0;
+}
+
+
+/*--------------------------------------------------*/
+int uart_inst_getchar(uart_inst_t *uart)
+{
+    int c;
+    while (-1 == (c = uart_inst_trygetchar(uart))) {}  // the TX ring keeps draining meanwhile
+    return c;
+}
+
+
+/*--------------------------------------------------*/
+int uart_inst_trygetchar(uart_inst_t *uart)
+{
+    uart_poll(uart);
+    if (uart->rx_head == uart->rx_tail) {           // RX ring empty, don't wait
+        return -1;
+    }
+    const int c = uart->rx_ring[uart->rx_tail++ & (uart->rx_size - 1)];
+    if (uart->xoff_sent && ((uart->rx_head - uart->rx_tail) <= (uart->rx_size / 4))) {
+        uart->xoff_sent = false;
+        uart_send_now(uart, UART_XON);
+    }
+    return c;
+}
+
+
+/*--------------------------------------------------*/
+int uart_inst_txfree(uart_inst_t *uart)
+{
+    uart_poll(uart);
+    return (int)(uart->tx_size - (uart->tx_head - uart->tx_tail));
+}
+
+
+/*--------------------------------------------------*/
+void uart_inst_putchar(uart_inst_t *uart, char c)
+{
+    if ((uart->tx_head - uart->tx_tail) >= uart->tx_size) {
+        const uint32_t start = uart_cycles();
+        do {                                        // Wait for TX ring not full, an XOFF holds it
+            uart_poll(uart);
+        } while ((uart->tx_head - uart->tx_tail) >= uart->tx_size);
+        uart->tx_wait_cycles += (uint32_t)(uart_cycles() - start);
+    }
+    uart->tx_ring[uart->tx_head++ & (uart->tx_size - 1)] = (uint8_t)c;
+    ++uart->stats.tx_bytes;
+    uart_poll(uart);
+}
 
-// GPIO function select: MUX settings for GPIO17 (TX1) and GPIO21 (RX1)
-#define IO_MUX_GPIO17_REG       (DR_REG_IO_MUX_BASE + 0x44)
-#define IO_MUX_GPIO21_REG       (DR_REG_IO_MUX_BASE + 0x58)
 
-#define UART1                   DR_REG_UART1_BASE
-#define UART_BAUD_DIV           115200
+/*--------------------------------------------------*/
+int uart_inst_read(uart_inst_t *uart, void *buf, int maxlen)
+{
+    uint8_t *dst = (uint8_t *)buf;
+    int n = 0;
+
+    // while the ring is empty the bytes go straight from the FIFO, one count read for all of them
+    if ((uart->rx_head == uart->rx_tail) && (UART_FLOW_XON_XOFF != uart->format.flow)) {
+        uint32_t count = UART_RXFIFO_CNT(UART_STATUS(uart->base));
+        if (0 != count) {
+            uart_check_errors(uart);
+        }
+        for (; (count > 0) && (n < maxlen); --count) {
+            dst[n++] = UART_FIFO(uart->base) & 0xFF;
+        }
+        uart->stats.rx_bytes += (uint32_t)n;
+    }
+
+    // then from the ring, in at most two copies
+    uart_poll(uart);
+    while ((n < maxlen) && (uart->rx_tail != uart->rx_head)) {
+        const uint32_t index = uart->rx_tail & (uart->rx_size - 1);
+        uint32_t chunk = uart->rx_head - uart->rx_tail;
+        chunk = (chunk < (uart->rx_size - index)) ? chunk : (uart->rx_size - index);
+        chunk = (chunk < (uint32_t)(maxlen - n)) ? chunk : (uint32_t)(maxlen - n);
+        memcpy(&dst[n], &uart->rx_ring[index], chunk);
+        uart->rx_tail += chunk;
+        n += (int)chunk;
+    }
+    if (uart->xoff_sent && ((uart->rx_head - uart->rx_tail) <= (uart->rx_size / 4))) {
+        uart->xoff_sent = false;
+        uart_send_now(uart, UART_XON);
+    }
+    return n;
+}
 
-static void print_int(int value, int width, char pad);
-static void print_hex(unsigned int value, int width, char pad);
-static void print_int_to_buf(char *buf, int *pos, int maxlen, int value, int width, char pad);
-static void print_hex_to_buf(char *buf, int *pos, int maxlen, unsigned int value, int width, char pad);
 
+/*--------------------------------------------------*/
+int uart_inst_write(uart_inst_t *uart, const void *buf, int len)
+{
+    const uint8_t *src = (const uint8_t *)buf;
+    int n = 0;
+
+    // while the ring is empty the bytes go straight to the FIFO, one count read for all of them
+    if ((uart->tx_head == uart->tx_tail) && !uart->tx_paused) {
+        uint32_t room = UART_TXFIFO_SIZE - UART_TXFIFO_CNT(UART_STATUS(uart->base));
+        for (; (room > 0) && (n < len); --room) {
+            UART_FIFO(uart->base) = src[n++];
+        }
+    }
+
+    // the rest through the ring, in at most two copies per pass
+    while (n < len) {
+        const uint32_t room = uart->tx_size - (uart->tx_head - uart->tx_tail);
+        if (0 == room) {
+            const uint32_t start = uart_cycles();
+            do {                                    // Wait for TX ring not full, an XOFF holds it
+                uart_poll(uart);
+            } while ((uart->tx_head - uart->tx_tail) >= uart->tx_size);
+            uart->tx_wait_cycles += (uint32_t)(uart_cycles() - start);
+            continue;
+        }
+        const uint32_t index = uart->tx_head & (uart->tx_size - 1);
+        uint32_t chunk = (room < (uart->tx_size - index)) ? room : (uart->tx_size - index);
+        chunk = (chunk < (uint32_t)(len - n)) ? chunk : (uint32_t)(len - n);
+        memcpy(&uart->tx_ring[index], &src[n], chunk);
+        uart->tx_head += chunk;
+        n += (int)chunk;
+        uart_poll(uart);
+    }
+    uart->stats.tx_bytes += (uint32_t)len;
+    return len;
+}
 
 
 /*--------------------------------------------------*/
 void uart_setup(void) 
 {
-    // Configure UART1 baud rate: clk_div = APB_CLK / (baud * 16)
-    // APB_CLK = 80 MHz → 80,000,000 / (115200 * 16) ≈ 43
-    UART_CLKDIV(UART1) = 43 << 0;
+    const uart_inst_cfg_t cfg = {
+        .port    = UART_CONSOLE_PORT,
+        .tx_pin  = 17,
+        .rx_pin  = 21,
+        .rts_pin = 18,
+        .cts_pin = 16,
+        .rx_ring = g_console_rx,
+        .rx_size = sizeof(g_console_rx),
+        .tx_ring = g_console_tx,
+        .tx_size = sizeof(g_console_tx),
+    };
+    uart_inst_open(&g_console, &cfg);
+}
 
-    // Configure 8N1 format (8 data, no parity, 1 stop)
-    UART_CONF0(UART1) = 0;
 
-    // Enable TX and RX FIFO, default FIFO thresholds
-    UART_CONF1(UART1) = 0x60;  // TXFIFO empty threshold = 96
+/*--------------------------------------------------*/
+uart_inst_t *uart_console(void)
+{
+    return &g_console;
+}
 
-    // Clear all pending interrupts
-    UART_INT_CLR(UART1) = 0xFFFFFFFF;
 
-    // Configure GPIO17 (TXD1)
-    *(volatile uint32_t *)IO_MUX_GPIO17_REG = 0x10;  // Function 2 = UART1 TX
-    *(volatile uint32_t *)(DR_REG_GPIO_BASE + 0x90 + 0x04 * 17) = (2 << 0); // Set GPIO function 2
+/*--------------------------------------------------*/
+int uart_configure(uint32_t baud, uart_format_t format, uart_baud_t *rate)
+{
+    return uart_inst_configure(&g_console, baud, format, rate);
+}
+
+
+/*--------------------------------------------------*/
+void uart_config_get(uart_format_t *format, uart_baud_t *rate)
+{
+    uart_inst_config_get(&g_console, format, rate);
+}
+
+
+/*--------------------------------------------------*/
+int uart_switch(uint32_t baud, uart_format_t format, uint32_t timeout_ms)
+{
+    return uart_inst_switch(&g_console, baud, format, timeout_ms);
+}
+
 
-    // Configure GPIO21 (RXD1)
-    *(volatile uint32_t *)IO_MUX_GPIO21_REG = 0x10;  // Function 2 = UART1 RX
-    *(volatile uint32_t *)(DR_REG_GPIO_BASE + 0x90 + 0x04 * 21) = (2 << 0); // Set GPIO function 2
+/*--------------------------------------------------*/
+void uart_stats_get(uart_stats_t *stats)
+{
+    uart_inst_stats_get(&g_console, stats);
 }
 
+
+/*--------------------------------------------------*/
+void uart_stats_reset(void)
+{
+    uart_inst_stats_reset(&g_console);
+}
+
+
 /*--------------------------------------------------*/
 int uart_getchar(void) 
 {
-    while (!(UART_STATUS(UART1) & (0xFF << 0))) {}  // Wait for RX FIFO to have data
-    return UART_FIFO(UART1) & 0xFF;
+    return uart_inst_getchar(&g_console);
+}
+
+
+/*--------------------------------------------------*/
+int uart_trygetchar(void)
+{
+    return uart_inst_trygetchar(&g_console);
+}
+
+
+/*--------------------------------------------------*/
+int uart_txfree(void)
+{
+    return uart_inst_txfree(&g_console);
 }
 
 
 /*--------------------------------------------------*/
 void uart_putchar(char c) 
 {
-    while (!(UART_STATUS(UART1) & (1 << 1))) {}     // Wait for TX FIFO not full
-    UART_FIFO(UART1) = c;
+    uart_inst_putchar(&g_console, c);
+}
+
+
+/*--------------------------------------------------*/
+int uart_read(void *buf, int maxlen)
+{
+    return uart_inst_read(&g_console, buf, maxlen);
+}
+
+
+/*--------------------------------------------------*/
+int uart_write(const void *buf, int len)
+{
+    return uart_inst_write(&g_console, buf, len);
 }
 
 
 /*--------------------------------------------------*/
 int uart_printf(const char *fmt, ...)
 {
+    uart_fmt_out_t out = { NULL, 0, 0 };
     va_list args;
     va_start(args, fmt);
-    while (*fmt) {
-        if (*fmt == '%') {
-            fmt++;
-            char pad = ' ';
-            int width = 0;
-            if (*fmt == '0') {
-                pad = '0';
-                fmt++;
-            }
-            while (*fmt >= '0' && *fmt <= '9') {
-                width = width * 10 + (*fmt - '0');
-                fmt++;
-            }
-            switch (*fmt) {
-                case 's': {
-                    const char *s = va_arg(args, const char *);
-                    while (*s) {
-                        uart_putchar(*s++);
-                    }
-                    break;
-                }
-                case 'd':
-                    print_int(va_arg(args, int), width, pad);
-                    break;
-                case 'x':
-                    print_hex(va_arg(args, unsigned int), width, pad);
-                    break;
-                case 'c':
-                    uart_putchar((char)va_arg(args, int));
-                    break;
-                default:
-                    uart_putchar('%');
-                    uart_putchar(*fmt);
-                    break;
-            }
-        } else {
-            uart_putchar(*fmt);
-        }
-        fmt++;
-    }
+    uart_format(&out, fmt, args);
     va_end(args);
 
-    return 0;
+    return out.pos;
 }
 
 
 
 /*--------------------------------------------------*/
-int uart_snprintf(char *buf, int maxlen, const char *fmt, ...)
+int uart_vsnprintf(char *buf, int maxlen, const char *fmt, va_list args)
 {
-    va_list args;
-    va_start(args, fmt);
-    int pos = 0;
+    uart_fmt_out_t out = { buf, maxlen, 0 };
 
-    while (*fmt && pos < maxlen - 1) {
-        if (*fmt == '%') {
-            fmt++;
-            char pad = ' ';
-            int width = 0;
-            if (*fmt == '0') {
-                pad = '0';
-                fmt++;
-            }
-            while (*fmt >= '0' && *fmt <= '9') {
-                width = width * 10 + (*fmt - '0');
-                fmt++;
-            }
-            switch (*fmt) {
-                case 's': {
-                    const char *s = va_arg(args, const char *);
-                    while (*s && pos < maxlen - 1) {
-                        buf[pos++] = *s++;
-                    }
-                    break;
-                }
-                case 'd':
-                    print_int_to_buf(buf, &pos, maxlen, va_arg(args, int), width, pad);
-                    break;
-                case 'x':
-                    print_hex_to_buf(buf, &pos, maxlen, va_arg(args, unsigned int), width, pad);
-                    break;
-                case 'c':
-                    buf[pos++] = (char)va_arg(args, int);
-                    break;
-                default:
-                    buf[pos++] = '%';
-                    buf[pos++] = *fmt;
-                    break;
-            }
-        } else {
-            buf[pos++] = *fmt;
-        }
-        fmt++;
+    if (maxlen <= 0) {
+        return 0;
     }
+    uart_format(&out, fmt, args);
+    buf[out.pos] = '\0';
+    return out.pos;
+}
 
-    buf[pos] = '\0';
+
+
+/*--------------------------------------------------*/
+int uart_snprintf(char *buf, int maxlen, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    int pos = uart_vsnprintf(buf, maxlen, fmt, args);
     va_end(args);
     return pos;
 }
@@ -184,95 +568,340 @@ int uart_snprintf(char *buf, int maxlen, const char *fmt, ...)
 
 
 /*--------------------------------------------------*/
-static void print_int(int value, int width, char pad)
+static void uart_poll(uart_inst_t *uart)
 {
-    char buffer[12];
-    int i = 0;
-    if (value < 0) {
-        uart_putchar('-');
-        value = -value;
-        width--;
+    // RX FIFO -> RX ring, the XON/XOFF of the other side are taken out here
+    const bool xon_xoff = (UART_FLOW_XON_XOFF == uart->format.flow);
+    uint32_t count = UART_RXFIFO_CNT(UART_STATUS(uart->base));
+    if (0 != count) {
+        uart_check_errors(uart);
+    }
+    for (; count > 0; --count) {
+        const uint32_t fill = uart->rx_head - uart->rx_tail;
+        if (!xon_xoff && (fill >= uart->rx_size)) {
+            break;                                  // left in the FIFO: RTS holds the other side
+        }
+        const uint8_t c = UART_FIFO(uart->base) & 0xFF;
+        if (xon_xoff && ((UART_XOFF == c) || (UART_XON == c))) {
+            uart->tx_paused = (UART_XOFF == c);
+            uart->stats.xoff_received += uart->tx_paused;
+            continue;
+        }
+        if (fill >= uart->rx_size) {
+            ++uart->stats.rx_dropped;               // still read: an XON may follow
+            continue;
+        }
+        uart->rx_ring[uart->rx_head++ & (uart->rx_size - 1)] = c;
+        ++uart->stats.rx_bytes;
+        if ((fill + 1) > uart->stats.rx_peak) {
+            uart->stats.rx_peak = fill + 1;
+        }
     }
-    do {
-        buffer[i++] = '0' + (value % 10);
-        value /= 10;
-    } while (value);
-    while (width-- > i) {
-        uart_putchar(pad);
+    if (xon_xoff && !uart->xoff_sent && ((uart->rx_head - uart->rx_tail) >= (uart->rx_size * 3 / 4))) {
+        uart->xoff_sent = true;
+        ++uart->stats.xoff_sent;
+        uart_send_now(uart, UART_XOFF);
     }
-    while (i--) {
-        uart_putchar(buffer[i]);
+
+    // TX ring -> TX FIFO, as much as fits
+    if (!uart->tx_paused) {
+        uint32_t room = UART_TXFIFO_SIZE - UART_TXFIFO_CNT(UART_STATUS(uart->base));
+        for (; (room > 0) && (uart->tx_tail != uart->tx_head); --room) {
+            UART_FIFO(uart->base) = uart->tx_ring[uart->tx_tail++ & (uart->tx_size - 1)];
+        }
     }
 }
 
 
+/*--------------------------------------------------*/
+static void uart_send_now(uart_inst_t *uart, uint8_t c)
+{
+    // ahead of the TX ring and regardless of an XOFF received, behind what the FIFO already holds
+    while (UART_TXFIFO_CNT(UART_STATUS(uart->base)) >= UART_TXFIFO_SIZE) {}
+    UART_FIFO(uart->base) = c;
+}
+
+
+/*--------------------------------------------------*/
+static void uart_check_errors(uart_inst_t *uart)
+{
+    // the raw flags stay set until cleared: one count per detection
+    const uint32_t raw = UART_INT_RAW(uart->base) & UART_ERR_INTS;
+    if (0 != raw) {
+        uart->stats.rx_overflows  += (0 != (raw & UART_RXFIFO_OVF_INT));
+        uart->stats.frame_errors  += (0 != (raw & UART_FRM_ERR_INT));
+        uart->stats.parity_errors += (0 != (raw & UART_PARITY_ERR_INT));
+        UART_INT_CLR(uart->base) = raw;
+    }
+}
+
 
 /*--------------------------------------------------*/
-static void print_hex(unsigned int value, int width, char pad)
+static void uart_pin_out(int pin, uint32_t signal)
 {
-    const char *hex = "0123456789ABCDEF";
-    char buffer[8];
-    int i = 0;
-    do {
-        buffer[i++] = hex[value & 0xF];
-        value >>= 4;
-    } while (value);
-    while (width-- > i + 2) {
-        uart_putchar(pad);
+    if (pin < 0) {
+        return;
+    }
+    volatile uint32_t *io_mux = (volatile uint32_t *)IO_MUX_GPIO_REG(pin);
+    *io_mux = (*io_mux & ~IO_MUX_MCU_SEL_M) | IO_MUX_MCU_SEL_GPIO;
+    *(volatile uint32_t *)GPIO_FUNC_OUT_SEL_REG(pin) = signal;
+    if (pin < 32) {
+        *(volatile uint32_t *)GPIO_ENABLE_W1TS_REG = (1UL << pin);
+    } else {
+        *(volatile uint32_t *)GPIO_ENABLE1_W1TS_REG = (1UL << (pin - 32));
     }
-    uart_putchar('0');
-    uart_putchar('x');
-    while (i--) {
-        uart_putchar(buffer[i]);
+}
+
+
+/*--------------------------------------------------*/
+static void uart_pin_in(int pin, uint32_t signal)
+{
+    if (pin < 0) {
+        return;
     }
+    volatile uint32_t *io_mux = (volatile uint32_t *)IO_MUX_GPIO_REG(pin);
+    *io_mux = (*io_mux & ~IO_MUX_MCU_SEL_M) | IO_MUX_MCU_SEL_GPIO | IO_MUX_FUN_IE;
+    *(volatile uint32_t *)GPIO_FUNC_IN_SEL_REG(signal) = GPIO_SIG_IN_SEL | (uint32_t)pin;
 }
 
 
+/*--------------------------------------------------*/
+static inline uint32_t uart_cycles(void)
+{
+#if defined(UART_SIMULATION)
+    return uart_sim_cycles();
+#elif defined(__xtensa__)
+    uint32_t ccount;
+    __asm__ __volatile__("rsr %0, ccount" : "=a"(ccount));
+    return ccount;
+#else
+    return 0;
+#endif
+}
+
+
+/*--------------------------------------------------*/
+static void uart_wait_cycles(uint64_t cycles)
+{
+    uint64_t elapsed = 0;
+    uint32_t last = uart_cycles();
+    while (elapsed < cycles) {
+        const uint32_t now = uart_cycles();
+        elapsed += (uint32_t)(now - last);
+        last = now;
+    }
+}
+
 
 /*--------------------------------------------------*/
-static void print_int_to_buf(char *buf, int *pos, int maxlen, int value, int width, char pad)
+static void uart_tx_flush(uart_inst_t *uart)
 {
-    char tmp[12];
-    int i = 0;
-    if (value < 0) {
-        if (*pos < maxlen - 1) buf[(*pos)++] = '-';
-        value = -value;
-        width--;
+    // empty ring and FIFO, then the last frame in the shift register (12 bits at most);
+    // a line held by XOFF or CTS without progress gives up: the ring is dropped, the FIFO leaves once released
+    const uint64_t idle_limit = (uint64_t)UART_FLUSH_IDLE_MS * 1000 * UART_CPU_MHZ;
+    uint64_t idle = 0;
+    uint32_t last = uart_cycles();
+    uint32_t left = (uart->tx_head - uart->tx_tail) + UART_TXFIFO_CNT(UART_STATUS(uart->base));
+    while (0 != left) {
+        uart_poll(uart);
+        const uint32_t now_left = (uart->tx_head - uart->tx_tail) + UART_TXFIFO_CNT(UART_STATUS(uart->base));
+        const uint32_t now = uart_cycles();
+        idle = (now_left < left) ? 0 : (idle + (uint32_t)(now - last));
+        last = now;
+        left = now_left;
+        if (idle >= idle_limit) {
+            uart->stats.tx_dropped += uart->tx_head - uart->tx_tail;
+            uart->tx_tail = uart->tx_head;
+            return;
+        }
     }
-    do {
-        tmp[i++] = '0' + (value % 10);
-        value /= 10;
-    } while (value);
-    while (width-- > i && *pos < maxlen - 1) {
-        buf[(*pos)++] = pad;
+    if (0 == uart->rate.baud) {
+        return;
     }
-    while (i-- && *pos < maxlen - 1) {
-        buf[(*pos)++] = tmp[i];
+    uart_wait_cycles(((uint64_t)12 * 1000000 * UART_CPU_MHZ) / uart->rate.baud + 1);
+}
+
+
+/*--------------------------------------------------*/
+static void uart_rx_flush(uart_inst_t *uart)
+{
+    while (0 != UART_RXFIFO_CNT(UART_STATUS(uart->base))) {
+        const uint32_t discarded = UART_FIFO(uart->base);   // the read pops the FIFO
+        (void)discarded;
+    }
+    uart->rx_tail = uart->rx_head;
+    UART_INT_CLR(uart->base) = UART_ERR_INTS;
+}
+
+
+/*--------------------------------------------------*/
+static void uart_fmt_putc(uart_fmt_out_t *out, char c)
+{
+    if (NULL == out->buf) {
+        uart_putchar(c);
+        ++out->pos;
+    } else if (out->pos < out->maxlen - 1) {    // the terminating NUL always fits
+        out->buf[out->pos++] = c;
     }
 }
 
 
 
 /*--------------------------------------------------*/
-static void print_hex_to_buf(char *buf, int *pos, int maxlen, unsigned int value, int width, char pad)
+static void uart_fmt_field(uart_fmt_out_t *out, const char *prefix, const char *body, int len, int width, bool left, char pad)
 {
-    const char *hex = "0123456789ABCDEF";
-    char tmp[8];
-    int i = 0;
-    do {
-        tmp[i++] = hex[value & 0xF];
-        value >>= 4;
-    } while (value);
-    if (*pos < maxlen - 2) {
-        buf[(*pos)++] = '0';
-        buf[(*pos)++] = 'x';
+    // the sign or 0x goes before the zero padding, the spaces around the whole field
+    int fill = width - (int)strlen(prefix) - len;
+    if (!left && (' ' == pad)) {
+        while (fill-- > 0) {
+            uart_fmt_putc(out, ' ');
+        }
+    }
+    while (*prefix) {
+        uart_fmt_putc(out, *prefix++);
     }
-    while (width-- > i + 2 && *pos < maxlen - 1) {
-        buf[(*pos)++] = pad;
+    if (!left && ('0' == pad)) {
+        while (fill-- > 0) {
+            uart_fmt_putc(out, '0');
+        }
+    }
+    while (len-- > 0) {
+        uart_fmt_putc(out, *body++);
     }
-    while (i-- && *pos < maxlen - 1) {
-        buf[(*pos)++] = tmp[i];
+    while (fill-- > 0) {
+        uart_fmt_putc(out, ' ');
     }
 }
 
 
+
+/*--------------------------------------------------*/
+static void uart_format(uart_fmt_out_t *out, const char *fmt, va_list args)
+{
+    // flags '-' '0' '+' ' ', width and precision (also '*'), l / ll / z / h, conversions d i u x X c s p %
+    static const char digits[] = "0123456789abcdef0123456789ABCDEF";
+
+    while (*fmt) {
+        if (*fmt != '%') {
+            uart_fmt_putc(out, *fmt++);
+            continue;
+        }
+        fmt++;
+        bool left = false;
+        char pad = ' ';
+        const char *sign = "";
+        for (;; fmt++) {
+            if (*fmt == '-') {
+                left = true;
+            } else if (*fmt == '0') {
+                pad = '0';
+            } else if (*fmt == '+') {
+                sign = "+";
+            } else if ((*fmt == ' ') && ('\0' == sign[0])) {
+                sign = " ";
+            } else if (*fmt != ' ') {
+                break;
+            }
+        }
+        int width = 0;
+        if (*fmt == '*') {
+            width = va_arg(args, int);
+            if (width < 0) {
+                left = true;
+                width = -width;
+            }
+            fmt++;
+        }
+        while (*fmt >= '0' && *fmt <= '9') {
+            width = width * 10 + (*fmt - '0');
+            fmt++;
+        }
+        int prec = -1;
+        if (*fmt == '.') {
+            fmt++;
+            prec = 0;
+            if (*fmt == '*') {
+                prec = va_arg(args, int);
+                fmt++;
+            }
+            while (*fmt >= '0' && *fmt <= '9') {
+                prec = prec * 10 + (*fmt - '0');
+                fmt++;
+            }
+        }
+        int longs = 0;
+        bool size = false;
+        for (;; fmt++) {
+            if (*fmt == 'l') {
+                longs++;
+            } else if (*fmt == 'z') {
+                size = true;
+            } else if (*fmt != 'h') {
+                break;
+            }
+        }
+
+        char tmp[24];
+        char *const end = tmp + sizeof(tmp);
+        char *digit = end;
+        const char *prefix = "";
+        unsigned long long value = 0;
+        unsigned int base = 10;
+        const char *set = digits;
+        switch (*fmt) {
+            case 'd':
+            case 'i': {
+                const long long v = (longs > 1) ? va_arg(args, long long) : (longs == 1) ? va_arg(args, long) :
+                                    size ? (long long)va_arg(args, ptrdiff_t) : va_arg(args, int);
+                value = (v < 0) ? (0ULL - (unsigned long long)v) : (unsigned long long)v;
+                prefix = (v < 0) ? "-" : sign;
+                break;
+            }
+            case 'u':
+            case 'x':
+            case 'X':
+                value = (longs > 1) ? va_arg(args, unsigned long long) : (longs == 1) ? va_arg(args, unsigned long) :
+                        size ? (unsigned long long)va_arg(args, size_t) : va_arg(args, unsigned int);
+                base = (*fmt == 'u') ? 10 : 16;
+                set = (*fmt == 'X') ? &digits[16] : digits;
+                break;
+            case 'p':
+                value = (uintptr_t)va_arg(args, void *);
+                base = 16;
+                prefix = "0x";
+                break;
+            case 'c':
+                tmp[0] = (char)va_arg(args, int);
+                uart_fmt_field(out, "", tmp, 1, width, left, ' ');
+                fmt++;
+                continue;
+            case 's': {
+                const char *s = va_arg(args, const char *);
+                int len = 0;
+                s = (NULL == s) ? "(null)" : s;
+                while (s[len] && ((prec < 0) || (len < prec))) {
+                    len++;
+                }
+                uart_fmt_field(out, "", s, len, width, left, ' ');
+                fmt++;
+                continue;
+            }
+            case '%':
+                uart_fmt_putc(out, '%');
+                fmt++;
+                continue;
+            default:                                // unknown: printed as is, no argument taken
+                uart_fmt_putc(out, '%');
+                if (*fmt) {
+                    uart_fmt_putc(out, *fmt++);
+                }
+                continue;
+        }
+        do {
+            *--digit = set[value % base];
+            value /= base;
+        } while (0 != value);
+        uart_fmt_field(out, prefix, digit, (int)(end - digit), width, left, pad);
+        fmt++;
+    }
+}
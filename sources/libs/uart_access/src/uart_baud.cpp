@@ -0,0 +1,78 @@
+#include "uart_access.h"
+#include <stdint.h>
+#include <string.h>
+
+// Divisor maths and frame format of the UART, without register access
+
+// the divisor has a 20 bit integer part, the hardware needs at least 16 clocks per bit
+#define UART_CLKDIV_MAX         0xFFFFF
+#define UART_CLKDIV_MIN         16
+
+
+/*--------------------------------------------------*/
+int uart_baud_calc(uint32_t clk_hz, uint32_t baud, uart_baud_t *rate)
+{
+    if (0 == baud) {
+        return -1;
+    }
+
+    // clk / baud in 1/16 steps, rounded to the nearest one
+    const uint64_t div16 = (((uint64_t)clk_hz << 4) + (baud >> 1)) / baud;
+    if ((div16 < ((uint64_t)UART_CLKDIV_MIN << 4)) || (div16 > (((uint64_t)UART_CLKDIV_MAX << 4) | 0xF))) {
+        return -1;
+    }
+
+    // the error comes from the exact divisor, not from the rounded rate
+    const int64_t actual16 = (int64_t)baud * (int64_t)div16;
+    const int64_t diff16 = ((int64_t)clk_hz << 4) - actual16;
+    const int64_t error = (diff16 * 1000000 + ((diff16 < 0) ? -(actual16 >> 1) : (actual16 >> 1))) / actual16;
+    rate->requested = baud;
+    rate->baud      = (uint32_t)((((uint64_t)clk_hz << 4) + (div16 >> 1)) / div16);
+    rate->error_ppm = (int32_t)error;
+    rate->clkdiv    = (uint32_t)(div16 >> 4);
+    rate->frag      = (uint32_t)(div16 & 0xF);
+    return 0;
+}
+
+
+/*--------------------------------------------------*/
+int uart_format_parse(const char *str, uart_format_t *format)
+{
+    uart_format_t parsed = *format;                 // the flow control is kept
+
+    if ((str[0] < '5') || (str[0] > '8')) {
+        return -1;
+    }
+    parsed.data_bits = (uint8_t)(str[0] - '0');
+
+    switch (str[1]) {
+        case 'N': case 'n': parsed.parity = UART_PARITY_NONE; break;
+        case 'E': case 'e': parsed.parity = UART_PARITY_EVEN; break;
+        case 'O': case 'o': parsed.parity = UART_PARITY_ODD;  break;
+        default: return -1;
+    }
+
+    if (0 == strcmp(&str[2], "1")) {
+        parsed.stop = UART_STOP_1;
+    } else if (0 == strcmp(&str[2], "1.5")) {
+        parsed.stop = UART_STOP_1_5;
+    } else if (0 == strcmp(&str[2], "2")) {
+        parsed.stop = UART_STOP_2;
+    } else {
+        return -1;
+    }
+
+    *format = parsed;
+    return 0;
+}
+
+
+/*--------------------------------------------------*/
+void uart_format_name(uart_format_t format, char name[6])
+{
+    static const char *stops[] = { "?", "1", "1.5", "2" };
+
+    name[0] = (char)('0' + (format.data_bits % 10));
+    name[1] = "NEO?"[format.parity & 3];
+    strcpy(&name[2], stops[format.stop & 3]);
+}
@@ -0,0 +1,576 @@
+#include "ushell_core.h"
+#include "ushell_core_transport.h"
+#include "ushell_core_utils.h"
+#include "ushell_bench_commands.h"
+#include "ushell_bench_checks.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <pthread.h>
+#include <unistd.h>
+
+/*
+    Functional checks of the shell core on the host, run by ushell_bench
+    before the benchmarks. Each check drives its own instance (of the bench
+    commands or of the root commands of ushell_user_root) through an
+    in-memory transport and looks at what the shell wrote; a failed check
+    makes ushell_bench exit with 1.
+*/
+
+#define uSHELL_CHECK_OUT_LEN        (4096U)
+#define uSHELL_CHECK_WAIT_MS        (1000U)     /* a check waiting for the shell loop gives up after that */
+
+/** \brief one check, returns false when it failed */
+typedef struct {
+    const char *pstrName;
+    bool (*pfRun)(void);
+} benchCheck_s;
+
+static char g_vcOut[uSHELL_CHECK_OUT_LEN];
+static uShellMemTransport g_sMem(g_vcOut, sizeof(g_vcOut));
+static const uShellIo_s g_sIo = uShellTransport<uShellMemTransport>::Io(&g_sMem);
+
+
+/*----------------------------------------------------------------------------*/
+static uint32_t checkNowMs(void)
+{
+    struct timespec sNow;
+    clock_gettime(CLOCK_MONOTONIC, &sNow);
+    return (uint32_t)((sNow.tv_sec * 1000) + (sNow.tv_nsec / 1000000));
+} /* checkNowMs() */
+
+
+/*----------------------------------------------------------------------------*/
+static bool checkOutputHas(const char *pstrText)
+{
+    const size_t szLen = strlen(pstrText);
+    const size_t szOut = g_sMem.OutputLen();
+
+    for(size_t i = 0; (szLen <= szOut) && (i <= szOut - szLen); ++i) {
+        if(0 == memcmp(&g_vcOut[i], pstrText, szLen)) {
+            return true;
+        }
+    }
+    return false;
+} /* checkOutputHas() */
+
+
+/*----------------------------------------------------------------------------*/
+static void checkType(Microshell *pShell, const char *pstrKeys)
+{
+    /* the keys of a terminal, whatever the Feed() calls look like */
+    pShell->Feed(pstrKeys, (int)strlen(pstrKeys));
+} /* checkType() */
+
+
+/*----------------------------------------------------------------------------*/
+static bool checkCommandOutput(void)
+{
+    /* what a command prints with uShellPrintf() goes to the transport of its instance, the coroutine chunks as well */
+    Microshell *pShell = new Microshell(pluginEntry(), &g_sIo, "check");
+    bool bRetVal = false;
+
+    pShell->Feed("#a\n", 3);
+    g_sMem.ClearOutput();
+    pShell->Feed("vtest\n", 6);
+    bRetVal = (true == checkOutputHas("--> vtest()\n"));
+#if (1 == uSHELL_IMPLEMENTS_COROUTINES)
+    g_sMem.ClearOutput();
+    pShell->Feed("ilist 2\n", 8);
+    for(int i = 0; i < 8; ++i) {
+        pShell->Poll();         /* one chunk per pass */
+    }
+    bRetVal = bRetVal && (true == checkOutputHas("--> ilist()\n")) && (true == checkOutputHas("line 2 / 2\n"));
+#endif /*(1 == uSHELL_IMPLEMENTS_COROUTINES)*/
+    delete pShell;
+
+    return bRetVal;
+} /* checkCommandOutput() */
+
+
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+/*----------------------------------------------------------------------------*/
+static bool checkAutocomplete(void)
+{
+    /* the root commands over the prefix trie: a unique prefix is completed with its separator, a branching one is not */
+    Microshell *pShell = new Microshell(pluginEntry(), &g_sIo, "check");
+    bool bRetVal = false;
+
+    g_sMem.ClearOutput();
+    checkType(pShell, "vt");
+    bRetVal = (true == checkOutputHas("test "));
+    checkType(pShell, "\n");
+    bRetVal = bRetVal && (true == checkOutputHas("--> vtest()\n"));
+
+    g_sMem.ClearOutput();
+    checkType(pShell, "s");         /* stest, sstest and sunhexlify */
+    bRetVal = bRetVal && (false == checkOutputHas("test")) && (false == checkOutputHas("unhexlify"));
+    checkType(pShell, "u");
+    bRetVal = bRetVal && (true == checkOutputHas("unhexlify "));
+    checkType(pShell, "41\n");
+    bRetVal = bRetVal && (true == checkOutputHas("--> sunhexlify()\n")) && (true == checkOutputHas("0 : 65 (0x41)\n"));
+    delete pShell;
+
+    return bRetVal;
+} /* checkAutocomplete() */
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)*/
+
+
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPL_ARGS)
+/*----------------------------------------------------------------------------*/
+static bool checkArgsAutocomplete(void)
+{
+    /* the arguments of sstest come from the register and encoding value sets of ushell_root_completions.cfg */
+    Microshell *pShell = new Microshell(pluginEntry(), &g_sIo, "check");
+    bool bRetVal = false;
+
+    g_sMem.ClearOutput();
+    checkType(pShell, "ss");
+    checkType(pShell, "cl");
+    checkType(pShell, "a");
+    bRetVal = (true == checkOutputHas("lkdiv ")) && (true == checkOutputHas("ascii "));
+    checkType(pShell, "\n");
+    bRetVal = bRetVal && (true == checkOutputHas("s1 = clkdiv\n")) && (true == checkOutputHas("s2 = ascii\n"));
+
+    /* conf0 and conf1 share "conf", the right arrow cycles them from the first one */
+    g_sMem.ClearOutput();
+    checkType(pShell, "st");
+    checkType(pShell, "co");
+    bRetVal = bRetVal && (true == checkOutputHas("onf"));
+    checkType(pShell, "\033[C");
+    bRetVal = bRetVal && (true == checkOutputHas("stest conf0 "));
+    checkType(pShell, "\033[C\n");
+    bRetVal = bRetVal && (true == checkOutputHas("stest conf1 ")) && (true == checkOutputHas("s = conf1\n"));
+    delete pShell;
+
+    return bRetVal;
+} /* checkArgsAutocomplete() */
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPL_ARGS)*/
+
+
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPL_RANKING)
+/*----------------------------------------------------------------------------*/
+static bool checkRankedAutocomplete(void)
+{
+    /* the sorted candidates of "i" are iitest, ilist, istest, itest: once used, itest is cycled first */
+    Microshell *pShell = new Microshell(pluginEntry(), &g_sIo, "check");
+    bool bRetVal = false;
+
+    checkType(pShell, "it");
+    checkType(pShell, "1\n");
+    g_sMem.ClearOutput();
+    checkType(pShell, "i");
+    checkType(pShell, "\033[D");   /* the left arrow hides the history suggestion and goes to the last one */
+    bRetVal = (true == checkOutputHas("\033[Kistest "));
+    g_sMem.ClearOutput();
+    checkType(pShell, "\033[C");
+    bRetVal = bRetVal && (true == checkOutputHas("\033[Kitest "));
+    checkType(pShell, "2\n");
+    bRetVal = bRetVal && (true == checkOutputHas("i = 2\n"));
+
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPL_FUZZY)
+    /* no command starts with "ex", the ranked vhexlify contains it */
+    checkType(pShell, "vh");
+    checkType(pShell, "\n");
+    g_sMem.ClearOutput();
+    checkType(pShell, "ex");
+    bRetVal = bRetVal && (false == checkOutputHas("vhexlify"));
+    checkType(pShell, "\033[C");
+    bRetVal = bRetVal && (true == checkOutputHas("\033[Kvhexlify "));
+    checkType(pShell, "\n");
+    bRetVal = bRetVal && (true == checkOutputHas("--> vhexlify()\n"));
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPL_FUZZY)*/
+    delete pShell;
+
+    return bRetVal;
+} /* checkRankedAutocomplete() */
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPL_RANKING)*/
+
+
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_SUGGEST)
+/*----------------------------------------------------------------------------*/
+static bool checkHistorySuggest(void)
+{
+    /* "itest 5" from the history is drawn after the typed "i", the right arrow takes it */
+    Microshell *pShell = new Microshell(pluginEntry(), &g_sIo, "check");
+    bool bRetVal = false;
+
+    pShell->Feed("#a\n", 3);
+    checkType(pShell, "itest 5\n");
+    g_sMem.ClearOutput();
+    checkType(pShell, "i");
+    bRetVal = (true == checkOutputHas(uSHELL_SUGGEST_COLOR "test 5"));
+    g_sMem.ClearOutput();
+    checkType(pShell, "t");         /* same suggestion, nothing drawn again */
+    bRetVal = bRetVal && (false == checkOutputHas("est 5"));
+    checkType(pShell, "\033[C");
+    bRetVal = bRetVal && (true == checkOutputHas("est 5"));
+    checkType(pShell, "\n");
+    bRetVal = bRetVal && (true == checkOutputHas("i = 5\n"));
+
+    /* a typed character leaving the history removes the suggestion */
+    g_sMem.ClearOutput();
+    checkType(pShell, "is");
+    bRetVal = bRetVal && (true == checkOutputHas("s\033[K"));
+    delete pShell;
+
+    return bRetVal;
+} /* checkHistorySuggest() */
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY_SUGGEST)*/
+
+
+#if (1 == uSHELL_IMPLEMENTS_HISTORY)
+/*----------------------------------------------------------------------------*/
+static bool checkSplitEscape(void)
+{
+    /* the arrow up comes one byte per Feed(), the decoder keeps the partial sequence in between */
+    Microshell *pShell = new Microshell(pluginEntry(), &g_sIo, "check");
+    bool bRetVal = false;
+
+    pShell->Feed("#a\n", 3);
+    checkType(pShell, "itest 7\n");
+    g_sMem.ClearOutput();
+    checkType(pShell, "\033");
+    g_sMem.ClearOutput();
+    checkType(pShell, "[");
+    bRetVal = (0U == g_sMem.OutputLen());    /* not echoed as a key */
+    checkType(pShell, "A");
+    bRetVal = bRetVal && (true == checkOutputHas("itest 7"));
+    g_sMem.ClearOutput();
+    checkType(pShell, "\n");
+    bRetVal = bRetVal && (true == checkOutputHas("--> itest()\n")) && (true == checkOutputHas("i = 7\n"));
+    delete pShell;
+
+    return bRetVal;
+} /* checkSplitEscape() */
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY)*/
+
+
+#if (1 == uSHELL_IMPLEMENTS_LOG_SINK)
+/*----------------------------------------------------------------------------*/
+static bool checkPollFor(Microshell *pShell, const char *pstrText)
+{
+    /* what other threads queue to the log sink is printed by the loop of the shell */
+    const uint32_t u32Start = checkNowMs();
+    while((false == checkOutputHas(pstrText)) && ((checkNowMs() - u32Start) < uSHELL_CHECK_WAIT_MS)) {
+        pShell->Poll();
+    }
+    return checkOutputHas(pstrText);
+} /* checkPollFor() */
+
+
+/*----------------------------------------------------------------------------*/
+static bool checkLogRedraw(void)
+{
+    /* a log arriving while "itest 4" is typed goes above it, the line is drawn again and still runs */
+    Microshell *pShell = new Microshell(pluginEntry(), &g_sIo, "check");
+    bool bRetVal = false;
+
+    pShell->Feed("#a\n", 3);
+    checkType(pShell, "itest 4");
+    g_sMem.ClearOutput();
+    uShellLogPrintf("sensor %d", 42);
+    bRetVal = (true == checkPollFor(pShell, "\r\033[Ksensor 42\n")) && (true == checkOutputHas("itest 4"));
+    g_sMem.ClearOutput();
+    checkType(pShell, "\n");
+    bRetVal = bRetVal && (true == checkOutputHas("i = 4\n"));
+    delete pShell;
+
+    return bRetVal;
+} /* checkLogRedraw() */
+#endif /*(1 == uSHELL_IMPLEMENTS_LOG_SINK)*/
+
+
+#if (1 == uSHELL_IMPLEMENTS_JOBS)
+/*----------------------------------------------------------------------------*/
+static bool checkJobs(void)
+{
+    /* vtest runs and ends on a worker, vbusy keeps running until '#c' cancels it */
+    Microshell *pShell = new Microshell(pluginEntry(), &g_sIo, "check");
+    bool bRetVal = false;
+
+    pShell->Feed("#a\n", 3);
+    g_sMem.ClearOutput();
+    checkType(pShell, "vtest &\n");
+    checkType(pShell, "#w\n");
+    bRetVal = (true == checkOutputHas("[1] vtest\n")) && (true == checkOutputHas("[1] done vtest => 0 (0x0)\n")) &&
+              (true == checkPollFor(pShell, "--> vtest()\n"));
+    g_sMem.ClearOutput();
+    checkType(pShell, "#j\n");
+    bRetVal = bRetVal && (true == checkOutputHas("[1] done ")) && (true == checkOutputHas(" => 0 (0x0)\n"));
+
+    g_sMem.ClearOutput();
+    checkType(pShell, "vbusy &\n");
+    bRetVal = bRetVal && (true == checkOutputHas("[2] vbusy\n"));
+    const uint32_t u32Start = checkNowMs();
+    do {    /* cancelled once running, a queued job would never print */
+        g_sMem.ClearOutput();
+        checkType(pShell, "#j\n");
+    } while((false == checkOutputHas("[2] running ")) && ((checkNowMs() - u32Start) < uSHELL_CHECK_WAIT_MS));
+    bRetVal = bRetVal && (true == checkOutputHas("[2] running "));
+    g_sMem.ClearOutput();
+    checkType(pShell, "#c 2\n");
+    checkType(pShell, "#w 2\n");
+    bRetVal = bRetVal && (true == checkOutputHas("[2] cancelled vbusy\n")) && (true == checkPollFor(pShell, "stopped after "));
+    delete pShell;
+
+    return bRetVal;
+} /* checkJobs() */
+#endif /*(1 == uSHELL_IMPLEMENTS_JOBS)*/
+
+
+#if ((1 == uSHELL_IMPLEMENTS_TRACE) && defined(uSHELL_BENCH_TRACE2JSON))
+/*----------------------------------------------------------------------------*/
+static bool checkTraceJson(void)
+{
+    /* the console capture holding the '#x' frame goes through ushell_trace2json (built next to ushell_bench) */
+    Microshell *pShell = new Microshell(pluginEntry(), &g_sIo, "check");
+    char vstrCapture[] = "/tmp/ushell_check_XXXXXX";
+    static char vstrJson[16384];
+    size_t szJson = 0;
+    bool bRetVal = false;
+
+    pShell->Feed("#a\n", 3);
+    checkType(pShell, "vtest\n");
+    g_sMem.ClearOutput();
+    checkType(pShell, "#x\n");
+    delete pShell;
+
+    const int iFd = mkstemp(vstrCapture);
+    if(iFd >= 0) {
+        const bool bWritten = ((ssize_t)g_sMem.OutputLen() == write(iFd, g_vcOut, g_sMem.OutputLen()));
+        close(iFd);
+        char vstrCmd[256];
+        snprintf(vstrCmd, sizeof(vstrCmd), "\"%s\" %s", uSHELL_BENCH_TRACE2JSON, vstrCapture);
+        FILE *pPipe = (true == bWritten) ? popen(vstrCmd, "r") : nullptr;
+        if(nullptr != pPipe) {
+            szJson = fread(vstrJson, 1, sizeof(vstrJson) - 1U, pPipe);
+            vstrJson[szJson] = '\0';
+            bRetVal = (0 == pclose(pPipe));
+        }
+        unlink(vstrCapture);
+    }
+
+    /* the keys of "vtest", then the command nested in the Enter key with its name and return value */
+    return (true == bRetVal) && (vstrJson == strstr(vstrJson, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n")) &&
+           (nullptr != strstr(vstrJson, "\"name\":\"key 'v'\"")) && (nullptr != strstr(vstrJson, "\"name\":\"parse\"")) &&
+           (nullptr != strstr(vstrJson, "\"name\":\"vtest\",\"args\":{\"index\":0}")) &&
+           (nullptr != strstr(vstrJson, "\"args\":{\"return\":0}")) && (nullptr != strstr(vstrJson, "\n]}\n"));
+} /* checkTraceJson() */
+#endif /*((1 == uSHELL_IMPLEMENTS_TRACE) && defined(uSHELL_BENCH_TRACE2JSON))*/
+
+
+#if (1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS)
+/** \brief what the poster thread posts and what its completion callback saw */
+typedef struct {
+    Microshell  *pShell;
+    parsedCmd_s  sToCallback;
+    parsedCmd_s  sToFuture;
+    postFuture_s sFuture;
+    volatile bool bCalled;
+    volatile int  iCallbackRetVal;
+    bool          bPosted;
+} checkPost_s;
+
+
+/*----------------------------------------------------------------------------*/
+static void checkPostDone(void *pvCtx, const int iRetVal)
+{
+    checkPost_s *psPost = (checkPost_s*)pvCtx;
+
+    psPost->iCallbackRetVal = iRetVal;
+    psPost->bCalled = true;
+} /* checkPostDone() */
+
+
+/*----------------------------------------------------------------------------*/
+static void *checkPoster(void *pvPost)
+{
+    checkPost_s *psPost = (checkPost_s*)pvPost;
+
+    psPost->bPosted = (true == psPost->pShell->Post(&psPost->sToCallback, checkPostDone, psPost)) &&
+                      (true == psPost->pShell->Post(&psPost->sToFuture, &psPost->sFuture));
+    return nullptr;
+} /* checkPoster() */
+
+
+/*----------------------------------------------------------------------------*/
+static bool checkPostThread(void)
+{
+    /* two void commands posted by another thread, run by the loop of the shell: the bench commands return their index */
+    const uShellInst_s *psInst = benchEntry();
+    Microshell *pShell = new Microshell(psInst, &g_sIo, "check");
+    static checkPost_s sPost;
+    pthread_t sPoster;
+    bool bOk = false;
+
+    sPost.pShell  = pShell;
+    sPost.bCalled = false;
+    sPost.iCallbackRetVal = -1;
+    sPost.sFuture.iRetVal = -1;
+    g_sMem.ClearOutput();
+    if((0 == pShell->Parse(psInst->psFuncDefArray[0].pstrFctName, &sPost.sToCallback)) &&
+       (0 == pShell->Parse(psInst->psFuncDefArray[uSHELL_BENCH_NR_PATTERNS].pstrFctName, &sPost.sToFuture)) &&
+       (0 == pthread_create(&sPoster, nullptr, checkPoster, &sPost))) {
+        const uint32_t u32Start = checkNowMs();
+        while(((false == sPost.bCalled) || (false == sPost.sFuture.bDone.load(std::memory_order_acquire))) && ((checkNowMs() - u32Start) < uSHELL_CHECK_WAIT_MS)) {
+            pShell->Poll();
+        }
+        pthread_join(sPoster, nullptr);
+        bOk = (true == sPost.bPosted) && (true == sPost.bCalled) && (0 == sPost.iCallbackRetVal) &&
+              (true == sPost.sFuture.bDone.load(std::memory_order_acquire)) && (uSHELL_BENCH_NR_PATTERNS == sPost.sFuture.iRetVal) &&
+              (true == checkOutputHas("[posted] ")) && (true == checkOutputHas(psInst->psFuncDefArray[uSHELL_BENCH_NR_PATTERNS].pstrFctName));
+    }
+    delete pShell;
+    return bOk;
+} /* checkPostThread() */
+#endif /*(1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS)*/
+
+
+#if (1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT)
+static uint32_t g_u32FakeMs = 0U;
+
+/*----------------------------------------------------------------------------*/
+static uint32_t checkFakeClock(void)
+{
+    /* every reading is 1 ms later: a loop polling the budget spends it in as many turns, whatever the machine */
+    return g_u32FakeMs++;
+} /* checkFakeClock() */
+
+
+/*----------------------------------------------------------------------------*/
+static bool checkBudgetOverrun(void)
+{
+    /* vbusy of the root commands only stops when its budget is spent, the shell reports the overrun */
+    const uShellInst_s *psInst = pluginEntry();
+    Microshell *pShell = new Microshell(psInst, &g_sIo, "check");
+    uint32_t u32BudgetMs = 0U;
+    char vstrOverrun[64];
+
+    for(int i = 0; i < psInst->iNrFunctions; ++i) {
+        if(0 == strcmp(psInst->psFuncDefArray[i].pstrFctName, "vbusy")) {
+            u32BudgetMs = psInst->pfBudget(i);
+        }
+    }
+    snprintf(vstrOverrun, sizeof(vstrOverrun), "(budget %u ms)", (unsigned int)u32BudgetMs);
+
+    g_u32FakeMs = 0U;
+    uShellSetClock(checkFakeClock);
+    g_sMem.ClearOutput();
+    pShell->Feed("#a\n", 3);         /* whole lines are typed, no autocomplete */
+    g_sMem.ClearOutput();
+    const uint32_t u32Start = g_u32FakeMs;
+    pShell->Feed("vbusy\n", 6);
+    const uint32_t u32Spent = g_u32FakeMs - u32Start;
+    uShellSetClock(nullptr);
+    delete pShell;
+
+    /* a few readings around the command are not part of the budget */
+    return (0U != u32BudgetMs) && (u32Spent >= u32BudgetMs) && (u32Spent < (u32BudgetMs + 100U)) &&
+           (true == checkOutputHas("[overrun] vbusy: ")) && (true == checkOutputHas(vstrOverrun));
+} /* checkBudgetOverrun() */
+
+
+#if (1 == uSHELL_IMPLEMENTS_BENCH)
+/*----------------------------------------------------------------------------*/
+static bool checkBenchBudget(void)
+{
+    /* '#b' runs the command under its budget as well: the first run spending it ends the benchmark */
+    Microshell *pShell = new Microshell(pluginEntry(), &g_sIo, "check");
+
+    g_u32FakeMs = 0U;
+    uShellSetClock(checkFakeClock);
+    pShell->Feed("#a\n", 3);
+    g_sMem.ClearOutput();
+    pShell->Feed("#b 100 vbusy\n", 13);
+    uShellSetClock(nullptr);
+    delete pShell;
+
+    return (true == checkOutputHas("stopped after run 1\n")) && (true == checkOutputHas("vbusy: 1 runs in"));
+} /* checkBenchBudget() */
+#endif /*(1 == uSHELL_IMPLEMENTS_BENCH)*/
+#endif /*(1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT)*/
+
+
+#if ((1 == uSHELL_IMPLEMENTS_COROUTINES) && (1 == uSHELL_IMPLEMENTS_HEAP_STATS))
+/*----------------------------------------------------------------------------*/
+static bool checkCoroutineHeap(void)
+{
+    /* the frame of the ilist coroutine is allocated and released at the commands site of '#M' */
+    Microshell *pShell = new Microshell(pluginEntry(), &g_sIo, "check");
+    heapStats_s sBefore, sAfter;
+
+    pShell->Feed("#a\n", 3);
+    uShellHeapGet(uSHELL_HEAP_COMMANDS, &sBefore);
+    pShell->Feed("ilist 3\n", 8);
+    for(int i = 0; i < 8; ++i) {
+        pShell->Poll();         /* one chunk per pass */
+    }
+    uShellHeapGet(uSHELL_HEAP_COMMANDS, &sAfter);
+    delete pShell;
+
+    return (sAfter.u32Allocs == (sBefore.u32Allocs + 1U)) && (sAfter.u32Frees == (sBefore.u32Frees + 1U)) &&
+           (sAfter.szCurrent == sBefore.szCurrent) && (sAfter.szPeak > 0U);
+} /* checkCoroutineHeap() */
+#endif /*((1 == uSHELL_IMPLEMENTS_COROUTINES) && (1 == uSHELL_IMPLEMENTS_HEAP_STATS))*/
+
+
+static const benchCheck_s g_vsChecks[] = {
+    { "check_command_output",   checkCommandOutput },
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+    { "check_autocomplete",     checkAutocomplete },
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)*/
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPL_ARGS)
+    { "check_args_autocomplete", checkArgsAutocomplete },
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPL_ARGS)*/
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPL_RANKING)
+    { "check_ranked_autocomplete", checkRankedAutocomplete },
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPL_RANKING)*/
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_SUGGEST)
+    { "check_history_suggest",  checkHistorySuggest },
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY_SUGGEST)*/
+#if (1 == uSHELL_IMPLEMENTS_HISTORY)
+    { "check_split_escape",     checkSplitEscape },
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY)*/
+#if (1 == uSHELL_IMPLEMENTS_LOG_SINK)
+    { "check_log_redraw",       checkLogRedraw },
+#endif /*(1 == uSHELL_IMPLEMENTS_LOG_SINK)*/
+#if (1 == uSHELL_IMPLEMENTS_JOBS)
+    { "check_jobs",             checkJobs },
+#endif /*(1 == uSHELL_IMPLEMENTS_JOBS)*/
+#if ((1 == uSHELL_IMPLEMENTS_TRACE) && defined(uSHELL_BENCH_TRACE2JSON))
+    { "check_trace_json",       checkTraceJson },
+#endif /*((1 == uSHELL_IMPLEMENTS_TRACE) && defined(uSHELL_BENCH_TRACE2JSON))*/
+#if (1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS)
+    { "check_post_thread",      checkPostThread },
+#endif /*(1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS)*/
+#if (1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT)
+    { "check_budget_overrun",   checkBudgetOverrun },
+#if (1 == uSHELL_IMPLEMENTS_BENCH)
+    { "check_bench_budget",     checkBenchBudget },
+#endif /*(1 == uSHELL_IMPLEMENTS_BENCH)*/
+#endif /*(1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT)*/
+#if ((1 == uSHELL_IMPLEMENTS_COROUTINES) && (1 == uSHELL_IMPLEMENTS_HEAP_STATS))
+    { "check_coroutine_heap",   checkCoroutineHeap },
+#endif /*((1 == uSHELL_IMPLEMENTS_COROUTINES) && (1 == uSHELL_IMPLEMENTS_HEAP_STATS))*/
+    { nullptr,                  nullptr }
+};
+
+
+/*----------------------------------------------------------------------------*/
+int benchChecks(const char *pstrFilter)
+{
+    int iFailed = 0;
+
+    for(const benchCheck_s *psCheck = g_vsChecks; nullptr != psCheck->pstrName; ++psCheck) {
+        if(nullptr != strstr(psCheck->pstrName, pstrFilter)) {
+            const bool bOk = psCheck->pfRun();
+            printf("{\"check\":\"%s\",\"ok\":%s}\n", psCheck->pstrName, bOk ? "true" : "false");
+            fflush(stdout);
+            iFailed += (true == bOk) ? 0 : 1;
+        }
+    }
+    return iFailed;
+} /* benchChecks() */
@@ -0,0 +1,7 @@
+#ifndef USHELL_BENCH_CHECKS_H
+#define USHELL_BENCH_CHECKS_H
+
+/** \brief runs the functional checks matching the filter, one JSON object per check; returns the number of failures */
+int benchChecks( const char *pstrFilter );
+
+#endif /* USHELL_BENCH_CHECKS_H */
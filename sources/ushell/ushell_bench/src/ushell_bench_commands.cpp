@@ -0,0 +1,159 @@
+#include "ushell_core_settings.h"
+#include "ushell_core_datatypes.h"
+#include "ushell_core_autocompl.h"
+#include "ushell_bench_commands.h"
+
+#include <utility>
+
+/*
+    The commands table is generated by the compiler: the names are spread
+    over a few groups (like the drivers of a real firmware) and numbered
+    inside each group, so the table comes out sorted and the autocomplete
+    trie has both wide (digits) and deep (group names) branches.
+*/
+
+static_assert((uSHELL_BENCH_NR_COMMANDS > 0) && (uSHELL_BENCH_NR_COMMANDS < 0xFFFF), "commands table size out of range");
+
+static constexpr const char *g_vstrGroups[]   = { "adc", "gpio", "i2c", "led", "pwm", "spi", "uart", "wifi" };
+static constexpr const char *g_vstrPatterns[] = uSHELL_BENCH_PATTERNS;
+static constexpr int g_iPerGroup = (uSHELL_BENCH_NR_COMMANDS + uSHELL_NR_ELEMS(g_vstrGroups) - 1) / uSHELL_NR_ELEMS(g_vstrGroups);
+
+static_assert(g_iPerGroup <= 10000, "four digits per group");
+static_assert(uSHELL_NR_ELEMS(g_vstrPatterns) == uSHELL_BENCH_NR_PATTERNS, "patterns table and count differ");
+
+/** \brief storage of the generated names */
+typedef struct {
+    char vstrNames[uSHELL_BENCH_NR_COMMANDS][12];
+} benchNames_s;
+
+
+/*----------------------------------------------------------------------------*/
+static constexpr benchNames_s benchMakeNames(void)
+{
+    benchNames_s sNames{};
+
+    for(int i = 0; i < uSHELL_BENCH_NR_COMMANDS; ++i) {
+        const char *pstrGroup = g_vstrGroups[i / g_iPerGroup];
+        int iNumber = i % g_iPerGroup;
+        int iPos = 0;
+        while('\0' != pstrGroup[iPos]) {
+            sNames.vstrNames[i][iPos] = pstrGroup[iPos];
+            ++iPos;
+        }
+        for(int iDigit = 3; iDigit >= 0; --iDigit) {
+            sNames.vstrNames[i][iPos + iDigit] = (char)('0' + (iNumber % 10));
+            iNumber /= 10;
+        }
+    }
+    return sNames;
+} /* benchMakeNames() */
+
+static constexpr benchNames_s g_sNames = benchMakeNames();
+
+/** \brief the table is expanded from an index sequence, fctDef_s is not assignable */
+template<typename T>
+struct benchTable_t;
+
+template<int... I>
+struct benchTable_t<std::integer_sequence<int, I...>> {
+    static constexpr fctDef_s vsFuncDefArray[] = { { g_sNames.vstrNames[I], g_vstrPatterns[I % uSHELL_BENCH_NR_PATTERNS] }... };
+};
+
+static constexpr const fctDef_s (&g_vsFuncDefArray)[uSHELL_BENCH_NR_COMMANDS] = benchTable_t<std::make_integer_sequence<int, uSHELL_BENCH_NR_COMMANDS>>::vsFuncDefArray;
+
+/* autocomplete index (prefix trie generated at compile time) */
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+static constexpr auto g_sAutocomplTrie = uSHELL_AUTOCOMPL_TRIE(g_vsFuncDefArray);
+static const autocomplIndex_s g_sAutocomplIndex = uSHELL_AUTOCOMPL_INDEX(g_sAutocomplTrie, g_vsFuncDefArray);
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)*/
+
+#if (1 == uSHELL_IMPLEMENTS_COMMAND_HELP)
+/* help: every command shares the same text */
+template<typename T>
+struct benchInfo_t;
+
+template<int... I>
+struct benchInfo_t<std::integer_sequence<int, I...>> {
+    static constexpr const char *vstrInfoArray[] = { ((void)I, "synthetic command")... };
+};
+#endif /*(1 == uSHELL_IMPLEMENTS_COMMAND_HELP)*/
+
+static const shortcut_s g_vsShortcutsArray[] = { { ' ', nullptr } };
+#if ((1 == uSHELL_IMPLEMENTS_COMMAND_HELP) && (1 == uSHELL_IMPLEMENTS_USER_SHORTCUTS))
+static const char* const g_vstrShortcutsInfoArray[] = { "" };
+#endif /*((1 == uSHELL_IMPLEMENTS_COMMAND_HELP) && (1 == uSHELL_IMPLEMENTS_USER_SHORTCUTS))*/
+
+
+/*----------------------------------------------------------------------------*/
+static int benchExecuteCommand(const command_s *psCmd)
+{
+    /* the arguments are already converted by the parser, nothing else is measured */
+    return psCmd->iFctIndex;
+} /* benchExecuteCommand() */
+
+
+#if (1 == uSHELL_IMPLEMENTS_COROUTINES)
+/*----------------------------------------------------------------------------*/
+static int benchSpawnCommand(const command_s *psCmd, uShellTask *psTask)
+{
+    (void)psCmd;
+    (void)psTask;
+    return uSHELL_ERR_ITEM_NOT_FOUND;
+} /* benchSpawnCommand() */
+#endif /*(1 == uSHELL_IMPLEMENTS_COROUTINES)*/
+
+
+#if (1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT)
+/*----------------------------------------------------------------------------*/
+static uint32_t benchCommandBudget(const int iFctIndex)
+{
+    (void)iFctIndex;
+    return 0U;
+} /* benchCommandBudget() */
+#endif /*(1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT)*/
+
+
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPL_ARGS)
+/*----------------------------------------------------------------------------*/
+static const autocomplIndex_s *benchCompleteArgument(const int iFctIndex, const int iArgIndex)
+{
+    (void)iFctIndex;
+    (void)iArgIndex;
+    return nullptr;
+} /* benchCompleteArgument() */
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPL_ARGS)*/
+
+
+/* bench instance structure */
+static const uShellInst_s sBenchInstance = {
+    .psFuncDefArray                                         = g_vsFuncDefArray,
+    .psShortcutsArray                                       = g_vsShortcutsArray,
+#if (1 == uSHELL_IMPLEMENTS_COMMAND_HELP)
+    .ppstrInfoArray                                         = benchInfo_t<std::make_integer_sequence<int, uSHELL_BENCH_NR_COMMANDS>>::vstrInfoArray,
+#if (1 == uSHELL_IMPLEMENTS_USER_SHORTCUTS)
+    .ppstrShortcutsInfoArray                                = g_vstrShortcutsInfoArray,
+#endif /*(1 == uSHELL_IMPLEMENTS_USER_SHORTCUTS)*/
+#endif /* (1 == uSHELL_IMPLEMENTS_COMMAND_HELP) */
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+    .psAutocomplIndex                                       = &g_sAutocomplIndex,
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPL_ARGS)
+    .pfComplete                                             = benchCompleteArgument,
+#endif /* (1 == uSHELL_IMPLEMENTS_AUTOCOMPL_ARGS) */
+#endif /* (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE) */
+    .iNrFunctions                                           = uSHELL_BENCH_NR_COMMANDS,
+    .iNrShortcuts                                           = uSHELL_NR_ELEMS(g_vsShortcutsArray),
+    .pfExec                                                 = benchExecuteCommand,
+#if (1 == uSHELL_IMPLEMENTS_COROUTINES)
+    .pfSpawn                                                = benchSpawnCommand,
+#endif /*(1 == uSHELL_IMPLEMENTS_COROUTINES)*/
+#if (1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT)
+    .pfBudget                                               = benchCommandBudget,
+#endif /*(1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT)*/
+};
+
+
+/*----------------------------------------------------------------------------*/
+const uShellInst_s *benchEntry(void)
+{
+    return &sBenchInstance;
+} /* benchEntry() */
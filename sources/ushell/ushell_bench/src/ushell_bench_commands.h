@@ -0,0 +1,17 @@
+#ifndef USHELL_BENCH_COMMANDS_H
+#define USHELL_BENCH_COMMANDS_H
+
+#include "ushell_core_datatypes.h"
+
+#if !defined(uSHELL_BENCH_NR_COMMANDS)
+    #define uSHELL_BENCH_NR_COMMANDS    (256)
+#endif /*!defined(uSHELL_BENCH_NR_COMMANDS)*/
+
+/* the parameters pattern of the command i is uSHELL_BENCH_PATTERNS[i % uSHELL_BENCH_NR_PATTERNS] */
+#define uSHELL_BENCH_NR_PATTERNS        (4)
+#define uSHELL_BENCH_PATTERNS           { "v", "i", "is", "lis" }
+
+/** \brief synthetic instance: uSHELL_BENCH_NR_COMMANDS commands named <group><nnnn>, sorted by name */
+const uShellInst_s *benchEntry( void );
+
+#endif /* USHELL_BENCH_COMMANDS_H */
@@ -0,0 +1,440 @@
+#include "ushell_core.h"
+#include "ushell_core_transport.h"
+#include "ushell_core_keys.h"
+#include "ushell_core_printout.h"
+#include "ushell_core_utils.h"
+#include "ushell_bench_commands.h"
+#include "ushell_bench_checks.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+/*
+    Microbenchmarks of the shell core on the host. Every case runs
+    uSHELL_BENCH_ROUNDS rounds of N operations and prints one JSON object per
+    line (min and median of the per round ns/op), so the results can be
+    diffed or loaded by any tool:
+
+        ushell_bench [iterations] [name filter]
+
+    The stateless cases are timed as a batch. The cases driving the editor
+    through Feed() time every operation alone, so the keys restoring the
+    line between two operations are not counted.
+
+    The functional checks of ushell_bench_checks.cpp run first, the exit
+    code is 1 when one of them failed.
+*/
+
+#define uSHELL_BENCH_ROUNDS         (7)
+#define uSHELL_BENCH_ITERATIONS     (20000)
+
+/** \brief one benchmark, pfUndo == nullptr: the operations are timed as a batch */
+typedef struct {
+    const char *pstrName;
+    void (*pfSetup)(void);
+    void (*pfOp)(const int iIter);
+    void (*pfUndo)(const int iIter);
+} benchCase_s;
+
+static Microshell *g_pShell = nullptr;
+static uShellMemTransport g_sMem;           /* no output buffer: the output of the shell is only counted */
+static volatile int g_iSink = 0;            /* keeps the results of the pure functions alive */
+
+static const char *g_pstrVoidFirst = nullptr;
+static const char *g_pstrVoidLast  = nullptr;
+static char g_vstrArgsLine[uSHELL_MAX_INPUT_BUF_LEN];
+static char g_vstrKeys[16];
+static const char *g_pstrLine = nullptr;
+static char g_vstrPollLine[uSHELL_MAX_INPUT_BUF_LEN + 1];
+static const char g_vstrBackspace[] = { uSHELL_KEY_BACKSPACE, '\0' };
+
+
+/*----------------------------------------------------------------------------*/
+static inline uint64_t benchNowNs(void)
+{
+    struct timespec sNow;
+    clock_gettime(CLOCK_MONOTONIC, &sNow);
+    return ((uint64_t)sNow.tv_sec * 1000000000ULL) + (uint64_t)sNow.tv_nsec;
+} /* benchNowNs() */
+
+
+/*----------------------------------------------------------------------------*/
+static inline void benchFeed(const char *pstrKeys)
+{
+    g_pShell->Feed(pstrKeys, strlen(pstrKeys));
+} /* benchFeed() */
+
+
+/*==============================================================================
+                            CASES
+==============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+static void benchAsc2intDec(const int iIter)
+{
+    BIGNUM_T numVal = 0;
+    (void)iIter;
+    g_iSink = (int)asc2int("123456789", &numVal) + (int)numVal;
+} /* benchAsc2intDec() */
+
+
+/*----------------------------------------------------------------------------*/
+static void benchAsc2intHex(const int iIter)
+{
+    BIGNUM_T numVal = 0;
+    (void)iIter;
+    g_iSink = (int)asc2int("0xDEADBEEF", &numVal) + (int)numVal;
+} /* benchAsc2intHex() */
+
+
+#if (1 == uSHELL_IMPLEMENTS_HEXLIFY)
+static uint8_t g_vu8Bytes[64];
+static char    g_vstrHex[(2 * sizeof(g_vu8Bytes)) + 1];
+
+/*----------------------------------------------------------------------------*/
+static void benchHexlify(const int iIter)
+{
+    g_vu8Bytes[0] = (uint8_t)iIter;
+    hexlify(g_vu8Bytes, sizeof(g_vu8Bytes), g_vstrHex);
+    g_iSink = g_vstrHex[1];
+} /* benchHexlify() */
+
+
+/*----------------------------------------------------------------------------*/
+static void benchUnhexlify(const int iIter)
+{
+    size_t szLen = 0;
+    (void)iIter;
+    g_iSink = (int)unhexlify(g_vstrHex, g_vu8Bytes, &szLen) + (int)szLen;
+} /* benchUnhexlify() */
+#endif /*(1 == uSHELL_IMPLEMENTS_HEXLIFY)*/
+
+
+#if (1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS)
+static parsedCmd_s g_sParsed;
+
+/*----------------------------------------------------------------------------*/
+static void benchParseVoidFirst(const int iIter)
+{
+    (void)iIter;
+    g_iSink = g_pShell->Parse(g_pstrVoidFirst, &g_sParsed);
+} /* benchParseVoidFirst() */
+
+
+/*----------------------------------------------------------------------------*/
+static void benchParseVoidLast(const int iIter)
+{
+    (void)iIter;
+    g_iSink = g_pShell->Parse(g_pstrVoidLast, &g_sParsed);
+} /* benchParseVoidLast() */
+
+
+/*----------------------------------------------------------------------------*/
+static void benchParseMiss(const int iIter)
+{
+    (void)iIter;
+    g_iSink = g_pShell->Parse("zzz", &g_sParsed);
+} /* benchParseMiss() */
+
+
+/*----------------------------------------------------------------------------*/
+static void benchParseArgs(const int iIter)
+{
+    (void)iIter;
+    g_iSink = g_pShell->Parse(g_vstrArgsLine, &g_sParsed);
+} /* benchParseArgs() */
+#endif /*(1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS)*/
+
+
+/*----------------------------------------------------------------------------*/
+static void benchClearLine(void)
+{
+    for(int i = 0; i < (int)uSHELL_MAX_INPUT_BUF_LEN; ++i) {
+        benchFeed(g_vstrBackspace);
+    }
+} /* benchClearLine() */
+
+
+/*----------------------------------------------------------------------------*/
+static void benchKeysSetup(void)
+{
+    /* the keys go through the autocomplete */
+    benchClearLine();
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+    benchFeed("#A\n");
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)*/
+} /* benchKeysSetup() */
+
+
+/*----------------------------------------------------------------------------*/
+static void benchKey(const int iIter)
+{
+    /* one key of the keys selecting a command, the line is cleared after the last one */
+    const char vstrKey[2] = { g_vstrKeys[iIter % (int)strlen(g_vstrKeys)], '\0' };
+    benchFeed(vstrKey);
+} /* benchKey() */
+
+
+/*----------------------------------------------------------------------------*/
+static void benchKeyUndo(const int iIter)
+{
+    const int iLen = (int)strlen(g_vstrKeys);
+    if((iLen - 1) == (iIter % iLen)) {
+        for(int i = 0; i < 16; ++i) {
+            benchFeed(g_vstrBackspace);
+        }
+    }
+} /* benchKeyUndo() */
+
+
+/*----------------------------------------------------------------------------*/
+static void benchCycleSetup(void)
+{
+    const char vstrKey[2] = { g_vstrKeys[0], '\0' };
+    benchKeysSetup();
+    benchFeed(vstrKey);
+} /* benchCycleSetup() */
+
+
+/*----------------------------------------------------------------------------*/
+static void benchCycle(const int iIter)
+{
+    benchFeed((0 == (iIter & 1)) ? "\033[C" : "\033[D");
+} /* benchCycle() */
+
+
+/*----------------------------------------------------------------------------*/
+static void benchLinesSetup(void)
+{
+    /* whole lines are typed, the autocomplete would expand their first key */
+    benchClearLine();
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+    benchFeed("#a\n");
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)*/
+} /* benchLinesSetup() */
+
+
+/*----------------------------------------------------------------------------*/
+static void benchEnterVoidSetup(void)
+{
+    benchLinesSetup();
+    g_pstrLine = g_pstrVoidFirst;
+    benchFeed(g_pstrLine);
+} /* benchEnterVoidSetup() */
+
+
+/*----------------------------------------------------------------------------*/
+static void benchPollVoidSetup(void)
+{
+    benchLinesSetup();
+    snprintf(g_vstrPollLine, sizeof(g_vstrPollLine), "%s\n", g_pstrVoidFirst);
+} /* benchPollVoidSetup() */
+
+
+/*----------------------------------------------------------------------------*/
+static void benchPollVoid(const int iIter)
+{
+    /* a whole line arrives at once, read by Poll() from the in-memory transport like a chunk of the UART */
+    (void)iIter;
+    g_sMem.SetInput(g_vstrPollLine, strlen(g_vstrPollLine));
+    g_pShell->Poll();
+} /* benchPollVoid() */
+
+
+/*----------------------------------------------------------------------------*/
+static void benchRamUsageSetup(void)
+{
+    benchLinesSetup();
+    g_pstrLine = "#m";
+    benchFeed(g_pstrLine);
+} /* benchRamUsageSetup() */
+
+
+/*----------------------------------------------------------------------------*/
+static void benchEnter(const int iIter)
+{
+    /* the line typed before: parse, execution, printout, history write and prompt */
+    (void)iIter;
+    benchFeed("\n");
+} /* benchEnter() */
+
+
+/*----------------------------------------------------------------------------*/
+static void benchEnterUndo(const int iIter)
+{
+    (void)iIter;
+    benchFeed(g_pstrLine);
+} /* benchEnterUndo() */
+
+
+#if (1 == uSHELL_IMPLEMENTS_HISTORY)
+/*----------------------------------------------------------------------------*/
+static void benchHistoryFill(void)
+{
+    /* distinct entries, more than the history depth */
+    benchLinesSetup();
+    for(int i = 0; i < uSHELL_BENCH_NR_COMMANDS; i += uSHELL_BENCH_NR_PATTERNS) {
+        benchFeed(benchEntry()->psFuncDefArray[i].pstrFctName);
+        benchFeed("\n");
+    }
+} /* benchHistoryFill() */
+
+
+/*----------------------------------------------------------------------------*/
+static void benchHistoryRead(const int iIter)
+{
+    benchFeed((0 == (iIter & 1)) ? "\033[A" : "\033[B");
+} /* benchHistoryRead() */
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY)*/
+
+
+/*----------------------------------------------------------------------------*/
+static void benchSnprintf(const int iIter)
+{
+    char vstrOut[32];
+    g_iSink = uSHELL_SNPRINTF(vstrOut, sizeof(vstrOut), "\r=> %d (0x%X)\n", iIter, iIter);
+} /* benchSnprintf() */
+
+
+#if (1 == uSHELL_IMPLEMENTS_LOG_SINK)
+/*----------------------------------------------------------------------------*/
+static void benchLog(const int iIter)
+{
+    /* formatted by the caller, printed above the line by the shell loop */
+    uShellLogPrintf("sensor %d: %d mV", iIter & 7, iIter);
+    g_pShell->Poll();
+} /* benchLog() */
+#endif /*(1 == uSHELL_IMPLEMENTS_LOG_SINK)*/
+
+
+static const benchCase_s g_vsCases[] = {
+    { "asc2int_dec",        nullptr,                benchAsc2intDec,        nullptr         },
+    { "asc2int_hex",        nullptr,                benchAsc2intHex,        nullptr         },
+#if (1 == uSHELL_IMPLEMENTS_HEXLIFY)
+    { "hexlify_64",         nullptr,                benchHexlify,           nullptr         },
+    { "unhexlify_64",       nullptr,                benchUnhexlify,         nullptr         },
+#endif /*(1 == uSHELL_IMPLEMENTS_HEXLIFY)*/
+#if (1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS)
+    { "parse_lookup_first", nullptr,                benchParseVoidFirst,    nullptr         },
+    { "parse_lookup_last",  nullptr,                benchParseVoidLast,     nullptr         },
+    { "parse_lookup_miss",  nullptr,                benchParseMiss,         nullptr         },
+    { "parse_args",         nullptr,                benchParseArgs,         nullptr         },
+#endif /*(1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS)*/
+    { "printf_snprintf",    nullptr,                benchSnprintf,          nullptr         },
+    { "key_autocomplete",   benchKeysSetup,         benchKey,               benchKeyUndo    },
+    { "key_cycle",          benchCycleSetup,        benchCycle,             nullptr         },
+    { "enter_void",         benchEnterVoidSetup,    benchEnter,             benchEnterUndo  },
+    { "poll_line_void",     benchPollVoidSetup,     benchPollVoid,          nullptr         },
+    { "printf_ramusage",    benchRamUsageSetup,     benchEnter,             benchEnterUndo  },
+#if (1 == uSHELL_IMPLEMENTS_LOG_SINK)
+    { "printf_log_sink",    benchLinesSetup,        benchLog,               nullptr         },
+#endif /*(1 == uSHELL_IMPLEMENTS_LOG_SINK)*/
+#if (1 == uSHELL_IMPLEMENTS_HISTORY)
+    /* the history is full from here on: the keys also search the suggestion */
+    { "history_read",       benchHistoryFill,       benchHistoryRead,       nullptr         },
+    { "key_history_search", benchKeysSetup,         benchKey,               benchKeyUndo    },
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY)*/
+};
+
+
+/*==============================================================================
+                            RUNNER
+==============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+static int benchCompare(const void *pvA, const void *pvB)
+{
+    const double dA = *(const double*)pvA;
+    const double dB = *(const double*)pvB;
+
+    return (dA > dB) - (dA < dB);
+} /* benchCompare() */
+
+
+/*----------------------------------------------------------------------------*/
+static void benchRun(const benchCase_s *psCase, const int iIterations)
+{
+    double vdNsPerOp[uSHELL_BENCH_ROUNDS];
+    const size_t szOutStart = g_sMem.OutputTotal();
+
+    if(nullptr != psCase->pfSetup) {
+        psCase->pfSetup();
+    }
+    for(int iRound = 0; iRound < uSHELL_BENCH_ROUNDS; ++iRound) {
+        uint64_t u64Ns = 0;
+        if(nullptr == psCase->pfUndo) {
+            const uint64_t u64Start = benchNowNs();
+            for(int i = 0; i < iIterations; ++i) {
+                psCase->pfOp(i);
+            }
+            u64Ns = benchNowNs() - u64Start;
+        } else {
+            for(int i = 0; i < iIterations; ++i) {
+                const uint64_t u64Start = benchNowNs();
+                psCase->pfOp(i);
+                u64Ns += benchNowNs() - u64Start;
+                psCase->pfUndo(i);
+            }
+        }
+        vdNsPerOp[iRound] = (double)u64Ns / (double)iIterations;
+    }
+    qsort(vdNsPerOp, uSHELL_BENCH_ROUNDS, sizeof(double), benchCompare);
+    printf("{\"bench\":\"%s\",\"commands\":%d,\"iterations\":%d,\"rounds\":%d,\"min_ns\":%.1f,\"median_ns\":%.1f,\"out_bytes_per_op\":%.1f}\n",
+           psCase->pstrName, uSHELL_BENCH_NR_COMMANDS, iIterations, uSHELL_BENCH_ROUNDS,
+           vdNsPerOp[0], vdNsPerOp[uSHELL_BENCH_ROUNDS / 2],
+           (double)(g_sMem.OutputTotal() - szOutStart) / ((double)iIterations * uSHELL_BENCH_ROUNDS));
+    fflush(stdout);
+} /* benchRun() */
+
+
+/*----------------------------------------------------------------------------*/
+int main(int argc, char *argv[])
+{
+    const int iIterations = (argc > 1) ? atoi(argv[1]) : uSHELL_BENCH_ITERATIONS;
+    const char *pstrFilter = (argc > 2) ? argv[2] : "";
+    static const uShellIo_s sIo = uShellTransport<uShellMemTransport>::Io(&g_sMem);
+    const uShellInst_s *psInst = benchEntry();
+
+    if(iIterations <= 0) {
+        fprintf(stderr, "usage: %s [iterations] [name filter]\n", argv[0]);
+        return 1;
+    }
+
+    /* the first and the last void commands, a command with every kind of argument */
+    for(int i = 0; i < psInst->iNrFunctions; ++i) {
+        const char *pstrPattern = psInst->psFuncDefArray[i].pstrFuncParamDef;
+        if(0 == strcmp(pstrPattern, "v")) {
+            g_pstrVoidFirst = (nullptr == g_pstrVoidFirst) ? psInst->psFuncDefArray[i].pstrFctName : g_pstrVoidFirst;
+            g_pstrVoidLast  = psInst->psFuncDefArray[i].pstrFctName;
+        } else if(('\0' == g_vstrArgsLine[0]) && (0 == strcmp(pstrPattern, "lis"))) {
+            snprintf(g_vstrArgsLine, sizeof(g_vstrArgsLine), "%s 0x123456789A 42 \"a spaced string\"", psInst->psFuncDefArray[i].pstrFctName);
+        }
+    }
+    /* the keys selecting the middle command: the autocomplete expands the first one up to the common prefix */
+    const char *pstrTarget = psInst->psFuncDefArray[psInst->iNrFunctions / 2].pstrFctName;
+    int iCommon = (int)strlen(pstrTarget);
+    for(int i = 0; i < psInst->iNrFunctions; ++i) {
+        const char *pstrName = psInst->psFuncDefArray[i].pstrFctName;
+        int iLen = 0;
+        if(pstrName[0] == pstrTarget[0]) {
+            while((pstrName[iLen] == pstrTarget[iLen]) && ('\0' != pstrName[iLen])) {
+                ++iLen;
+            }
+            iCommon = (iLen < iCommon) ? iLen : iCommon;
+        }
+    }
+    snprintf(g_vstrKeys, sizeof(g_vstrKeys), "%c%s", pstrTarget[0], pstrTarget + ((0 == iCommon) ? 1 : iCommon));
+
+    const int iFailed = benchChecks(pstrFilter);
+
+    g_pShell = new Microshell(psInst, &sIo, "bench");
+    for(int i = 0; i < uSHELL_NR_ELEMS(g_vsCases); ++i) {
+        if(nullptr != strstr(g_vsCases[i].pstrName, pstrFilter)) {
+            benchRun(&g_vsCases[i], iIterations);
+        }
+    }
+    delete g_pShell;
+    return (0 == iFailed) ? 0 : 1;
+} /* main() */
@@ -0,0 +1,237 @@
+#include "ushell_core_settings.h"
+#include "ushell_core_datatypes.h"
+#include "ushell_core_utils.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+
+/*
+    Converts the event trace dumped by the shortcut #x into the Chrome trace
+    JSON format (chrome://tracing, https://ui.perfetto.dev). The dump is a
+    binary frame inside the console output, so any capture of the serial port
+    works, the text around it is skipped and the last frame is used:
+
+        ushell_trace2json capture.bin > trace.json
+
+    A key is a slice from the byte received to the end of its output, the
+    parsing, the command and the history write are nested slices.
+*/
+
+/** \brief little endian reader over the frame */
+typedef struct {
+    const uint8_t *pu8Data;
+    size_t szSize;
+    size_t szPos;
+} traceReader_s;
+
+
+/*----------------------------------------------------------------------------*/
+static bool traceRead(traceReader_s *psReader, const int iNrBytes, uint32_t *pu32Value)
+{
+    if((psReader->szPos + (size_t)iNrBytes) > psReader->szSize) {
+        return false;
+    }
+    *pu32Value = 0U;
+    for(int i = 0; i < iNrBytes; ++i) {
+        *pu32Value |= (uint32_t)psReader->pu8Data[psReader->szPos++] << (8 * i);
+    }
+    return true;
+} /* traceRead() */
+
+
+/*----------------------------------------------------------------------------*/
+static uint8_t *traceLoad(const char *pstrPath, size_t *pszSize)
+{
+    FILE *pFile = (0 == strcmp(pstrPath, "-")) ? stdin : fopen(pstrPath, "rb");
+    uint8_t *pu8Data = nullptr;
+    size_t szCapacity = 0;
+
+    *pszSize = 0;
+    if(nullptr == pFile) {
+        return nullptr;
+    }
+    for(;;) {
+        if(*pszSize == szCapacity) {
+            szCapacity = (0 == szCapacity) ? 65536 : (szCapacity * 2);
+            uint8_t *pu8Grown = (uint8_t*)realloc(pu8Data, szCapacity);
+            if(nullptr == pu8Grown) {
+                free(pu8Data);
+                pu8Data = nullptr;
+                break;
+            }
+            pu8Data = pu8Grown;
+        }
+        const size_t szRead = fread(pu8Data + *pszSize, 1, szCapacity - *pszSize, pFile);
+        if(0 == szRead) {
+            break;
+        }
+        *pszSize += szRead;
+    }
+    if(stdin != pFile) {
+        fclose(pFile);
+    }
+    return pu8Data;
+} /* traceLoad() */
+
+
+#if (1 == uSHELL_IMPLEMENTS_TRACE)
+/*----------------------------------------------------------------------------*/
+static void tracePrintName(const char *pstrName)
+{
+    for(; '\0' != *pstrName; ++pstrName) {
+        if(('"' == *pstrName) || ('\\' == *pstrName)) {
+            printf("\\%c", *pstrName);
+        } else if((unsigned char)*pstrName < 0x20) {
+            printf("\\u%04x", (unsigned int)(unsigned char)*pstrName);
+        } else {
+            putchar(*pstrName);
+        }
+    }
+} /* tracePrintName() */
+
+
+/*----------------------------------------------------------------------------*/
+static int traceConvert(const uint8_t *pu8Data, const size_t szSize)
+{
+    /* the last frame of the capture */
+    const size_t szMagic = strlen(uSHELL_TRACE_MAGIC);
+    size_t szFrame = szSize;
+    for(size_t i = 0; (i + szMagic) <= szSize; ++i) {
+        if(0 == memcmp(pu8Data + i, uSHELL_TRACE_MAGIC, szMagic)) {
+            szFrame = i;
+        }
+    }
+    if(szFrame == szSize) {
+        fprintf(stderr, "no trace frame found\n");
+        return 1;
+    }
+
+    traceReader_s sReader = { pu8Data, szSize, szFrame + szMagic };
+    uint32_t u32Version = 0U, u32RecSize = 0U, u32NrRecords = 0U, u32TicksPerUs = 0U, u32NrNames = 0U;
+    if(!traceRead(&sReader, 1, &u32Version) || !traceRead(&sReader, 1, &u32RecSize) ||
+       !traceRead(&sReader, 2, &u32NrRecords) || !traceRead(&sReader, 4, &u32TicksPerUs) ||
+       (uSHELL_TRACE_VERSION != u32Version) || (sizeof(traceRec_s) != u32RecSize) || (0U == u32TicksPerUs)) {
+        fprintf(stderr, "unsupported trace frame (version %u, record %u bytes)\n", (unsigned int)u32Version, (unsigned int)u32RecSize);
+        return 1;
+    }
+    const size_t szRecords = sReader.szPos;
+    sReader.szPos += (size_t)u32NrRecords * u32RecSize;
+    if(!traceRead(&sReader, 2, &u32NrNames)) {
+        fprintf(stderr, "truncated trace frame\n");
+        return 1;
+    }
+    const char **ppstrNames = (const char**)calloc((0U == u32NrNames) ? 1U : u32NrNames, sizeof(char*));
+    if(nullptr == ppstrNames) {
+        return 1;
+    }
+    for(uint32_t i = 0; i < u32NrNames; ++i) {
+        ppstrNames[i] = (const char*)(pu8Data + sReader.szPos);
+        while((sReader.szPos < szSize) && ('\0' != pu8Data[sReader.szPos])) {
+            ++sReader.szPos;
+        }
+        if(sReader.szPos++ >= szSize) {
+            fprintf(stderr, "truncated trace frame\n");
+            free(ppstrNames);
+            return 1;
+        }
+    }
+
+    /* the ring may start inside a slice: the ends without a begin are dropped */
+    static const char *vstrSlices[] = { "parse", "history" };
+    uint64_t u64Ticks = 0U;
+    uint32_t u32Last = 0U;
+    int iDepth = 0;
+    bool bFirst = true;
+    sReader.szPos = szRecords;
+    printf("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    for(uint32_t i = 0; i < u32NrRecords; ++i) {
+        uint32_t u32Ticks = 0U, u32Arg = 0U, u32Event = 0U, u32Reserved = 0U;
+        traceRead(&sReader, 4, &u32Ticks);
+        traceRead(&sReader, 2, &u32Arg);
+        traceRead(&sReader, 1, &u32Event);
+        traceRead(&sReader, 1, &u32Reserved);
+        u64Ticks += (0U == i) ? 0U : (uint32_t)(u32Ticks - u32Last);   /* the ticks wrap */
+        u32Last = u32Ticks;
+
+        const bool bBegin = (uSHELL_TRACE_KEY == u32Event) || (uSHELL_TRACE_PARSE_BEGIN == u32Event) ||
+                            (uSHELL_TRACE_EXEC_BEGIN == u32Event) || (uSHELL_TRACE_HISTORY_BEGIN == u32Event);
+        if(u32Event >= uSHELL_TRACE_LAST) {
+            continue;
+        } else if(true == bBegin) {
+            ++iDepth;
+        } else if(iDepth > 0) {
+            --iDepth;
+        } else {
+            continue;
+        }
+        printf("%s{\"ph\":\"%c\",\"pid\":1,\"tid\":1,\"ts\":%.3f", (bFirst ? "" : ",\n"), (bBegin ? 'B' : 'E'), (double)u64Ticks / u32TicksPerUs);
+        bFirst = false;
+        switch(u32Event) {
+            case uSHELL_TRACE_KEY: {
+                    if(uSHELL_ISPRINT((char)u32Arg) && ('"' != (char)u32Arg) && ('\\' != (char)u32Arg)) {
+                        printf(",\"name\":\"key '%c'\"", (char)u32Arg);
+                    } else {
+                        printf(",\"name\":\"key 0x%02X\"", (unsigned int)u32Arg);
+                    }
+                }
+                break;
+            case uSHELL_TRACE_PARSE_BEGIN:
+            case uSHELL_TRACE_HISTORY_BEGIN: {
+                    printf(",\"name\":\"%s\"", vstrSlices[(uSHELL_TRACE_PARSE_BEGIN == u32Event) ? 0 : 1]);
+                }
+                break;
+            case uSHELL_TRACE_PARSE_END: {
+                    printf(",\"args\":{\"result\":%d}", (int)(int16_t)u32Arg);
+                }
+                break;
+            case uSHELL_TRACE_EXEC_BEGIN: {
+                    printf(",\"name\":\"");
+                    if(u32Arg < u32NrNames) {
+                        tracePrintName(ppstrNames[u32Arg]);
+                    } else {
+                        printf("command %u", (unsigned int)u32Arg);
+                    }
+                    printf("\",\"args\":{\"index\":%u}", (unsigned int)u32Arg);
+                }
+                break;
+            case uSHELL_TRACE_EXEC_END: {
+                    printf(",\"args\":{\"return\":%d}", (int)(int16_t)u32Arg);
+                }
+                break;
+            default:
+                break;
+        }
+        printf("}");
+    }
+    printf("\n]}\n");
+    free(ppstrNames);
+    return 0;
+} /* traceConvert() */
+#endif /*(1 == uSHELL_IMPLEMENTS_TRACE)*/
+
+
+/*----------------------------------------------------------------------------*/
+int main(int argc, char *argv[])
+{
+    size_t szSize = 0;
+    uint8_t *pu8Data = nullptr;
+    int iRetVal = 1;
+
+    if(argc != 2) {
+        fprintf(stderr, "usage: %s capture|- > trace.json\n", argv[0]);
+        return 1;
+    }
+    if(nullptr == (pu8Data = traceLoad(argv[1], &szSize))) {
+        fprintf(stderr, "cannot read %s\n", argv[1]);
+        return 1;
+    }
+#if (1 == uSHELL_IMPLEMENTS_TRACE)
+    iRetVal = traceConvert(pu8Data, szSize);
+#else
+    fprintf(stderr, "the trace is disabled in ushell_core_settings.h\n");
+#endif /*(1 == uSHELL_IMPLEMENTS_TRACE)*/
+    free(pu8Data);
+    return iRetVal;
+} /* main() */
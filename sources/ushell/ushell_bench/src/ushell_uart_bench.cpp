@@ -0,0 +1,476 @@
+#include "uart_access.h"
+#include "uart_sim.h"
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/*
+    Benchmarks and regression checks of the bare-metal UART driver on the
+    host, against the simulated registers of uart_sim.cpp (built with
+    UART_SIMULATION). The times are the ones of the virtual clock, so the
+    results are the same on every machine. One JSON object per line:
+
+        uart_sim_bench [name filter]
+
+    The exit code is 1 when the data on the line differs from what was sent
+    or when bytes are lost although the flow control should have held them
+    (a transfer ends when nothing arrived for uSHELL_UART_BENCH_IDLE_NS),
+    and when the divisor maths or the frame format parser (uart_baud.cpp)
+    give another result than the expected one, or when uart_vsnprintf()
+    (the printf of the shell on the target) formats the strings of the shell
+    otherwise than the C library.
+*/
+
+#define uSHELL_UART_BENCH_PORT      (1)
+#define uSHELL_UART_BENCH_BYTES     (8192)
+#define uSHELL_UART_BENCH_RX_BAUD   (921600U)
+#define uSHELL_UART_BENCH_CHUNK     (64)
+#define uSHELL_UART_BENCH_SLOW_NS   (16000U)    /* per byte, slower than the line at 921600 */
+#define uSHELL_UART_BENCH_BUSY_NS   (2000000U)  /* without reading, longer than a FIFO at 921600 */
+#define uSHELL_UART_BENCH_IDLE_NS   (5000000U)  /* no byte for that long: the transfer is over */
+#define uSHELL_UART_BENCH_APB_HZ    (80000000U) /* the clock of the divisor */
+
+/** \brief one case, returns false when the check failed */
+typedef struct {
+    const char *pstrName;
+    bool (*pfRun)(const char *pstrName);
+} uartBenchCase_s;
+
+static uart_inst_t g_sUart;
+static uint8_t g_vu8RxRing[256];
+static uint8_t g_vu8TxRing[512];
+static uint8_t g_vu8Sent[uSHELL_UART_BENCH_BYTES];
+static uint8_t g_vu8Got[uSHELL_UART_BENCH_BYTES];
+
+
+/*----------------------------------------------------------------------------*/
+static void uartBenchOpen(const uint32_t u32Baud, const int iFlow)
+{
+    const uart_inst_cfg_t sCfg = {
+        .port    = uSHELL_UART_BENCH_PORT,
+        .tx_pin  = 17,
+        .rx_pin  = 21,
+        .rts_pin = 18,
+        .cts_pin = 16,
+        .rx_ring = g_vu8RxRing,
+        .rx_size = sizeof(g_vu8RxRing),
+        .tx_ring = g_vu8TxRing,
+        .tx_size = sizeof(g_vu8TxRing),
+    };
+    uart_format_t sFormat = UART_FORMAT_8N1;
+
+    uart_sim_reset();
+    uart_inst_open(&g_sUart, &sCfg);
+    sFormat.flow = (uint8_t)iFlow;
+    uart_inst_configure(&g_sUart, u32Baud, sFormat, nullptr);
+    uart_sim_remote_flow(uSHELL_UART_BENCH_PORT, iFlow);
+
+    /* letters only: no XON/XOFF inside the data */
+    for(int i = 0; i < uSHELL_UART_BENCH_BYTES; ++i) {
+        g_vu8Sent[i] = (uint8_t)('A' + ((i * 7) % 26));
+    }
+} /* uartBenchOpen() */
+
+
+/*----------------------------------------------------------------------------*/
+static bool uartBenchTx(const char *pstrName, const uint32_t u32Baud)
+{
+    uartBenchOpen(u32Baud, UART_FLOW_NONE);
+    const uint64_t u64Start = uart_sim_now_ns();
+    uart_inst_write(&g_sUart, g_vu8Sent, uSHELL_UART_BENCH_BYTES);
+
+    /* the ring drains while the driver is polled (each register access takes time), a lost byte ends it after the idle timeout */
+    int iGot = 0;
+    uint64_t u64Last = uart_sim_now_ns();
+    while((iGot < uSHELL_UART_BENCH_BYTES) && ((uart_sim_now_ns() - u64Last) < uSHELL_UART_BENCH_IDLE_NS)) {
+        uart_inst_txfree(&g_sUart);
+        const int iRecv = uart_sim_recv(uSHELL_UART_BENCH_PORT, &g_vu8Got[iGot], uSHELL_UART_BENCH_BYTES - iGot);
+        if(iRecv > 0) {
+            iGot += iRecv;
+            u64Last = uart_sim_now_ns();
+        }
+    }
+    const uint64_t u64Ns = u64Last - u64Start;
+    uart_stats_t sStats;
+    uart_inst_stats_get(&g_sUart, &sStats);
+
+    const bool bOk = (uSHELL_UART_BENCH_BYTES == iGot) && (0 == memcmp(g_vu8Sent, g_vu8Got, uSHELL_UART_BENCH_BYTES));
+    const double dLine = (double)g_sUart.rate.baud / 10.0;   /* 8N1: 10 bits per byte */
+    const double dRate = (double)uSHELL_UART_BENCH_BYTES * 1e9 / (double)u64Ns;
+    printf("{\"name\":\"%s\",\"baud\":%u,\"bytes\":%d,\"time_us\":%.1f,\"bytes_per_s\":%.0f,\"line_pct\":%.2f,\"tx_wait_us\":%llu,\"ok\":%s}\n",
+           pstrName, (unsigned int)g_sUart.rate.baud, uSHELL_UART_BENCH_BYTES, (double)u64Ns / 1000.0, dRate, 100.0 * dRate / dLine,
+           (unsigned long long)sStats.tx_wait_us, bOk ? "true" : "false");
+    return bOk;
+} /* uartBenchTx() */
+
+
+/*----------------------------------------------------------------------------*/
+static bool uartBenchTx115200(const char *pstrName) { return uartBenchTx(pstrName, 115200U); }
+static bool uartBenchTx921600(const char *pstrName) { return uartBenchTx(pstrName, 921600U); }
+static bool uartBenchTx2M(const char *pstrName)     { return uartBenchTx(pstrName, 2000000U); }
+
+
+/*----------------------------------------------------------------------------*/
+static int uartBenchDrain(uint8_t *pu8Buf, const int iMax)
+{
+    /* polls the driver until iMax bytes arrived or nothing came for uSHELL_UART_BENCH_IDLE_NS */
+    int iGot = 0;
+    uint64_t u64Last = uart_sim_now_ns();
+    while((iGot < iMax) && ((uart_sim_now_ns() - u64Last) < uSHELL_UART_BENCH_IDLE_NS)) {
+        uart_inst_txfree(&g_sUart);
+        const int iRecv = uart_sim_recv(uSHELL_UART_BENCH_PORT, &pu8Buf[iGot], iMax - iGot);
+        if(iRecv > 0) {
+            iGot += iRecv;
+            u64Last = uart_sim_now_ns();
+        }
+        uart_sim_advance_ns(1000U);
+    }
+    return iGot;
+} /* uartBenchDrain() */
+
+
+/*----------------------------------------------------------------------------*/
+static bool uartBenchTxXoff(const char *pstrName)
+{
+    /* an XOFF of the other side holds the TX ring until its XON; a rate switch meanwhile gives up on the ring */
+    static const uint8_t u8Xoff = 0x13, u8Xon = 0x11;
+    const int iBytes = 256;
+    uart_format_t sFormat = UART_FORMAT_8N1;
+    uart_stats_t sStats;
+
+    uartBenchOpen(uSHELL_UART_BENCH_RX_BAUD, UART_FLOW_XON_XOFF);
+    uart_sim_send(uSHELL_UART_BENCH_PORT, &u8Xoff, 1);
+    uart_sim_advance_ns(20000U);
+    uart_inst_txfree(&g_sUart);                                 /* the XOFF is taken from the RX FIFO */
+    uart_inst_write(&g_sUart, g_vu8Sent, iBytes);
+    const int iHeld = uartBenchDrain(g_vu8Got, iBytes);        /* nothing may arrive before the idle timeout */
+
+    uart_sim_send(uSHELL_UART_BENCH_PORT, &u8Xon, 1);
+    const int iResumed = uartBenchDrain(g_vu8Got, iBytes);
+    const bool bResumed = (iBytes == iResumed) && (0 == memcmp(g_vu8Sent, g_vu8Got, iBytes));
+
+    uart_sim_send(uSHELL_UART_BENCH_PORT, &u8Xoff, 1);
+    uart_sim_advance_ns(20000U);
+    uart_inst_txfree(&g_sUart);
+    uart_inst_write(&g_sUart, g_vu8Sent, 100);
+    sFormat.flow = UART_FLOW_XON_XOFF;
+    const uint64_t u64Start = uart_sim_now_ns();
+    const int iSwitch = uart_inst_switch(&g_sUart, uSHELL_UART_BENCH_RX_BAUD, sFormat, 1U);
+    const uint64_t u64SwitchNs = uart_sim_now_ns() - u64Start;
+    uart_inst_stats_get(&g_sUart, &sStats);
+
+    const bool bOk = (0 == iHeld) && (true == bResumed) && (1 == iSwitch) && (100U == sStats.tx_dropped) && (u64SwitchNs < 1000000000ULL);
+    printf("{\"name\":\"%s\",\"baud\":%u,\"held\":%s,\"resumed\":%s,\"xoff_received\":%u,\"switch_ms\":%.1f,\"tx_dropped\":%u,\"ok\":%s}\n",
+           pstrName, (unsigned int)g_sUart.rate.baud, (0 == iHeld) ? "true" : "false", bResumed ? "true" : "false", (unsigned int)sStats.xoff_received,
+           (double)u64SwitchNs / 1e6, (unsigned int)sStats.tx_dropped, bOk ? "true" : "false");
+    return bOk;
+} /* uartBenchTxXoff() */
+
+
+/*----------------------------------------------------------------------------*/
+static bool uartBenchTxCts(const char *pstrName)
+{
+    /* the other side drops CTS: the FIFO stops sending until CTS comes back, nothing is lost meanwhile */
+    const int iBytes = 256;
+
+    uartBenchOpen(uSHELL_UART_BENCH_RX_BAUD, UART_FLOW_RTS_CTS);
+    uart_sim_set_cts(uSHELL_UART_BENCH_PORT, false);
+    uart_inst_write(&g_sUart, g_vu8Sent, iBytes);
+    const int iHeld = uartBenchDrain(g_vu8Got, iBytes);        /* nothing may arrive before the idle timeout */
+
+    uart_sim_set_cts(uSHELL_UART_BENCH_PORT, true);
+    const int iResumed = uartBenchDrain(g_vu8Got, iBytes);
+    const bool bResumed = (iBytes == iResumed) && (0 == memcmp(g_vu8Sent, g_vu8Got, iBytes));
+
+    const bool bOk = (0 == iHeld) && (true == bResumed);
+    printf("{\"name\":\"%s\",\"baud\":%u,\"held\":%s,\"resumed\":%s,\"received\":%d,\"ok\":%s}\n",
+           pstrName, (unsigned int)g_sUart.rate.baud, (0 == iHeld) ? "true" : "false", bResumed ? "true" : "false", iResumed, bOk ? "true" : "false");
+    return bOk;
+} /* uartBenchTxCts() */
+
+
+/*----------------------------------------------------------------------------*/
+static bool uartBenchRxErrors(const char *pstrName)
+{
+    /* a frame error and a parity error, each with its own byte: one count each, the bytes are still delivered */
+    static const uint32_t vu32Errors[] = { UART_SIM_INT_FRM_ERR, UART_SIM_INT_PARITY_ERR };
+    int iGot = 0;
+    uart_stats_t sStats;
+
+    uartBenchOpen(uSHELL_UART_BENCH_RX_BAUD, UART_FLOW_NONE);
+    for(size_t i = 0; i < sizeof(vu32Errors) / sizeof(vu32Errors[0]); ++i) {
+        uart_sim_error(uSHELL_UART_BENCH_PORT, vu32Errors[i]);
+        uart_sim_send(uSHELL_UART_BENCH_PORT, &g_vu8Sent[i], 1);
+        uart_sim_advance_ns(20000U);                            /* two frames at 921600 */
+        iGot += uart_inst_read(&g_sUart, &g_vu8Got[iGot], 1);
+    }
+    uart_inst_txfree(&g_sUart);
+    uart_inst_stats_get(&g_sUart, &sStats);
+
+    const bool bOk = (2 == iGot) && (0 == memcmp(g_vu8Sent, g_vu8Got, 2)) && (1U == sStats.frame_errors) && (1U == sStats.parity_errors);
+    printf("{\"name\":\"%s\",\"baud\":%u,\"received\":%d,\"frame_errors\":%u,\"parity_errors\":%u,\"ok\":%s}\n",
+           pstrName, (unsigned int)g_sUart.rate.baud, iGot, (unsigned int)sStats.frame_errors, (unsigned int)sStats.parity_errors, bOk ? "true" : "false");
+    return bOk;
+} /* uartBenchRxErrors() */
+
+
+/** \brief expected divisor of a baud rate, iClkDiv < 0: out of the divisor range */
+typedef struct {
+    uint32_t u32ClkHz;
+    uint32_t u32Baud;
+    int      iClkDiv;
+    int      iFrag;
+    int      iErrorPpm;
+} uartBaudCheck_s;
+
+/*----------------------------------------------------------------------------*/
+static bool uartCheckBaud(const char *pstrName)
+{
+    /* the divisor limits are checked with the clock: 16 and 0xFFFFF clocks per bit at 1 baud */
+    static const uartBaudCheck_s vsChecks[] = {
+        { uSHELL_UART_BENCH_APB_HZ, 115200U,    694,      7,  10 },
+        { uSHELL_UART_BENCH_APB_HZ, 921600U,    86,       13, -80 },
+        { uSHELL_UART_BENCH_APB_HZ, 2000000U,   40,       0,  0 },
+        { uSHELL_UART_BENCH_APB_HZ, 5000000U,   16,       0,  0 },
+        { uSHELL_UART_BENCH_APB_HZ, 5100000U,   -1,       0,  0 },
+        { uSHELL_UART_BENCH_APB_HZ, 0U,         -1,       0,  0 },
+        { 16U,                      1U,         16,       0,  0 },
+        { 15U,                      1U,         -1,       0,  0 },
+        { 0xFFFFFU,                 1U,         0xFFFFF,  0,  0 },
+        { 0x100000U,                1U,         -1,       0,  0 },
+    };
+    int iFailed = 0;
+
+    for(size_t i = 0; i < sizeof(vsChecks) / sizeof(vsChecks[0]); ++i) {
+        const uartBaudCheck_s *psCheck = &vsChecks[i];
+        uart_baud_t sRate = {};
+        const int iRetVal = uart_baud_calc(psCheck->u32ClkHz, psCheck->u32Baud, &sRate);
+        const bool bOk = (psCheck->iClkDiv < 0) ? (0 != iRetVal) :
+                         ((0 == iRetVal) && ((uint32_t)psCheck->iClkDiv == sRate.clkdiv) && ((uint32_t)psCheck->iFrag == sRate.frag) && (psCheck->iErrorPpm == sRate.error_ppm));
+        if(false == bOk) {
+            fprintf(stderr, "%s: clk %u baud %u => %d, %u+%u/16, %d ppm\n", pstrName, (unsigned int)psCheck->u32ClkHz, (unsigned int)psCheck->u32Baud,
+                    iRetVal, (unsigned int)sRate.clkdiv, (unsigned int)sRate.frag, (int)sRate.error_ppm);
+            ++iFailed;
+        }
+    }
+    printf("{\"name\":\"%s\",\"checks\":%d,\"failed\":%d,\"ok\":%s}\n", pstrName, (int)(sizeof(vsChecks) / sizeof(vsChecks[0])), iFailed, (0 == iFailed) ? "true" : "false");
+    return (0 == iFailed);
+} /* uartCheckBaud() */
+
+
+/*----------------------------------------------------------------------------*/
+static bool uartCheckFormat(const char *pstrName)
+{
+    /* valid strings set the frame and keep the flow control, invalid ones leave the format untouched */
+    static const char *vstrInvalid[] = { "", "8", "8N", "4N1", "9N1", "8X1", "8N0", "8N3", "8N1.0", "8N15", "8N1 " };
+    int iFailed = 0;
+    int iChecks = 0;
+    char vstrName[6];
+    uart_format_t sFormat = { 8, UART_PARITY_NONE, UART_STOP_1, UART_FLOW_RTS_CTS };
+
+    iFailed += (0 != uart_format_parse("7E2", &sFormat)) || (7 != sFormat.data_bits) || (UART_PARITY_EVEN != sFormat.parity) ||
+               (UART_STOP_2 != sFormat.stop) || (UART_FLOW_RTS_CTS != sFormat.flow);
+    iFailed += (0 != uart_format_parse("5o1.5", &sFormat)) || (5 != sFormat.data_bits) || (UART_PARITY_ODD != sFormat.parity) ||
+               (UART_STOP_1_5 != sFormat.stop) || (UART_FLOW_RTS_CTS != sFormat.flow);
+    iFailed += (0 != uart_format_parse("8N1", &sFormat)) || (8 != sFormat.data_bits) || (UART_PARITY_NONE != sFormat.parity) ||
+               (UART_STOP_1 != sFormat.stop);
+    uart_format_name(sFormat, vstrName);
+    iFailed += (0 != strcmp(vstrName, "8N1"));
+    iChecks = 4;
+
+    for(size_t i = 0; i < sizeof(vstrInvalid) / sizeof(vstrInvalid[0]); ++i, ++iChecks) {
+        const uart_format_t sBefore = sFormat;
+        if((0 == uart_format_parse(vstrInvalid[i], &sFormat)) || (0 != memcmp(&sBefore, &sFormat, sizeof(sFormat)))) {
+            fprintf(stderr, "%s: \"%s\" accepted\n", pstrName, vstrInvalid[i]);
+            sFormat = sBefore;
+            ++iFailed;
+        }
+    }
+    printf("{\"name\":\"%s\",\"checks\":%d,\"failed\":%d,\"ok\":%s}\n", pstrName, iChecks, iFailed, (0 == iFailed) ? "true" : "false");
+    return (0 == iFailed);
+} /* uartCheckFormat() */
+
+
+static int g_iFmtChecks = 0;
+
+/*----------------------------------------------------------------------------*/
+static int uartCheckFmt(const char *pstrFormat, ...)
+{
+    /* uart_vsnprintf() against the C library, then again into a buffer too short by one */
+    char vstrLibc[256];
+    char vstrUart[256];
+    va_list args, argsCopy;
+    int iFailed = 0;
+
+    va_start(args, pstrFormat);
+    va_copy(argsCopy, args);
+    const int iLibc = vsnprintf(vstrLibc, sizeof(vstrLibc), pstrFormat, args);
+    const int iUart = uart_vsnprintf(vstrUart, sizeof(vstrUart), pstrFormat, argsCopy);
+    va_end(argsCopy);
+    va_end(args);
+    if((iLibc != iUart) || (0 != strcmp(vstrLibc, vstrUart))) {
+        fprintf(stderr, "uart_vsnprintf: \"%s\" => \"%s\", expected \"%s\"\n", pstrFormat, vstrUart, vstrLibc);
+        ++iFailed;
+    }
+
+    if(iLibc > 1) {
+        memset(vstrUart, '#', sizeof(vstrUart));
+        va_start(args, pstrFormat);
+        const int iShort = uart_vsnprintf(vstrUart, iLibc, pstrFormat, args);
+        va_end(args);
+        if((iShort != (iLibc - 1)) || ('\0' != vstrUart[iLibc - 1]) || ('#' != vstrUart[iLibc]) || (0 != strncmp(vstrLibc, vstrUart, (size_t)iShort))) {
+            fprintf(stderr, "uart_vsnprintf: \"%s\" truncated to %d bytes => \"%.*s\"\n", pstrFormat, iLibc, iLibc, vstrUart);
+            ++iFailed;
+        }
+    }
+    ++g_iFmtChecks;
+    return iFailed;
+} /* uartCheckFmt() */
+
+
+/*----------------------------------------------------------------------------*/
+static bool uartCheckPrintf(const char *pstrName)
+{
+    /* the format strings of the shell core, which prints with uart_vsnprintf() on the target */
+    int iFailed = 0;
+    char vcByte = 'k';
+    g_iFmtChecks = 0;
+
+    /* #U and #B */
+    iFailed += uartCheckFmt("tx bytes      : %u\n", 4000000000U);
+    iFailed += uartCheckFmt("rx ring peak  : %u bytes\n", 256U);
+    iFailed += uartCheckFmt("tx wait       : %u ms\n", 0U);
+    iFailed += uartCheckFmt("baud    : %u (requested %u, %d ppm)\n", 921526U, 921600U, -80);
+    iFailed += uartCheckFmt("divisor : %u + %u/16\n", 86U, 13U);
+    iFailed += uartCheckFmt("switching to %u %s flow %s (%d ppm), press Enter at the new rate within %u s\n", 115201U, "8N1", "none", 10, 10U);
+    iFailed += uartCheckFmt("uart : %u %s kept\n", 2000000U, "7E2");
+    iFailed += uartCheckFmt("uart : not confirmed, back to %u %s\n", 115201U, "8N1");
+    /* #t, #t k and #b */
+    iFailed += uartCheckFmt("%15s %8s %9s %9s %9s %9s\n", "command", "calls", "min", "mean", "max", "total");
+    iFailed += uartCheckFmt("%15s %8u", "vtest", 12345U);
+    iFailed += uartCheckFmt(" %6u ns", 999U);
+    iFailed += uartCheckFmt(" %6u us", 1234567U);
+    iFailed += uartCheckFmt("\n%15s", "<");
+    iFailed += uartCheckFmt(" %9s", "more");
+    iFailed += uartCheckFmt(":%u", 0U);
+    iFailed += uartCheckFmt("[overrun] %s: %u ms (budget %u ms), stopped after run %u\n", "vbusy", 101U, 100U, 1U);
+    iFailed += uartCheckFmt("%15s %9s %9s %9s %9s %9s %9s\n", "phase", "min", "p50", "p90", "p99", "max", "mean");
+    /* #M and #S */
+    iFailed += uartCheckFmt("%10s %8u %8u %8u %10u %10u\n", "commands", 3U, 2U, 0U, 4096U, 65536U);
+    iFailed += uartCheckFmt("%15s %8u %s%9u\n", "ilist", 7U, ">", 8192U);
+    iFailed += uartCheckFmt("deepest : %s, %u bytes below the dispatcher (up to %u painted)\n", "vhexlify", 412U, 8192U);
+    /* the shell itself and the root commands */
+    iFailed += uartCheckFmt("\r=> %d (0x%X)\n", -1, 0xFFFFFFFFU);
+    iFailed += uartCheckFmt("%3d %15s : %-15s\n", 7, "liotest", "lio");
+    iFailed += uartCheckFmt("[%d] %-10s %15s", 3, "running", "vbusy");
+    iFailed += uartCheckFmt("%02X|%c ", 0x0DU, vcByte);
+    iFailed += uartCheckFmt("\033[%dC\033[K%s", 12, "help");
+    iFailed += uartCheckFmt("l = %ld, %lu, %lld, %zu\n", -2147483648L, 4294967295UL, -9223372036854775807LL, sizeof(g_vu8Sent));
+    iFailed += uartCheckFmt("%p | %x %08x %-6d| %+d % d %.3s %*s %%\n", (void*)g_vu8Sent, 0xBEEFU, 0xCAFEU, -42, 5, 5, "abcdef", 4, "ab");
+
+    printf("{\"name\":\"%s\",\"checks\":%d,\"failed\":%d,\"ok\":%s}\n", pstrName, g_iFmtChecks, iFailed, (0 == iFailed) ? "true" : "false");
+    return (0 == iFailed);
+} /* uartCheckPrintf() */
+
+
+/*----------------------------------------------------------------------------*/
+static void uartBenchIsr(int iPort)
+{
+    (void)iPort;
+    uart_inst_txfree(&g_sUart);        /* polls the RX FIFO into the ring */
+    uart_sim_reg(g_sUart.base, 0x10) = UART_SIM_INT_RXFIFO_FULL;
+} /* uartBenchIsr() */
+
+
+/*----------------------------------------------------------------------------*/
+static bool uartBenchRx(const char *pstrName, const int iFlow, const bool bBursts, const bool bIsr)
+{
+    uartBenchOpen(uSHELL_UART_BENCH_RX_BAUD, iFlow);
+    if(true == bIsr) {
+        uart_sim_reg(g_sUart.base, 0x24) = (uart_sim_reg(g_sUart.base, 0x24) & ~0x1FFU) | 32U;  /* RXFIFO_FULL threshold */
+        uart_sim_reg(g_sUart.base, 0x0C) = UART_SIM_INT_RXFIFO_FULL;
+        uart_sim_set_isr(uSHELL_UART_BENCH_PORT, uartBenchIsr);
+    }
+    const uint64_t u64Start = uart_sim_now_ns();
+    uart_sim_send(uSHELL_UART_BENCH_PORT, g_vu8Sent, uSHELL_UART_BENCH_BYTES);
+
+    /* the consumer: either slower than the line, or fast but busy elsewhere for long stretches */
+    int iGot = 0;
+    uint64_t u64Idle = 0U;
+    uint64_t u64Last = u64Start;
+    while((iGot < uSHELL_UART_BENCH_BYTES) && (u64Idle < uSHELL_UART_BENCH_IDLE_NS)) {
+        const int iLeft = uSHELL_UART_BENCH_BYTES - iGot;
+        const int iRead = uart_inst_read(&g_sUart, &g_vu8Got[iGot], (bBursts || (iLeft < uSHELL_UART_BENCH_CHUNK)) ? iLeft : uSHELL_UART_BENCH_CHUNK);
+        iGot += iRead;
+        if(iRead > 0) {
+            u64Last = uart_sim_now_ns();
+        }
+        if(true == bBursts) {
+            for(uint32_t u32Ns = 0U; u32Ns < uSHELL_UART_BENCH_BUSY_NS; u32Ns += 1000U) {
+                uart_sim_advance_ns(1000U);     /* 1 us steps: the latency of the ISR */
+            }
+        } else {
+            uart_sim_advance_ns(1000U + (uint64_t)iRead * uSHELL_UART_BENCH_SLOW_NS);
+        }
+        u64Idle = uart_sim_now_ns() - u64Last;
+    }
+    uart_sim_set_isr(uSHELL_UART_BENCH_PORT, nullptr);
+    uart_stats_t sStats;
+    uart_inst_stats_get(&g_sUart, &sStats);
+
+    /* with flow control or the ISR draining the FIFO nothing may be lost */
+    const bool bMustHold = (UART_FLOW_NONE != iFlow) || bIsr;
+    const int iLost = uSHELL_UART_BENCH_BYTES - iGot;
+    const bool bOk = !bMustHold || ((0 == iLost) && (0 == memcmp(g_vu8Sent, g_vu8Got, uSHELL_UART_BENCH_BYTES)));
+    printf("{\"name\":\"%s\",\"baud\":%u,\"bytes\":%d,\"received\":%d,\"lost\":%d,\"time_us\":%.1f,\"overflows\":%u,\"rx_dropped\":%u,\"rx_peak\":%u,\"xoff_sent\":%u,\"ok\":%s}\n",
+           pstrName, (unsigned int)g_sUart.rate.baud, uSHELL_UART_BENCH_BYTES, iGot, iLost, (double)(u64Last - u64Start) / 1000.0,
+           (unsigned int)sStats.rx_overflows, (unsigned int)sStats.rx_dropped, (unsigned int)sStats.rx_peak, (unsigned int)sStats.xoff_sent,
+           bOk ? "true" : "false");
+    return bOk;
+} /* uartBenchRx() */
+
+
+/*----------------------------------------------------------------------------*/
+static bool uartBenchRxNone(const char *pstrName)       { return uartBenchRx(pstrName, UART_FLOW_NONE, false, false); }
+static bool uartBenchRxRtsCts(const char *pstrName)     { return uartBenchRx(pstrName, UART_FLOW_RTS_CTS, false, false); }
+static bool uartBenchRxXonXoff(const char *pstrName)    { return uartBenchRx(pstrName, UART_FLOW_XON_XOFF, false, false); }
+static bool uartBenchRxBurstPoll(const char *pstrName)  { return uartBenchRx(pstrName, UART_FLOW_NONE, true, false); }
+static bool uartBenchRxBurstIsr(const char *pstrName)   { return uartBenchRx(pstrName, UART_FLOW_NONE, true, true); }
+
+
+static const uartBenchCase_s g_vsCases[] = {
+    { "uart_baud_calc",         uartCheckBaud },
+    { "uart_format_parse",      uartCheckFormat },
+    { "uart_vsnprintf",         uartCheckPrintf },
+    { "uart_tx_115200",         uartBenchTx115200 },
+    { "uart_tx_921600",         uartBenchTx921600 },
+    { "uart_tx_2000000",        uartBenchTx2M },
+    { "uart_tx_xoff",           uartBenchTxXoff },
+    { "uart_tx_cts",            uartBenchTxCts },
+    { "uart_rx_slow_none",      uartBenchRxNone },
+    { "uart_rx_slow_rts_cts",   uartBenchRxRtsCts },
+    { "uart_rx_slow_xon_xoff",  uartBenchRxXonXoff },
+    { "uart_rx_busy_poll",      uartBenchRxBurstPoll },
+    { "uart_rx_busy_isr",       uartBenchRxBurstIsr },
+    { "uart_rx_errors",         uartBenchRxErrors },
+};
+
+
+/*----------------------------------------------------------------------------*/
+int main(int argc, char *argv[])
+{
+    const char *pstrFilter = (argc > 1) ? argv[1] : nullptr;
+    int iRetVal = 0;
+
+    for(size_t i = 0; i < sizeof(g_vsCases) / sizeof(g_vsCases[0]); ++i) {
+        if((nullptr != pstrFilter) && (nullptr == strstr(g_vsCases[i].pstrName, pstrFilter))) {
+            continue;
+        }
+        if(false == g_vsCases[i].pfRun(g_vsCases[i].pstrName)) {
+            iRetVal = 1;
+        }
+    }
+    return iRetVal;
+} /* main() */
@@ -24,6 +24,11 @@ THE SOFTWARE.
 #define USHELL_CORE_H
 
 #include "ushell_core_datatypes.h"
+#include "ushell_core_keys.h"
+
+#if (1 == uSHELL_IMPLEMENTS_JOBS)
+#include <pthread.h>
+#endif /*(1 == uSHELL_IMPLEMENTS_JOBS)*/
 
 #define uSHELL_VERSION "1.0.0"
 
@@ -32,166 +37,379 @@ class Microshell
 
 public:
 
-    static Microshell *getShellPtr( uShellInst_s *psShellInst, const char *pstrPromptExt );
+    /* the command table is shared read-only, every instance owns its state and I/O */
+    Microshell( const uShellInst_s *psShellInst, const uShellIo_s *psIo, const char *pstrPromptExt );
+    ~Microshell();
+    static Microshell *getShellPtr( const uShellInst_s *psShellInst, const char *pstrPromptExt );
+    static const uShellIo_s *getDefaultIo( void );
     void Run( void );
+    /* non-blocking use from an event loop: both return false once the shell exited */
+    bool Feed( const char *pstrData, const size_t szLen );
+    bool Poll( void );
+    size_t RamUsage( void );
 #if (1 == uSHELL_SUPPORTS_COMMAND_AS_PARAMETER)
     bool Execute( const char *pstrCommand );
 #endif /* (1 == uSHELL_SUPPORTS_COMMAND_AS_PARAMETER) */
+#if (1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS)
+    /* lock-free posting from other tasks and ISRs, the commands run in the shell loop between keys */
+    int  Parse( const char *pstrLine, parsedCmd_s *psParsed );                                      /* any task, the edited line is not touched */
+    bool Post( const parsedCmd_s *psParsed, PFPOSTDONE pfDone = nullptr, void *pvCtx = nullptr );  /* ISR safe, false if the queue is full */
+    bool Post( const parsedCmd_s *psParsed, postFuture_s *psFuture );
+#endif /*(1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS)*/
 
 private:
 
-    Microshell( uShellInst_s *psShellInst, const char *pstrPromptExt );
     /* shell core private functions */
-    static void m_Init( const char *pstrPromptExt );
-    static bool m_Execute( void );
-    static void m_CoreSetPrompt( const char *pstrPromptExt );
-    static void m_CoreExecuteEnterKey( void );
-    static int  m_CoreParseCommand( void );
-    static void m_CoreParseExecuteCommand( void );
-    static int  m_CoreSearchFunction( const char *pstrFctName );
-    static void m_CorePrintError( const int iError );
-    static void m_CorePutString( const char *pstrArray);
-    static void m_CoreProcessKeyPress( const char cKeyPressed );
-    static void m_CoreResetInput( const bool bFull );
-    static void m_CoreRemoveTrailingSpaces( void );
-    static void m_CorePrintMessage( const int iFeatIdx, const int iStatusIdx );
-    static void m_CorePrintPrompt( void );
+    void m_Init( const char *pstrPromptExt );
+    bool m_Execute( void );
+    void m_CoreStart( void );
+    void m_CoreStop( void );
+    bool m_CoreIsRunning( void );
+    void m_CoreStep( const char cByte );
+    void m_CoreSetPrompt( const char *pstrPromptExt );
+    void m_CoreExecuteEnterKey( void );
+    int  m_CoreParseCommand( char *pstrInput, command_s *psCommand );
+    void m_CoreParseExecuteCommand( void );
+    int  m_CoreExec( const command_s *psCommand );
+    int  m_CoreSearchFunction( const char *pstrFctName );
+    void m_CorePrintError( const int iError );
+    void m_CorePutString( const char *pstrArray);
+    void m_CoreProcessKeyPress( const char cKeyPressed );
+    void m_CoreResetInput( const bool bFull );
+    void m_CoreRemoveTrailingSpaces( void );
+    void m_CorePrintMessage( const int iFeatIdx, const int iStatusIdx );
+    void m_CorePrintPrompt( void );
+    void m_CoreShowRamUsage( void );
+#if ((1 == uSHELL_IMPLEMENTS_JOBS) || (1 == uSHELL_IMPLEMENTS_COROUTINES) || (1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS))
+    static void m_CoreCopyCommand( command_s *psDst, char *pstrDst, const command_s *psSrc, const char *pstrSrc );
+#endif /*((1 == uSHELL_IMPLEMENTS_JOBS) || (1 == uSHELL_IMPLEMENTS_COROUTINES) || (1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS))*/
+
+    /* instance I/O */
+    int  m_CoreGetch( void );
+    int  m_CoreTryGetch( void );
+    int  m_CoreTxFree( void );
+    int  m_CoreRead( char *pcBuf, const int iMaxLen );
+    void m_CorePutch( const char cChar );
+    void m_CoreWrite( const char *pcBuf, const int iLen );
+    void m_CorePrintf( const char *pstrFormat, ... );
+    static void m_CoreSinkWrite( void *pvShell, const char *pcBuf, const int iLen );   /* the print sink of the commands */
 
 #if (1 == uSHELL_IMPLEMENTS_SHELL_EXIT)
-    static void m_CoreExit( void );
+    void m_CoreExit( void );
 #endif /*(1 == uSHELL_IMPLEMENTS_SHELL_EXIT)*/
 
 #if (1 == uSHELL_IMPLEMENTS_COMMAND_HELP)
-    static void m_CoreShowInfo( const char *pstrArgs );
-    static void m_CoreShowCmdInfo( const int iFctIndex, const bool bParamInfo );
-    static void m_CoreShowShortcuts( void );
-    static void m_CoreShowTypes( void );
-    static void m_CorePutChars( const char *pstrArray, int iNrChars, const bool bNewLine );
+    void m_CoreShowInfo( const char *pstrArgs );
+    void m_CoreShowCmdInfo( const int iFctIndex, const bool bParamInfo );
+    void m_CoreShowShortcuts( void );
+    void m_CoreShowTypes( void );
+    void m_CorePutChars( const char *pstrArray, int iNrChars, const bool bNewLine );
 #endif /* (1 == uSHELL_IMPLEMENTS_COMMAND_HELP)*/
-    static void m_CoreShowCmd( int iFctIndex );
-    static void m_CoreShowCmdsList( void );
+    void m_CoreShowCmd( int iFctIndex );
+    void m_CoreShowCmdsList( void );
 
 #if defined(uSHELL_IMPLEMENTS_STRINGS)
 #if (1 == uSHELL_SUPPORTS_SPACED_STRINGS)
-    static int  m_CoreHandleBorderedStrings( char **token, char **rest, int *pIntArgCounter );
-    static void m_CoreSetStringBorder( const char *pstrStringBorder );
+    int  m_CoreHandleBorderedStrings( command_s *psCommand, char **token, char **rest, int *pIntArgCounter );
+    void m_CoreSetStringBorder( const char *pstrStringBorder );
 #endif /*(1 == uSHELL_SUPPORTS_SPACED_STRINGS)*/
 #endif /*defined(uSHELL_IMPLEMENTS_STRINGS)*/
 
     /* core key handlers */
-    static void m_CoreHandleKeyEnter( void );
-    static void m_CoreHandleKeyDefault( const char cKeyPressed );
-    static bool m_CoreHandleShortcuts( void );
-    static bool m_CoreIsShortcutSymbol( const char cKey );
-    static void m_CoreHandleShortcut_Hash( const char *pstrArgs );
+    void m_CoreHandleKeyEnter( void );
+    void m_CoreHandleKeyDefault( const char cKeyPressed );
+    bool m_CoreHandleShortcuts( void );
+    bool m_CoreIsShortcutSymbol( const char cKey );
+    void m_CoreHandleShortcut_Hash( const char *pstrArgs );
 
 #if (1 == uSHELL_IMPLEMENTS_EDITMODE) || (1 == uSHELL_IMPLEMENTS_HISTORY)
-    static void m_CoreHandleKeyArrowUpDown( const dir_e eDir );
+    void m_CoreHandleKeyArrowUpDown( const dir_e eDir );
 #endif /*(1 == uSHELL_IMPLEMENTS_EDITMODE) || (1 == uSHELL_IMPLEMENTS_HISTORY)*/
 
 #if (1 == uSHELL_IMPLEMENTS_EDITMODE) || (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
-    static void m_CoreHandleKeyArrowLeftRight( const dir_e eDir );
+    void m_CoreHandleKeyArrowLeftRight( const dir_e eDir );
 #endif /*(1 == uSHELL_IMPLEMENTS_EDITMODE) || (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)*/
 
-    static void m_CoreHandleKeyEscapeSeq( void );
-    static void m_CoreHandleKeyBackspace( void );
-    static void m_CoreHandleKeyDelete( void );
-    static void m_CoreCmdLineDelete( void );
+    void m_CoreHandleKeyEscapeSeq( const char cSeqKey );
+    void m_CoreHandleKeyBackspace( void );
+    void m_CoreHandleKeyDelete( void );
+    void m_CoreCmdLineDelete( void );
 
 #if (1 == uSHELL_IMPLEMENTS_CONFIRM_REQUEST)
-    static bool m_CoreConfirmRequest( void );
+    void m_CoreConfirmRequest( const confirm_e eAction );
+    void m_CoreConfirmAnswer( const char cAnswer );
 #endif /*(1 == uSHELL_IMPLEMENTS_CONFIRM_REQUEST)*/
 
 #if (1 == uSHELL_IMPLEMENTS_EDITMODE)
-    static bool m_EditMoveCursor( const dir_e eDir );
-    static void m_EditMoveCursorDirSteps( const dir_e eDir, const int iSteps );
-    static void m_EditInsertUnderCursor( const char cKeyPressed );
-    static void m_EditDeleteUnderCursor( void );
-    static void m_EditDeleteBackward( void );
-    static void m_EditDeleteBackwardToHome( void );
-    static void m_EditDeleteForwardToEnd( void );
+    bool m_EditMoveCursor( const dir_e eDir );
+    void m_EditMoveCursorDirSteps( const dir_e eDir, const int iSteps );
+    void m_EditInsertUnderCursor( const char cKeyPressed );
+    void m_EditDeleteUnderCursor( void );
+    void m_EditDeleteBackward( void );
+    void m_EditDeleteBackwardToHome( void );
+    void m_EditDeleteForwardToEnd( void );
 #if !defined(uSHELL_EDIT_MODE_DEFAULT_ACTIVE)
-    static void m_CoreHandleKeyInsert( void );
+    void m_CoreHandleKeyInsert( void );
 #endif /* !defined(uSHELL_EDIT_MODE_DEFAULT_ACTIVE) */
 #endif /* (1 == uSHELL_IMPLEMENTS_EDITMODE) */
 
 #if (1 == uSHELL_IMPLEMENTS_HISTORY)
     /* circular buffer functions */
-    static bool m_CircBufInit( void );
-    static void m_CircBufDeinit( const deinit_e eTyp);
-    static bool m_CircBufWrite( const void *pElem, const size_t szElemSize);
-    static bool m_CircBufRead( dir_e eDir, void *pElem, size_t *pszSize);
-    static int  m_CircBufShow( void );
-    static bool m_CircBufItemExists( const void* pElem);
-    static void m_CircBufFlagsReset( void );
-    static char* m_CircBufGetItem( const int iIndex );
-    static void m_CircBufFreeMem( const bool bFull );
+    bool m_CircBufInit( void );
+    void m_CircBufDeinit( const deinit_e eTyp);
+    bool m_CircBufWrite( const void *pElem, const size_t szElemSize);
+    bool m_CircBufRead( dir_e eDir, void *pElem, size_t *pszSize);
+    int  m_CircBufShow( void );
+    bool m_CircBufItemExists( const void* pElem);
+    void m_CircBufFlagsReset( void );
+    char* m_CircBufGetItem( const int iIndex );
+    void m_CircBufFreeMem( const bool bFull );
 
     /* history functions */
-    static void m_HistoryInit( const char *pstrFileName );
-    static void m_HistoryDeInit( void );
-    static void m_HistoryWrite( void );
-    static void m_HistoryReset( void );
-    static void m_HistoryList( void );
-    static void m_HistoryExecuteEntry( const char *pstrIndex );
-    static void m_HistoryRead( const dir_e eDir );
-    static char* m_HistoryGetEntry( int iIndex );
-    static void m_HistoryEnable( const bool bEnable );
+    void m_HistoryInit( const char *pstrFileName );
+    void m_HistoryDeInit( void );
+    void m_HistoryWrite( void );
+    void m_HistoryReset( void );
+    void m_HistoryList( void );
+    void m_HistoryExecuteEntry( const char *pstrIndex );
+    void m_HistoryRead( const dir_e eDir );
+    char* m_HistoryGetEntry( int iIndex );
+    void m_HistoryEnable( const bool bEnable );
 #endif /* (1 == uSHELL_IMPLEMENTS_HISTORY) */
 
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_SUGGEST)
+    bool m_HistoryIndexInit( void );
+    void m_HistoryIndexDeinit( void );
+    void m_HistoryIndexClear( void );
+    void m_HistoryIndexInsert( const int iSlot );
+    void m_HistoryIndexRemove( const int iSlot );
+    void m_HistorySuggestShow( void );
+    void m_HistorySuggestHide( void );
+    bool m_HistorySuggestAccept( void );
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY_SUGGEST)*/
+
 #if ((1 == uSHELL_IMPLEMENTS_HISTORY) && (1 == uSHELL_IMPLEMENTS_SAVE_HISTORY))
-    static void m_HistoryReload( void );
-    static void m_HistoryLoadFromFile( void );
+    void m_HistoryReload( void );
+    void m_HistoryLoadFromFile( void );
 #endif /*((1 == uSHELL_IMPLEMENTS_HISTORY) && (1 == uSHELL_IMPLEMENTS_SAVE_HISTORY))*/
 
 #if (1 == uSHELL_IMPLEMENTS_SAVE_HISTORY)
-    static void m_HistoryInitFile( const char *pstrFileName );
-    static void m_HistoryWriteFile( void );
-    static void m_HistoryCloseFile( void );
+    void m_HistoryInitFile( const char *pstrFileName );
+    void m_HistoryWriteFile( void );
+    void m_HistoryCloseFile( void );
 #endif /*(1 == uSHELL_IMPLEMENTS_SAVE_HISTORY)*/
 
     /* autocomplete functions */
 #if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
-    static void m_AutocomplInit( void );
-    static void m_AutocomplFill( const bool bFull );
-    static void m_AutocomplReInit( void );
-    static void m_AutocomplReset( const bool bReinit );
-    static void m_AutocomplGetCommon( void );
-    static void m_AutocomplFilter( void );
-    static void m_AutocomplInsEndSpace( void );
-    static void m_AutocomplRead( const dir_e eDir );
-    static void m_AutocomplEnable( const bool bEnable );
+    void m_AutocomplInit( void );
+    void m_AutocomplFill( const bool bFull );
+    void m_AutocomplReInit( void );
+    void m_AutocomplReset( const bool bReinit );
+    void m_AutocomplGetCommon( void );
+    void m_AutocomplFilter( void );
+    int  m_AutocomplChild( const autocomplIndex_s *psIndex, const int iNode, const char cKey );
+    const char *m_AutocomplName( const autocomplIndex_s *psIndex, const int iSortedPos );
+    int  m_AutocomplWalk( const autocomplIndex_s *psIndex, const char *pstrName, const int iLen );
+    int  m_AutocomplCandidate( const int iSearchIndex );
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPL_RANKING)
+    void m_AutocomplRankUpdate( const int iFctIndex );
+    void m_AutocomplRankFront( void );
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPL_RANKING)*/
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPL_FUZZY)
+    void m_AutocomplFuzzy( const int iLen );
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPL_FUZZY)*/
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPL_ARGS)
+    const autocomplIndex_s *m_AutocomplArgIndex( const int iTokenStart );
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPL_ARGS)*/
+    void m_AutocomplInsEndSpace( void );
+    void m_AutocomplRead( const dir_e eDir );
+    void m_AutocomplEnable( const bool bEnable );
 #endif /* (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE) */
 
+#if (1 == uSHELL_IMPLEMENTS_JOBS)
+    /* background jobs */
+    bool m_JobsIsBackground( void );
+    bool m_JobsStartWorkers( void );
+    void m_JobsStopWorkers( void );
+    void m_JobsSubmit( void );
+    void m_JobsWorkerLoop( void );
+    static void *m_JobsWorker( void *pvShell );
+    job_s *m_JobsFind( const int iId );
+    void m_JobsList( void );
+    void m_JobsWait( const char *pstrArgs );
+    void m_JobsCancel( const char *pstrArgs );
+    void m_JobsReport( void );
+#endif /*(1 == uSHELL_IMPLEMENTS_JOBS)*/
+
+#if (1 == uSHELL_IMPLEMENTS_COROUTINES)
+    /* coroutine commands */
+    bool m_TaskSpawn( void );
+    void m_TaskStep( void );
+    void m_TaskInput( const char cByte );
+    void m_TaskEnd( const bool bCancelled );
+#endif /*(1 == uSHELL_IMPLEMENTS_COROUTINES)*/
+
+#if (1 == uSHELL_IMPLEMENTS_LOG_SINK)
+    /* queued logs printed above the edited line */
+    void m_LogFlush( void );
+#endif /*(1 == uSHELL_IMPLEMENTS_LOG_SINK)*/
+#if ((1 == uSHELL_IMPLEMENTS_LOG_SINK) || (1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS))
+    void m_LogRedraw( void );
+#endif /*((1 == uSHELL_IMPLEMENTS_LOG_SINK) || (1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS))*/
+
+#if (1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS)
+    /* commands posted by other tasks and ISRs */
+    void m_PostRun( void );
+    static void m_PostFutureDone( void *pvCtx, const int iRetVal );
+#endif /*(1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS)*/
+
+#if (1 == uSHELL_IMPLEMENTS_TIME_STATS)
+    /* execution timing and key latency statistics */
+    static void m_StatsAdd( timeStats_s *psStats, const uint32_t u32Ticks );
+    static void m_StatsClear( timeStats_s *psStats, const int iNrStats );
+    void m_StatsPrintRow( const char *pstrName, const timeStats_s *psStats );
+    void m_StatsPrintTime( const uint64_t u64Ticks );
+#endif /*(1 == uSHELL_IMPLEMENTS_TIME_STATS)*/
+#if ((1 == uSHELL_IMPLEMENTS_EXEC_STATS) || (1 == uSHELL_IMPLEMENTS_KEY_LATENCY))
+    void m_StatsShow( const char *pstrArgs );
+#endif /*((1 == uSHELL_IMPLEMENTS_EXEC_STATS) || (1 == uSHELL_IMPLEMENTS_KEY_LATENCY))*/
+#if (1 == uSHELL_IMPLEMENTS_EXEC_STATS)
+    void m_StatsInit( void );
+    void m_StatsDeinit( void );
+    void m_StatsShowCommands( const char cSort );
+    uint64_t m_StatsSortKey( const int iFctIndex, const char cSort );
+#endif /*(1 == uSHELL_IMPLEMENTS_EXEC_STATS)*/
+#if (1 == uSHELL_IMPLEMENTS_KEY_LATENCY)
+    keyClass_e m_KeyLatClass( const char cByte );
+    void m_StatsShowKeys( void );
+#endif /*(1 == uSHELL_IMPLEMENTS_KEY_LATENCY)*/
+
+#if (1 == uSHELL_IMPLEMENTS_BENCH)
+    /* command benchmark */
+    void m_BenchRun( const char *pstrArgs );
+    void m_BenchPrintRow( const char *pstrPhase, uint32_t *pu32Samples, const uint32_t u32NrRuns );
+    static int m_BenchCompare( const void *pvA, const void *pvB );
+#endif /*(1 == uSHELL_IMPLEMENTS_BENCH)*/
+
+#if (1 == uSHELL_IMPLEMENTS_TRACE)
+    /* event trace ring */
+    void m_TraceRecord( const traceEvent_e eEvent, const uint16_t u16Arg );
+    void m_TraceShow( const char *pstrArgs );
+    void m_TraceDump( void );
+    void m_TracePut( const uint32_t u32Value, const int iNrBytes );
+#endif /*(1 == uSHELL_IMPLEMENTS_TRACE)*/
+
+#if (1 == uSHELL_IMPLEMENTS_HEAP_STATS)
+    /* heap of the shell and of its commands */
+    void m_HeapShow( const char *pstrArgs );
+#endif /*(1 == uSHELL_IMPLEMENTS_HEAP_STATS)*/
+
+#if (1 == uSHELL_IMPLEMENTS_STACK_USAGE)
+    /* stack high-water mark of the commands */
+    void m_StackInit( void );
+    void m_StackDeinit( void );
+    void m_StackShow( const char *pstrArgs );
+#endif /*(1 == uSHELL_IMPLEMENTS_STACK_USAGE)*/
+
+#if (1 == uSHELL_IMPLEMENTS_UART_STATS)
+    /* counters of the console UART */
+    void m_UartShow( const char *pstrArgs );
+#endif /*(1 == uSHELL_IMPLEMENTS_UART_STATS)*/
+
+#if (1 == uSHELL_IMPLEMENTS_UART_CONFIG)
+    /* rate and format of the console UART */
+    void m_UartBaud( const char *pstrArgs );
+#endif /*(1 == uSHELL_IMPLEMENTS_UART_CONFIG)*/
+
 #if (1 == uSHELL_IMPLEMENTS_KEY_DECODER)
-    static void keydecoder( void );
+    void keydecoder( const char cRead );
 #endif /*(1 == uSHELL_IMPLEMENTS_KEY_DECODER)*/
 
-    static char m_pstrInput[uSHELL_MAX_INPUT_BUF_LEN];
-    static int m_iInputPos;
-    static int m_iCursorPos;
-    static command_s m_sCommand;
+    const uShellInst_s *m_pInst;
+    const uShellIo_s *m_psIo;
+    char m_pstrInput[uSHELL_MAX_INPUT_BUF_LEN] = {0};
+    int m_iInputPos = 0;
+    int m_iCursorPos = 0;
+    command_s m_sCommand = {};
+    char m_vstrPrompt[uSHELL_PROMPT_MAX_LEN] = {0};
+    int m_iPromptLength = 0;
+    input_e m_eInputState = uSHELL_INPUT_KEY;
+    char m_cEscKey = 0;
+    bool m_bStarted = false;
+
+#if (1 == uSHELL_IMPLEMENTS_CONFIRM_REQUEST)
+    confirm_e m_eConfirmAction = uSHELL_CONFIRM_EXIT;
+#endif /*(1 == uSHELL_IMPLEMENTS_CONFIRM_REQUEST)*/
+
+#if (1 == uSHELL_IMPLEMENTS_SHELL_EXIT)
+    bool m_bKeepRunning = true;
+#endif /*(1 == uSHELL_IMPLEMENTS_SHELL_EXIT)*/
+
+#if (1 == uSHELL_IMPLEMENTS_SAVE_HISTORY)
+    FILE *m_pfileHistory = nullptr;
+#endif /*(1 == uSHELL_IMPLEMENTS_SAVE_HISTORY)*/
 
 #if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
-    static autocomplete_s m_sAutocomplete;
+    autocomplete_s m_sAutocomplete = {};
 #endif /* (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE) */
 
 #if (1 == uSHELL_IMPLEMENTS_HISTORY)
-    static circbuf_s m_sCircBuf;
-    static history_s m_sHistory;
+    circbuf_s m_sCircBuf = {};
+    history_s m_sHistory = {};
 #endif /* (1 == uSHELL_IMPLEMENTS_HISTORY) */
 
+#if (1 == uSHELL_IMPLEMENTS_JOBS)
+    job_s m_vsJobs[uSHELL_JOBS_MAX] = {};
+    pthread_t m_vWorkers[uSHELL_JOBS_WORKERS];
+    pthread_mutex_t m_sJobsLock = PTHREAD_MUTEX_INITIALIZER;
+    pthread_cond_t m_sJobsCond = PTHREAD_COND_INITIALIZER;     /* a job was queued or has finished */
+    int m_iJobsLastId = 0;
+    int m_iNrWorkers = 0;
+    bool m_bJobsStop = false;
+#endif /*(1 == uSHELL_IMPLEMENTS_JOBS)*/
+
+#if (1 == uSHELL_IMPLEMENTS_COROUTINES)
+    uShellTask m_sTask;
+    command_s m_sTaskCommand = {};                              /* strings point into m_vstrTaskInput */
+    char m_vstrTaskInput[uSHELL_MAX_INPUT_BUF_LEN] = {0};
+#endif /*(1 == uSHELL_IMPLEMENTS_COROUTINES)*/
+
+#if (1 == uSHELL_IMPLEMENTS_EXEC_STATS)
+    timeStats_s *m_psStats = nullptr;                           /* one per command, allocated by m_StatsInit() */
+#endif /*(1 == uSHELL_IMPLEMENTS_EXEC_STATS)*/
+
+#if (1 == uSHELL_IMPLEMENTS_KEY_LATENCY)
+    timeStats_s m_vsKeyLat[uSHELL_KEYCLASS_LAST];
+#endif /*(1 == uSHELL_IMPLEMENTS_KEY_LATENCY)*/
+
+#if (1 == uSHELL_IMPLEMENTS_TRACE)
+    traceRec_s m_vsTrace[uSHELL_TRACE_RECORDS] = {};
+    uint32_t m_u32TraceHead = 0U;                               /* records written since start, wraps */
+#endif /*(1 == uSHELL_IMPLEMENTS_TRACE)*/
+
+#if (1 == uSHELL_IMPLEMENTS_STACK_USAGE)
+    stackUse_s *m_psStack = nullptr;                            /* one per command, allocated by m_StackInit() */
+#endif /*(1 == uSHELL_IMPLEMENTS_STACK_USAGE)*/
+
+#if (1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS)
+    uShellMpsc<postedCmd_s, uSHELL_POST_SLOTS> m_sPostQueue;
+#endif /*(1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS)*/
+
 #if (1 == uSHELL_IMPLEMENTS_EDITMODE)
-    static bool m_bEditMode;
+#if defined(uSHELL_EDIT_MODE_DEFAULT_ACTIVE)
+    bool m_bEditMode = true;
+#else
+    bool m_bEditMode = false;
+#endif /* defined(uSHELL_EDIT_MODE_DEFAULT_ACTIVE) */
 #endif /*(1 == uSHELL_IMPLEMENTS_EDITMODE) */
 
 #if (1 == uSHELL_IMPLEMENTS_DISABLE_ECHO)
-    static bool m_bEchoOn;
+    bool m_bEchoOn = true;
 #endif /* (1 == uSHELL_IMPLEMENTS_DISABLE_ECHO) */
 
     static const char *m_pstrCoreShortcutCaption;
 #if (defined(uSHELL_IMPLEMENTS_STRINGS) && (1 == uSHELL_SUPPORTS_SPACED_STRINGS))
-    static char m_cStringBorderSymbol;
+    char m_cStringBorderSymbol = uSHELL_KEY_QUOTATION_MARK;
 #endif /*(defined(uSHELL_IMPLEMENTS_STRINGS) && (1 == uSHELL_SUPPORTS_SPACED_STRINGS))*/
 
     /* delimiters/separators */
@@ -221,13 +439,11 @@ private:
 #undef   uSHELL_PROMPT_CELL
 #undef   uSHELL_PROMPT_TABLE_END
 
-    static char m_pstrPrompt[uSHELL_PROMPTI_LAST + 1];
+    static const char m_pstrPrompt[uSHELL_PROMPTI_LAST + 1];
     static const char m_pstrPromptInfo[uSHELL_PROMPTI_LAST + 1];
     static const char m_pstrPromptInfoEditMode[uSHELL_PROMPTI_LAST + 1];
-    static void m_CoreUpdatePrompt( const prompti_e ePromptIndex, const bool bOnOff );
+    void m_CoreUpdatePrompt( const prompti_e ePromptIndex, const bool bOnOff );
 #endif /*(1 == uSHELL_IMPLEMENTS_SMART_PROMPT)*/
-
-    static uShellInst_s *m_pInst;
 };
 
 #endif /* USHELL_CORE_H */
@@ -0,0 +1,287 @@
+#ifndef USHELL_CORE_TRANSPORT_H
+#define USHELL_CORE_TRANSPORT_H
+
+#include "ushell_core_datatypes.h"
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+/*
+    Transports of the shell: a backend is any class with the methods below,
+    uShellTransport<T>::Io() makes the uShellIo_s of a Microshell instance
+    out of it. The backend is called directly from one trampoline per
+    callback, so the calls are inlined there and the core only sees the
+    function pointers it already had: a backend is chosen when the instance
+    is created, the core is not rebuilt for it.
+
+        int  Getch(void);                               mandatory
+        void Putch(const char cChar);                   mandatory
+        int  TryGetch(void);                            optional, see uShellIo_s
+        int  TxFree(void);                              optional
+        int  Read(char *pcBuf, const int iMaxLen);      optional
+        void Write(const char *pcBuf, const int iLen);  optional
+
+    usage:
+        static uShellMemTransport sMem(vcOut, sizeof(vcOut));
+        static const uShellIo_s sIo = uShellTransport<uShellMemTransport>::Io(&sMem);
+        Microshell sShell(psInst, &sIo, "test");
+        sMem.SetInput("help\n", 5);
+        sShell.Poll();
+*/
+
+template <typename T>
+class uShellTransport
+{
+    public:
+
+        /** \brief the I/O of a shell instance on pBackend, which must outlive the instance */
+        static constexpr uShellIo_s Io(T *pBackend)
+        {
+            uShellIo_s sIo = { m_Getch, m_Putch, nullptr, nullptr, nullptr, nullptr, pBackend };
+
+            if constexpr (requires(T &t) { t.TryGetch(); }) {
+                sIo.pfTryGetch = m_TryGetch;
+            }
+            if constexpr (requires(T &t) { t.TxFree(); }) {
+                sIo.pfTxFree = m_TxFree;
+            }
+            if constexpr (requires(T &t, char *pcBuf, int iLen) { t.Read(pcBuf, iLen); }) {
+                sIo.pfRead = m_Read;
+            }
+            if constexpr (requires(T &t, const char *pcBuf, int iLen) { t.Write(pcBuf, iLen); }) {
+                sIo.pfWrite = m_Write;
+            }
+            return sIo;
+        }
+
+    private:
+
+        static int  m_Getch(void *pvCtx)                                     { return static_cast<T*>(pvCtx)->Getch(); }
+        static void m_Putch(void *pvCtx, const char cChar)                   { static_cast<T*>(pvCtx)->Putch(cChar); }
+        static int  m_TryGetch(void *pvCtx)                                  { return static_cast<T*>(pvCtx)->TryGetch(); }
+        static int  m_TxFree(void *pvCtx)                                    { return static_cast<T*>(pvCtx)->TxFree(); }
+        static int  m_Read(void *pvCtx, char *pcBuf, int iMaxLen)            { return static_cast<T*>(pvCtx)->Read(pcBuf, iMaxLen); }
+        static void m_Write(void *pvCtx, const char *pcBuf, int iLen)        { static_cast<T*>(pvCtx)->Write(pcBuf, iLen); }
+};
+
+
+/*
+    In memory: the input is a buffer given by the caller (not copied), the
+    output is kept in another one while it fits and always counted. Lets the
+    tests and the benchmarks drive the shell through Poll() at memory speed.
+*/
+class uShellMemTransport
+{
+    public:
+
+        uShellMemTransport(char *pcOut = nullptr, const size_t szOutSize = 0U) : m_pcOut(pcOut), m_szOutSize(szOutSize) {}
+
+        /** \brief the next input, read from its first byte */
+        void SetInput(const char *pcData, const size_t szLen)
+        {
+            m_pcIn = pcData;
+            m_szInLen = szLen;
+            m_szInPos = 0U;
+        }
+
+        /** \brief the output kept since the last ClearOutput(), not terminated */
+        const char *Output(void) const { return m_pcOut; }
+        size_t OutputLen(void) const { return m_szOutLen; }
+        /** \brief every byte written, the ones that did not fit too */
+        size_t OutputTotal(void) const { return m_szOutTotal; }
+        void ClearOutput(void) { m_szOutLen = 0U; }
+
+        int Getch(void)
+        {
+            return (m_szInPos < m_szInLen) ? (int)(unsigned char)m_pcIn[m_szInPos++] : uSHELL_IO_NO_DATA;
+        }
+
+        int Read(char *pcBuf, const int iMaxLen)
+        {
+            size_t szLen = m_szInLen - m_szInPos;
+            szLen = (szLen < (size_t)iMaxLen) ? szLen : (size_t)iMaxLen;
+            if(0U != szLen) {
+                memcpy(pcBuf, &m_pcIn[m_szInPos], szLen);
+                m_szInPos += szLen;
+            }
+            return (int)szLen;
+        }
+
+        void Putch(const char cChar)
+        {
+            Write(&cChar, 1);
+        }
+
+        void Write(const char *pcBuf, const int iLen)
+        {
+            size_t szLen = m_szOutSize - m_szOutLen;
+            szLen = (szLen < (size_t)iLen) ? szLen : (size_t)iLen;
+            if(0U != szLen) {
+                memcpy(&m_pcOut[m_szOutLen], pcBuf, szLen);
+                m_szOutLen += szLen;
+            }
+            m_szOutTotal += (size_t)iLen;
+        }
+
+    private:
+
+        const char *m_pcIn = nullptr;
+        size_t m_szInLen = 0U;
+        size_t m_szInPos = 0U;
+        char *m_pcOut;
+        size_t m_szOutSize;
+        size_t m_szOutLen = 0U;
+        size_t m_szOutTotal = 0U;
+};
+
+
+/* C streams, stdin/stdout by default: Run() waits in Getch() */
+class uShellStdioTransport
+{
+    public:
+
+        uShellStdioTransport(FILE *pIn = stdin, FILE *pOut = stdout) : m_pIn(pIn), m_pOut(pOut) {}
+
+        int  Getch(void)                                { return fgetc(m_pIn); }
+        void Putch(const char cChar)                    { fputc(cChar, m_pOut); }
+        void Write(const char *pcBuf, const int iLen)   { fwrite(pcBuf, 1, (size_t)iLen, m_pOut); }
+
+    private:
+
+        FILE *m_pIn;
+        FILE *m_pOut;
+};
+
+
+#if defined(__linux__)
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+
+/*
+    Linux pseudo terminal: the shell owns the master side, a terminal
+    program opens Name() like a serial port (i.e. picocom /dev/pts/3).
+    Run() sleeps in Getch() until a key arrives, Poll() takes what arrived.
+*/
+class uShellPtyTransport
+{
+    public:
+
+        ~uShellPtyTransport() { Close(); }
+
+        /** \brief creates the terminal, false on error (errno is kept) */
+        bool Open(void)
+        {
+            struct termios sTio;
+            const char *pstrName = nullptr;
+
+            m_iMaster = posix_openpt(O_RDWR | O_NOCTTY);
+            if((m_iMaster < 0) || (0 != grantpt(m_iMaster)) || (0 != unlockpt(m_iMaster)) || (nullptr == (pstrName = ptsname(m_iMaster)))) {
+                Close();
+                return false;
+            }
+            snprintf(m_vstrName, sizeof(m_vstrName), "%s", pstrName);
+
+            /* raw slave, no echo or line editing in between; kept open so the master does not read EIO while nobody is connected */
+            m_iSlave = open(m_vstrName, O_RDWR | O_NOCTTY);
+            if((m_iSlave < 0) || (0 != tcgetattr(m_iSlave, &sTio))) {
+                Close();
+                return false;
+            }
+            cfmakeraw(&sTio);
+            tcsetattr(m_iSlave, TCSANOW, &sTio);
+            fcntl(m_iMaster, F_SETFL, fcntl(m_iMaster, F_GETFL) | O_NONBLOCK);
+            return true;
+        }
+
+        void Close(void)
+        {
+            if(m_iSlave >= 0) {
+                close(m_iSlave);
+            }
+            if(m_iMaster >= 0) {
+                close(m_iMaster);
+            }
+            m_iSlave = m_iMaster = -1;
+        }
+
+        /** \brief the slave device the terminal program connects to */
+        const char *Name(void) const { return m_vstrName; }
+
+        int Getch(void)
+        {
+            struct pollfd sPoll = { m_iMaster, POLLIN, 0 };
+            char cChar;
+
+            while(1 != Read(&cChar, 1)) {
+                if((poll(&sPoll, 1, -1) < 0) && (EINTR != errno)) {
+                    return uSHELL_IO_NO_DATA;
+                }
+            }
+            return (int)(unsigned char)cChar;
+        }
+
+        int Read(char *pcBuf, const int iMaxLen)
+        {
+            const ssize_t sszLen = read(m_iMaster, pcBuf, (size_t)iMaxLen);
+            return (sszLen > 0) ? (int)sszLen : 0;
+        }
+
+        void Putch(const char cChar)
+        {
+            Write(&cChar, 1);
+        }
+
+        void Write(const char *pcBuf, const int iLen)
+        {
+            struct pollfd sPoll = { m_iMaster, POLLOUT, 0 };
+            size_t szDone = 0U;
+
+            /* the master is non-blocking: waits while the terminal does not read, gives up after 1 s */
+            while(szDone < (size_t)iLen) {
+                const ssize_t sszLen = write(m_iMaster, &pcBuf[szDone], (size_t)iLen - szDone);
+                if(sszLen > 0) {
+                    szDone += (size_t)sszLen;
+                } else if(((EAGAIN != errno) && (EINTR != errno)) || (0 == poll(&sPoll, 1, 1000))) {
+                    break;
+                }
+            }
+        }
+
+    private:
+
+        int m_iMaster = -1;
+        int m_iSlave = -1;
+        char m_vstrName[64] = "";
+};
+#endif /*defined(__linux__)*/
+
+
+#if __has_include("uart_access.h")
+#include "uart_access.h"
+
+/* bare-metal UART instance of uart_access (i.e. uart_console()), non-blocking like the default I/O on the target */
+class uShellUartTransport
+{
+    public:
+
+        explicit uShellUartTransport(uart_inst_t *psUart) : m_psUart(psUart) {}
+
+        int  Getch(void)                                { return uart_inst_getchar(m_psUart); }
+        int  TryGetch(void)                             { return uart_inst_trygetchar(m_psUart); }
+        int  TxFree(void)                               { return uart_inst_txfree(m_psUart); }
+        void Putch(const char cChar)                    { uart_inst_putchar(m_psUart, cChar); }
+        int  Read(char *pcBuf, const int iMaxLen)       { return uart_inst_read(m_psUart, pcBuf, iMaxLen); }
+        void Write(const char *pcBuf, const int iLen)   { uart_inst_write(m_psUart, pcBuf, iLen); }
+
+    private:
+
+        uart_inst_t *m_psUart;
+};
+#endif /*__has_include("uart_access.h")*/
+
+#endif /* USHELL_CORE_TRANSPORT_H */
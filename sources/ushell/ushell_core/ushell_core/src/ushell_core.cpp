@@ -25,23 +25,28 @@ THE SOFTWARE.
 #include "ushell_core_keys.h"
 #include "ushell_core_utils.h"
 #include "ushell_core_printout.h"
+#if ((1 == uSHELL_IMPLEMENTS_UART_STATS) || (1 == uSHELL_IMPLEMENTS_UART_CONFIG))
+#include "uart_access.h"
+#endif /*((1 == uSHELL_IMPLEMENTS_UART_STATS) || (1 == uSHELL_IMPLEMENTS_UART_CONFIG))*/
 
 #include <cstdlib>
 #include <cstring>
 #include <cstdint>
 #include <cctype>
+#include <climits>
+#if (1 == uSHELL_IMPLEMENTS_JOBS)
+#include <ctime>
+#endif /*(1 == uSHELL_IMPLEMENTS_JOBS)*/
 
 /*==============================================================================
                             LOCAL DEFINES
 ==============================================================================*/
 
-/* read/check tilde in escape sequence*/
+/* escape sequence keys closed by a tilde */
 #if (defined(__MINGW32__) || defined(_MSC_VER)) /* i.e MinGW or Microsoft VisualStudio for Windows console */
-#define SKIP_TILDE   true
-#define SKIP_BRACKET true
+#define uSHELL_ESCSEQ_HAS_TILDE(c)  false
 #else
-#define SKIP_TILDE   (uSHELL_KEY_TILDE        == uSHELL_GETCH())
-#define SKIP_BRACKET (uSHELL_KEY_LEFT_BRACKET == uSHELL_GETCH())
+#define uSHELL_ESCSEQ_HAS_TILDE(c)  (((c) >= uSHELL_KEY_ESCAPESEQ1_HOME) && ((c) <= uSHELL_KEY_ESCAPESEQ1_PAGEDOWN))
 #endif
 
 /* concatenate strings */
@@ -51,33 +56,217 @@ THE SOFTWARE.
 #define uSHELL_NEWLINE      "\n\r"
 #define uSHELL_INVALID_VALUE (-1)
 
+/* tracepoints of the core, they vanish without the trace */
+#if (1 == uSHELL_IMPLEMENTS_TRACE)
+#define uSHELL_TRACE(e, a)  m_TraceRecord((e), (uint16_t)(a))
+#else
+#define uSHELL_TRACE(e, a)
+#endif /*(1 == uSHELL_IMPLEMENTS_TRACE)*/
+
+/*==============================================================================
+                            LOCAL FUNCTIONS
+==============================================================================*/
+
+/* default I/O backend: the platform console (see ushell_core_printout.h) */
+static int uShellDefaultGetch(void *pvCtx)
+{
+    (void)pvCtx;
+    return uSHELL_GETCH();
+}
+
+static void uShellDefaultPutch(void *pvCtx, const char cChar)
+{
+    (void)pvCtx;
+    uSHELL_PUTCH(cChar);
+}
+
+#if defined(uSHELL_TRYGETCH)
+static int uShellDefaultTryGetch(void *pvCtx)
+{
+    (void)pvCtx;
+    return uSHELL_TRYGETCH();
+}
+#endif /*defined(uSHELL_TRYGETCH)*/
+
+#if defined(uSHELL_TXFREE)
+static int uShellDefaultTxFree(void *pvCtx)
+{
+    (void)pvCtx;
+    return uSHELL_TXFREE();
+}
+#endif /*defined(uSHELL_TXFREE)*/
+
+#if defined(uSHELL_READ)
+static int uShellDefaultRead(void *pvCtx, char *pcBuf, int iMaxLen)
+{
+    (void)pvCtx;
+    return uSHELL_READ(pcBuf, iMaxLen);
+}
+#endif /*defined(uSHELL_READ)*/
+
+#if defined(uSHELL_WRITE)
+static void uShellDefaultWrite(void *pvCtx, const char *pcBuf, int iLen)
+{
+    (void)pvCtx;
+    uSHELL_WRITE(pcBuf, iLen);
+}
+#endif /*defined(uSHELL_WRITE)*/
+
+static const uShellIo_s g_sDefaultIo = {
+    uShellDefaultGetch,
+    uShellDefaultPutch,
+#if defined(uSHELL_TRYGETCH)
+    uShellDefaultTryGetch,
+#else
+    nullptr,
+#endif /*defined(uSHELL_TRYGETCH)*/
+#if defined(uSHELL_TXFREE)
+    uShellDefaultTxFree,
+#else
+    nullptr,
+#endif /*defined(uSHELL_TXFREE)*/
+#if defined(uSHELL_READ)
+    uShellDefaultRead,
+#else
+    nullptr,
+#endif /*defined(uSHELL_READ)*/
+#if defined(uSHELL_WRITE)
+    uShellDefaultWrite,
+#else
+    nullptr,
+#endif /*defined(uSHELL_WRITE)*/
+    nullptr
+};
+
+/* from here on the core reads and writes only through the I/O of its instance */
+#undef  uSHELL_PRINTF
+#undef  uSHELL_GETCH
+#undef  uSHELL_PUTCH
+#define uSHELL_PRINTF   m_CorePrintf
+#define uSHELL_GETCH()  m_CoreGetch()
+#define uSHELL_PUTCH(x) m_CorePutch(x)
+
 /*==============================================================================
                     PUBLIC INTERFACES IMPLEMENTATION
 ==============================================================================*/
 
-Microshell *Microshell::getShellPtr(uShellInst_s *psShellInst, const char *pstrPromptExt)
+Microshell::Microshell(const uShellInst_s *psShellInst, const uShellIo_s *psIo, const char *pstrPromptExt)
+{
+    m_pInst = psShellInst;
+    m_psIo  = psIo;
+    m_Init(pstrPromptExt);
+} /* Microshell() */
+
+
+/*----------------------------------------------------------------------------*/
+Microshell::~Microshell()
+{
+#if (1 == uSHELL_IMPLEMENTS_JOBS)
+    /* a shell left without exiting still has its workers waiting on the table */
+    m_JobsStopWorkers();
+    pthread_cond_destroy(&m_sJobsCond);
+    pthread_mutex_destroy(&m_sJobsLock);
+#endif /*(1 == uSHELL_IMPLEMENTS_JOBS)*/
+} /* ~Microshell() */
+
+
+/*----------------------------------------------------------------------------*/
+Microshell *Microshell::getShellPtr(const uShellInst_s *psShellInst, const char *pstrPromptExt)
 {
-    static Microshell uShellInstance(psShellInst, pstrPromptExt);
+    static Microshell uShellInstance(psShellInst, &g_sDefaultIo, pstrPromptExt);
     return &uShellInstance;
 } /* getShell() */
 
 
+/*----------------------------------------------------------------------------*/
+const uShellIo_s *Microshell::getDefaultIo(void)
+{
+    return &g_sDefaultIo;
+} /* getDefaultIo() */
+
+
 /*----------------------------------------------------------------------------*/
 void Microshell::Run(void)
 {
-    m_CorePrintPrompt();
+    m_CoreStart();
     while(m_Execute()) {}
-#if (1 == uSHELL_IMPLEMENTS_SAVE_HISTORY)
-    m_HistoryCloseFile();
-#endif /*(1 == uSHELL_IMPLEMENTS_SAVE_HISTORY)*/
+    m_CoreStop();
+} /* Run() */
+
+
+/*----------------------------------------------------------------------------*/
+bool Microshell::Feed(const char *pstrData, const size_t szLen)
+{
+    if(true == m_CoreIsRunning()) {
+        m_CoreStart();
+        for(size_t i = 0; (i < szLen) && (true == m_CoreIsRunning()); ++i) {
+            m_CoreStep(pstrData[i]);
+        }
+#if (1 == uSHELL_IMPLEMENTS_LOG_SINK)
+        m_LogFlush();
+#endif /*(1 == uSHELL_IMPLEMENTS_LOG_SINK)*/
+#if (1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS)
+        m_PostRun();
+#endif /*(1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS)*/
+#if (1 == uSHELL_IMPLEMENTS_COROUTINES)
+        m_TaskStep();   /* one chunk of the running coroutine per call */
+#endif /*(1 == uSHELL_IMPLEMENTS_COROUTINES)*/
+        if(false == m_CoreIsRunning()) {
+            m_CoreStop();
+        }
+    }
+    return m_CoreIsRunning();
+} /* Feed() */
+
+
+/*----------------------------------------------------------------------------*/
+bool Microshell::Poll(void)
+{
+    /* needs a backend returning uSHELL_IO_NO_DATA when nothing was received */
+    char vcData[uSHELL_POLL_MAX_BYTES];
+    size_t szLen = 0;
+    int iKey;
+
+    if(nullptr != m_psIo->pfRead) {
+        szLen = (size_t)m_CoreRead(vcData, (int)sizeof(vcData));
+    } else {
+        while((szLen < sizeof(vcData)) && (uSHELL_IO_NO_DATA != (iKey = uSHELL_GETCH()))) {
+            vcData[szLen++] = (char)iKey;
+        }
+    }
+    return Feed(vcData, szLen);
+} /* Poll() */
+
+
+/*----------------------------------------------------------------------------*/
+size_t Microshell::RamUsage(void)
+{
+    size_t szTotal = sizeof(Microshell);
 #if (1 == uSHELL_IMPLEMENTS_HISTORY)
-    m_HistoryDeInit();
+    if(nullptr != m_sCircBuf.ppData) {
+        szTotal += uSHELL_HISTORY_DEPTH * (sizeof(void*) + sizeof(size_t));
+        for(unsigned int i = 0; i < uSHELL_HISTORY_DEPTH; ++i) {
+            szTotal += m_sCircBuf.pDataSize[i];
+        }
+    }
 #endif /* (1 == uSHELL_IMPLEMENTS_HISTORY) */
-#if (1 == uSHELL_IMPLEMENTS_SAVE_HISTORY)
-    m_HistoryCloseFile();
-#endif /*(1 == uSHELL_IMPLEMENTS_SAVE_HISTORY) */
-    uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR,"uShell exit!\n\r"));
-} /* Run() */
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_SUGGEST)
+    if(nullptr != m_sHistory.psNodes) {
+        szTotal += (uSHELL_HISTORY_INDEX_NODES * sizeof(histNode_s)) + (uSHELL_HISTORY_DEPTH * sizeof(uint8_t));
+    }
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY_SUGGEST)*/
+#if (1 == uSHELL_IMPLEMENTS_EXEC_STATS)
+    if(nullptr != m_psStats) {
+        szTotal += m_pInst->iNrFunctions * sizeof(timeStats_s);
+    }
+#endif /*(1 == uSHELL_IMPLEMENTS_EXEC_STATS)*/
+#if (1 == uSHELL_IMPLEMENTS_STACK_USAGE)
+    if(nullptr != m_psStack) {
+        szTotal += m_pInst->iNrFunctions * sizeof(stackUse_s);
+    }
+#endif /*(1 == uSHELL_IMPLEMENTS_STACK_USAGE)*/
+    return szTotal;
+} /* RamUsage() */
 
 
 #if (1 == uSHELL_SUPPORTS_COMMAND_AS_PARAMETER)
@@ -92,7 +281,7 @@ bool Microshell::Execute(const char *pstrCommand)
         m_iInputPos = iLen;
         m_HistoryWriteFile();
 #endif /*(1 == uSHELL_IMPLEMENTS_SAVE_HISTORY) */
-        if( (uSHELL_ERR_OK == m_CoreParseCommand()) && (m_pInst->pfExec(&m_sCommand) >= 0) ) {
+        if( (uSHELL_ERR_OK == m_CoreParseCommand(m_pstrInput, &m_sCommand)) && (m_CoreExec(&m_sCommand) >= 0) ) {
             bRetVal = true;
         }
     }
@@ -100,17 +289,55 @@ bool Microshell::Execute(const char *pstrCommand)
 } /* Execute() */
 #endif /* (1 == uSHELL_SUPPORTS_COMMAND_AS_PARAMETER) */
 
-/*==============================================================================
-                    PRIVATE INTERFACES IMPLEMENTATION
-==============================================================================*/
 
+#if (1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS)
 /*----------------------------------------------------------------------------*/
-Microshell::Microshell(uShellInst_s *psShellInst, const char *pstrPromptExt)
+int Microshell::Parse(const char *pstrLine, parsedCmd_s *psParsed)
 {
-    m_pInst = psShellInst;
-    m_Init(pstrPromptExt);
-} /* Microshell() */
+    /* the line is parsed into the caller's buffer, the shared input and command are not touched */
+    int iRetVal = uSHELL_ERR_TOO_MANY_ARGS;
+    size_t szLen = (nullptr != pstrLine) ? strlen(pstrLine) : uSHELL_MAX_INPUT_BUF_LEN;
+
+    if(szLen < uSHELL_MAX_INPUT_BUF_LEN) {
+        memset(psParsed, 0, sizeof(parsedCmd_s));
+        memcpy(psParsed->vstrInput, pstrLine, szLen);
+        while((szLen > 0) && (*m_pstrTokenSeparator == psParsed->vstrInput[szLen - 1])) {
+            psParsed->vstrInput[--szLen] = '\0';
+        }
+        iRetVal = m_CoreParseCommand(psParsed->vstrInput, &psParsed->sCommand);
+    }
+    return iRetVal;
+} /* Parse() */
+
+
+/*----------------------------------------------------------------------------*/
+bool Microshell::Post(const parsedCmd_s *psParsed, PFPOSTDONE pfDone, void *pvCtx)
+{
+    /* no lock and no wait: a CAS to claim the slot and a copy, so it can be called from ISRs */
+    uint32_t u32Pos = 0U;
+    postedCmd_s *psPosted = m_sPostQueue.Claim(&u32Pos);
+
+    if(nullptr != psPosted) {
+        m_CoreCopyCommand(&psPosted->sParsed.sCommand, psPosted->sParsed.vstrInput, &psParsed->sCommand, psParsed->vstrInput);
+        psPosted->pfDone = pfDone;
+        psPosted->pvCtx  = pvCtx;
+        m_sPostQueue.Publish(u32Pos);
+    }
+    return (nullptr != psPosted);
+} /* Post() */
+
+
+/*----------------------------------------------------------------------------*/
+bool Microshell::Post(const parsedCmd_s *psParsed, postFuture_s *psFuture)
+{
+    psFuture->bDone.store(false, std::memory_order_relaxed);
+    return Post(psParsed, m_PostFutureDone, psFuture);
+} /* Post() */
+#endif /*(1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS)*/
 
+/*==============================================================================
+                    PRIVATE INTERFACES IMPLEMENTATION
+==============================================================================*/
 
 /*----------------------------------------------------------------------------*/
 void Microshell::m_Init(const char *pstrPromptExt)
@@ -126,6 +353,15 @@ void Microshell::m_Init(const char *pstrPromptExt)
 #if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
     m_AutocomplInit();
 #endif /* (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE) */
+#if (1 == uSHELL_IMPLEMENTS_EXEC_STATS)
+    m_StatsInit();
+#endif /*(1 == uSHELL_IMPLEMENTS_EXEC_STATS)*/
+#if (1 == uSHELL_IMPLEMENTS_STACK_USAGE)
+    m_StackInit();
+#endif /*(1 == uSHELL_IMPLEMENTS_STACK_USAGE)*/
+#if (1 == uSHELL_IMPLEMENTS_KEY_LATENCY)
+    m_StatsClear(m_vsKeyLat, uSHELL_KEYCLASS_LAST);
+#endif /*(1 == uSHELL_IMPLEMENTS_KEY_LATENCY)*/
 #if (1 == uSHELL_IMPLEMENTS_SMART_PROMPT)
 #if (1 == uSHELL_IMPLEMENTS_EDITMODE)
 #if defined(uSHELL_EDIT_MODE_DEFAULT_ACTIVE)
@@ -135,7 +371,6 @@ void Microshell::m_Init(const char *pstrPromptExt)
 #endif /*defined(uSHELL_EDIT_MODE_DEFAULT_ACTIVE)*/
 #endif /*(1 == uSHELL_IMPLEMENTS_EDITMODE)*/
 #endif /*(1 == uSHELL_IMPLEMENTS_SMART_PROMPT)*/
-    m_pInst->psShortcutsArray[0] = { '#', m_CoreHandleShortcut_Hash };
     m_CoreResetInput(true);
 #if (1 == uSHELL_SCRIPT_MODE)
         uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR,"uShell v%s [script mode]\n"), uSHELL_VERSION);
@@ -143,7 +378,7 @@ void Microshell::m_Init(const char *pstrPromptExt)
         uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR,"uShell v%s [info: ###]\n"), uSHELL_VERSION);
 #endif /* (1 == uSHELL_SCRIPT_MODE) */
 #if (1 == uSHELL_IMPLEMENTS_SHELL_EXIT)
-    m_pInst->bKeepRuning = true;
+    m_bKeepRunning = true;
 #endif /*(1 == uSHELL_IMPLEMENTS_SHELL_EXIT)*/
 } /* m_Init() */
 
@@ -151,21 +386,174 @@ void Microshell::m_Init(const char *pstrPromptExt)
 /*----------------------------------------------------------------------------*/
 inline bool Microshell::m_Execute(void)
 {
-    m_CoreProcessKeyPress(uSHELL_GETCH());
+    /* with a non-blocking read the loop also serves the logs, the posted commands and the coroutines between keys */
+    bool bBlocking = (nullptr == m_psIo->pfTryGetch);
+#if (1 == uSHELL_IMPLEMENTS_COROUTINES)
+    bBlocking = bBlocking && (uSHELL_INPUT_TASK != m_eInputState);   /* a running coroutine must not wait for the input */
+#endif /*(1 == uSHELL_IMPLEMENTS_COROUTINES)*/
+    if(true == bBlocking) {
+        const int iKey = uSHELL_GETCH();
+        if(uSHELL_IO_NO_DATA != iKey) {
+            m_CoreStep((char)iKey);
+        }
+    } else {
+        /* what arrived since the last pass, in order; the rest of a chunk is dropped once the shell exited */
+        char vcData[uSHELL_POLL_MAX_BYTES];
+        const int iLen = m_CoreRead(vcData, (int)sizeof(vcData));
+        for(int i = 0; (i < iLen) && (true == m_CoreIsRunning()); ++i) {
+            m_CoreStep(vcData[i]);
+        }
+    }
+#if (1 == uSHELL_IMPLEMENTS_LOG_SINK)
+    m_LogFlush();
+#endif /*(1 == uSHELL_IMPLEMENTS_LOG_SINK)*/
+#if (1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS)
+    m_PostRun();
+#endif /*(1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS)*/
+#if (1 == uSHELL_IMPLEMENTS_COROUTINES)
+    m_TaskStep();
+#endif /*(1 == uSHELL_IMPLEMENTS_COROUTINES)*/
+    return m_CoreIsRunning();
+} /* m_Execute() */
+
+
+/*----------------------------------------------------------------------------*/
+inline bool Microshell::m_CoreIsRunning(void)
+{
 #if (1 == uSHELL_IMPLEMENTS_SHELL_EXIT)
-    return m_pInst->bKeepRuning;
+    return m_bKeepRunning;
 #else
     return true;
 #endif /*(1 == uSHELL_IMPLEMENTS_SHELL_EXIT)*/
-} /* m_Execute() */
+} /* m_CoreIsRunning() */
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_CoreStart(void)
+{
+    if(false == m_bStarted) {
+        m_bStarted = true;
+        m_CorePrintPrompt();
+    }
+} /* m_CoreStart() */
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_CoreStop(void)
+{
+#if (1 == uSHELL_IMPLEMENTS_SAVE_HISTORY)
+    m_HistoryCloseFile();
+#endif /*(1 == uSHELL_IMPLEMENTS_SAVE_HISTORY)*/
+#if (1 == uSHELL_IMPLEMENTS_HISTORY)
+    m_HistoryDeInit();
+#endif /* (1 == uSHELL_IMPLEMENTS_HISTORY) */
+#if (1 == uSHELL_IMPLEMENTS_SAVE_HISTORY)
+    m_HistoryCloseFile();
+#endif /*(1 == uSHELL_IMPLEMENTS_SAVE_HISTORY) */
+#if (1 == uSHELL_IMPLEMENTS_JOBS)
+    m_JobsStopWorkers();
+#endif /*(1 == uSHELL_IMPLEMENTS_JOBS)*/
+#if (1 == uSHELL_IMPLEMENTS_EXEC_STATS)
+    m_StatsDeinit();
+#endif /*(1 == uSHELL_IMPLEMENTS_EXEC_STATS)*/
+#if (1 == uSHELL_IMPLEMENTS_STACK_USAGE)
+    m_StackDeinit();
+#endif /*(1 == uSHELL_IMPLEMENTS_STACK_USAGE)*/
+    uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR,"uShell exit!\n\r"));
+} /* m_CoreStop() */
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_CoreStep(const char cByte)
+{
+#if (1 == uSHELL_IMPLEMENTS_KEY_LATENCY)
+    /* from the byte received to the end of its echo, a sequence is measured on its last byte */
+    const uint32_t u32Start = uShellTicks();
+    const keyClass_e eClass = m_KeyLatClass(cByte);
+#endif /*(1 == uSHELL_IMPLEMENTS_KEY_LATENCY)*/
+    uSHELL_TRACE(uSHELL_TRACE_KEY, (uint8_t)cByte);
+    /* a multi-byte key never blocks: the decoder keeps its state until the next byte */
+    switch(m_eInputState) {
+#if !(defined(__MINGW32__) || defined(_MSC_VER))
+        case uSHELL_INPUT_ESC: {
+                /* anything but [ drops the sequence */
+                m_eInputState = (uSHELL_KEY_LEFT_BRACKET == cByte) ? uSHELL_INPUT_ESC_KEY : uSHELL_INPUT_KEY;
+            }
+            break;
+        case uSHELL_INPUT_ESC_TILDE: {
+                m_eInputState = uSHELL_INPUT_KEY;
+                if(uSHELL_KEY_TILDE == cByte) {
+                    m_CoreHandleKeyEscapeSeq(m_cEscKey);
+                }
+            }
+            break;
+#endif /*!(defined(__MINGW32__) || defined(_MSC_VER))*/
+        case uSHELL_INPUT_ESC_KEY: {
+                if(true == uSHELL_ESCSEQ_HAS_TILDE(cByte)) {
+                    m_cEscKey = cByte;
+                    m_eInputState = uSHELL_INPUT_ESC_TILDE;
+                } else {
+                    m_eInputState = uSHELL_INPUT_KEY;
+                    m_CoreHandleKeyEscapeSeq(cByte);
+                }
+            }
+            break;
+#if (1 == uSHELL_IMPLEMENTS_CONFIRM_REQUEST)
+        case uSHELL_INPUT_CONFIRM: {
+                m_CoreConfirmAnswer(cByte);
+            }
+            break;
+#endif /*(1 == uSHELL_IMPLEMENTS_CONFIRM_REQUEST)*/
+#if (1 == uSHELL_IMPLEMENTS_KEY_DECODER)
+        case uSHELL_INPUT_KEYDECODER: {
+                keydecoder(cByte);
+            }
+            break;
+#endif /*(1 == uSHELL_IMPLEMENTS_KEY_DECODER)*/
+#if (1 == uSHELL_IMPLEMENTS_COROUTINES)
+        case uSHELL_INPUT_TASK: {
+                m_TaskInput(cByte);
+            }
+            break;
+#endif /*(1 == uSHELL_IMPLEMENTS_COROUTINES)*/
+        default: {
+                m_CoreProcessKeyPress(cByte);
+            }
+            break;
+    }
+#if (1 == uSHELL_IMPLEMENTS_KEY_LATENCY)
+    if(uSHELL_KEYCLASS_LAST != eClass) {
+        m_StatsAdd(&m_vsKeyLat[eClass], uShellTicks() - u32Start);
+    }
+#endif /*(1 == uSHELL_IMPLEMENTS_KEY_LATENCY)*/
+    uSHELL_TRACE(uSHELL_TRACE_RENDER, (uint8_t)cByte);
+} /* m_CoreStep() */
 
 
 /*----------------------------------------------------------------------------*/
 void Microshell::m_CoreParseExecuteCommand(void)
 {
     int iRetVal = 0;
-    if(uSHELL_ERR_OK == (iRetVal = m_CoreParseCommand())) {
-        if((iRetVal = m_pInst->pfExec(&m_sCommand)) >= 0) {
+    bool bBackground = false;
+#if (1 == uSHELL_IMPLEMENTS_JOBS)
+    bBackground = m_JobsIsBackground();
+#endif /*(1 == uSHELL_IMPLEMENTS_JOBS)*/
+    uSHELL_TRACE(uSHELL_TRACE_PARSE_BEGIN, 0);
+    iRetVal = m_CoreParseCommand(m_pstrInput, &m_sCommand);
+    uSHELL_TRACE(uSHELL_TRACE_PARSE_END, iRetVal);
+    if(uSHELL_ERR_OK == iRetVal) {
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPL_RANKING)
+        m_AutocomplRankUpdate(m_sCommand.iFctIndex);
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPL_RANKING)*/
+        if(true == bBackground) {
+#if (1 == uSHELL_IMPLEMENTS_JOBS)
+            m_JobsSubmit();
+#endif /*(1 == uSHELL_IMPLEMENTS_JOBS)*/
+#if (1 == uSHELL_IMPLEMENTS_COROUTINES)
+        } else if(true == m_TaskSpawn()) {
+            /* resumed by the shell loop, the prompt comes back when it ends */
+#endif /*(1 == uSHELL_IMPLEMENTS_COROUTINES)*/
+        } else if((iRetVal = m_CoreExec(&m_sCommand)) >= 0) {
             uSHELL_PRINTF(FRMT(uSHELL_SUCCESS_COLOR, "\r=> %d (0x%X)\n"), iRetVal, iRetVal);
         } else {
             m_CorePrintError(iRetVal);    /* execution errors */
@@ -177,30 +565,82 @@ void Microshell::m_CoreParseExecuteCommand(void)
 
 
 /*----------------------------------------------------------------------------*/
-int Microshell::m_CoreParseCommand(void)
+int Microshell::m_CoreExec(const command_s *psCommand)
+{
+    /* commands run by the shell loop get a time budget, the jobs are cancelled explicitly */
+#if (1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT)
+    const uint32_t u32BudgetMs = m_pInst->pfBudget(psCommand->iFctIndex);
+    uint32_t u32ElapsedMs = 0U;
+    uShellDeadlineArm(u32BudgetMs);
+#endif /*(1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT)*/
+#if (1 == uSHELL_IMPLEMENTS_STACK_USAGE)
+    /* painted before the timing starts, the usage is counted from this frame */
+    stackPaint_s sPaint;
+    const bool bPainted = (nullptr != m_psStack) && uShellStackPaint(&sPaint, &sPaint);
+#endif /*(1 == uSHELL_IMPLEMENTS_STACK_USAGE)*/
+#if (1 == uSHELL_IMPLEMENTS_EXEC_STATS)
+    const uint32_t u32Start = uShellTicks();
+#endif /*(1 == uSHELL_IMPLEMENTS_EXEC_STATS)*/
+    uSHELL_TRACE(uSHELL_TRACE_EXEC_BEGIN, psCommand->iFctIndex);
+    const printSink_s sPrevSink = uShellSetPrintSink({ m_CoreSinkWrite, this });
+    const int iRetVal = m_pInst->pfExec(psCommand);
+    uShellSetPrintSink(sPrevSink);
+    uSHELL_TRACE(uSHELL_TRACE_EXEC_END, iRetVal);
+#if (1 == uSHELL_IMPLEMENTS_EXEC_STATS)
+    if(nullptr != m_psStats) {
+        m_StatsAdd(&m_psStats[psCommand->iFctIndex], uShellTicks() - u32Start);
+    }
+#endif /*(1 == uSHELL_IMPLEMENTS_EXEC_STATS)*/
+#if (1 == uSHELL_IMPLEMENTS_STACK_USAGE)
+    if(true == bPainted) {
+        stackUse_s *psStack = &m_psStack[psCommand->iFctIndex];
+        bool bSaturated = false;
+        const uint32_t u32Used = (uint32_t)uShellStackUsed(&sPaint, &bSaturated);
+        ++psStack->u32Calls;
+        if((u32Used > psStack->u32Max) || ((u32Used == psStack->u32Max) && (false == bSaturated))) {
+            psStack->u32Max = u32Used;
+            psStack->bSaturated = bSaturated;   /* a lower bound: the painted window grows, the next call is measured */
+        }
+    }
+#endif /*(1 == uSHELL_IMPLEMENTS_STACK_USAGE)*/
+#if (1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT)
+    if(true == uShellDeadlineDisarm(&u32ElapsedMs)) {
+#if (1 == uSHELL_IMPLEMENTS_LOG_SINK)
+        uShellLogPrintf("[overrun] %s: %u ms (budget %u ms)", psCommand->pstrFctName, (unsigned int)u32ElapsedMs, (unsigned int)u32BudgetMs);
+#else
+        uSHELL_PRINTF(FRMT(uSHELL_WARNING_COLOR, "[overrun] %s: %u ms (budget %u ms)") uSHELL_NEWLINE, psCommand->pstrFctName, (unsigned int)u32ElapsedMs, (unsigned int)u32BudgetMs);
+#endif /*(1 == uSHELL_IMPLEMENTS_LOG_SINK)*/
+    }
+#endif /*(1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT)*/
+    return iRetVal;
+} /* m_CoreExec() */
+
+
+/*----------------------------------------------------------------------------*/
+int Microshell::m_CoreParseCommand(char *pstrInput, command_s *psCommand)
 {
     int  iRetVal = uSHELL_ERR_OK;
-    char *pstrRest = m_pstrInput;
+    char *pstrRest = pstrInput;
     char *pstrToken = strtok_ex(pstrRest, m_pstrTokenSeparator, &pstrRest);
-    m_sCommand.pstrFctName = pstrToken;
-    if(uSHELL_ERR_FUNCTION_NOT_FOUND != (m_sCommand.iFctIndex = m_CoreSearchFunction(pstrToken))) {
-        bool bIsVoidFct = ('v' == m_pInst->psFuncDefArray[m_sCommand.iFctIndex].pstrFuncParamDef[0]);
+    psCommand->pstrFctName = pstrToken;
+    if(uSHELL_ERR_FUNCTION_NOT_FOUND != (psCommand->iFctIndex = m_CoreSearchFunction(pstrToken))) {
+        bool bIsVoidFct = ('v' == m_pInst->psFuncDefArray[psCommand->iFctIndex].pstrFuncParamDef[0]);
         bool bHasParams = (nullptr != pstrRest);
-        int iNrParamsExpected = (int)strlen(m_pInst->psFuncDefArray[m_sCommand.iFctIndex].pstrFuncParamDef);
+        int iNrParamsExpected = (int)strlen(m_pInst->psFuncDefArray[psCommand->iFctIndex].pstrFuncParamDef);
 
         if((true == bHasParams) && (false == bIsVoidFct)) {
             int iNrParamsRead = 0;
 #if defined(uSHELL_IMPLEMENTS_STRINGS)
 #if (1 == uSHELL_SUPPORTS_SPACED_STRINGS)
             /* check if the first param is a bordered string */
-            iRetVal = m_CoreHandleBorderedStrings(&pstrToken, &pstrRest, &iNrParamsRead);
+            iRetVal = m_CoreHandleBorderedStrings(psCommand, &pstrToken, &pstrRest, &iNrParamsRead);
 #endif /*(1 == uSHELL_SUPPORTS_SPACED_STRINGS) */
 #endif /*defined(uSHELL_IMPLEMENTS_STRINGS) */
             while((uSHELL_ERR_OK == iRetVal) && (nullptr != (pstrToken = strtok_ex(pstrRest, m_pstrTokenSeparator, &pstrRest)))) {
-                switch(m_pInst->psFuncDefArray[m_sCommand.iFctIndex].pstrFuncParamDef[(m_sCommand.iTypIndex)++]) {
+                switch(m_pInst->psFuncDefArray[psCommand->iFctIndex].pstrFuncParamDef[(psCommand->iTypIndex)++]) {
 #if defined(uSHELL_IMPLEMENTS_NUMBERS_64BIT)
                     case 'l': { /* [l]ong <==> 64 bit */
-                            if(m_sCommand.iNrNums64 < uSHELL_MAX_PARAMS_NUM64) {
+                            if(psCommand->iNrNums64 < uSHELL_MAX_PARAMS_NUM64) {
                                 BIGNUM_T numVal = 0;
                                 if(false == asc2int(pstrToken, &numVal)) {
                                     iRetVal = uSHELL_ERR_INVALID_NUMBER;
@@ -208,7 +648,7 @@ int Microshell::m_CoreParseCommand(void)
                                     if(numVal > uSHELL_MAX_VALUE_64BIT) {
                                         iRetVal = uSHELL_ERR_VALUE_TOO_BIG;
                                     } else {
-                                        m_sCommand.vl[m_sCommand.iNrNums64++] = (num64_t)numVal;
+                                        psCommand->vl[psCommand->iNrNums64++] = (num64_t)numVal;
                                         ++iNrParamsRead;
                                     }
                                 }
@@ -216,14 +656,14 @@ int Microshell::m_CoreParseCommand(void)
                                 iRetVal = uSHELL_ERR_TOO_MANY_ARGS;
                             }
                             if(uSHELL_ERR_OK != iRetVal) {
-                                m_sCommand.eDataType = uSHELL_DATA_TYPE_64BIT;
+                                psCommand->eDataType = uSHELL_DATA_TYPE_64BIT;
                             }
                         }
                         break;
 #endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_64BIT)*/
 #if defined(uSHELL_IMPLEMENTS_NUMBERS_32BIT)
                     case 'i': { /* [i]nteger <==> 32 bit */
-                            if(m_sCommand.iNrNums32 < uSHELL_MAX_PARAMS_NUM32) {
+                            if(psCommand->iNrNums32 < uSHELL_MAX_PARAMS_NUM32) {
                                 BIGNUM_T numVal = 0;
                                 if(false == asc2int(pstrToken, &numVal)) {
                                     iRetVal = uSHELL_ERR_INVALID_NUMBER;
@@ -231,7 +671,7 @@ int Microshell::m_CoreParseCommand(void)
                                     if(numVal > uSHELL_MAX_VALUE_32BIT) {
                                         iRetVal = uSHELL_ERR_VALUE_TOO_BIG;
                                     } else {
-                                        m_sCommand.vi[m_sCommand.iNrNums32++] = (num32_t)numVal;
+                                        psCommand->vi[psCommand->iNrNums32++] = (num32_t)numVal;
                                         ++iNrParamsRead;
                                     }
                                 }
@@ -239,14 +679,14 @@ int Microshell::m_CoreParseCommand(void)
                                 iRetVal = uSHELL_ERR_TOO_MANY_ARGS;
                             }
                             if(uSHELL_ERR_OK != iRetVal) {
-                                m_sCommand.eDataType = uSHELL_DATA_TYPE_32BIT;
+                                psCommand->eDataType = uSHELL_DATA_TYPE_32BIT;
                             }
                         }
                         break;
 #endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_32BIT)*/
 #if defined(uSHELL_IMPLEMENTS_NUMBERS_16BIT)
                     case 'w': { /* [w]ord <==> 16 bit */
-                            if(m_sCommand.iNrNums16 < uSHELL_MAX_PARAMS_NUM16) {
+                            if(psCommand->iNrNums16 < uSHELL_MAX_PARAMS_NUM16) {
                                 BIGNUM_T numVal = 0;
                                 if(false == asc2int(pstrToken, &numVal)) {
                                     iRetVal = uSHELL_ERR_INVALID_NUMBER;
@@ -254,7 +694,7 @@ int Microshell::m_CoreParseCommand(void)
                                     if(numVal > uSHELL_MAX_VALUE_16BIT) {
                                         iRetVal = uSHELL_ERR_VALUE_TOO_BIG;
                                     } else {
-                                        m_sCommand.vw[m_sCommand.iNrNums16++] = (num16_t)numVal;
+                                        psCommand->vw[psCommand->iNrNums16++] = (num16_t)numVal;
                                         ++iNrParamsRead;
                                     }
                                 }
@@ -262,14 +702,14 @@ int Microshell::m_CoreParseCommand(void)
                                 iRetVal = uSHELL_ERR_TOO_MANY_ARGS;
                             }
                             if(uSHELL_ERR_OK != iRetVal) {
-                                m_sCommand.eDataType = uSHELL_DATA_TYPE_16BIT;
+                                psCommand->eDataType = uSHELL_DATA_TYPE_16BIT;
                             }
                         }
                         break;
 #endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_16BIT)*/
 #if defined(uSHELL_IMPLEMENTS_NUMBERS_8BIT)
                     case 'b': { /* [b]yte <==> 8 bit */
-                            if(m_sCommand.iNrNums8 < uSHELL_MAX_PARAMS_NUM8) {
+                            if(psCommand->iNrNums8 < uSHELL_MAX_PARAMS_NUM8) {
                                 BIGNUM_T numVal = 0;
                                 if(false == asc2int(pstrToken, &numVal)) {
                                     iRetVal = uSHELL_ERR_INVALID_NUMBER;
@@ -277,7 +717,7 @@ int Microshell::m_CoreParseCommand(void)
                                     if(numVal > uSHELL_MAX_VALUE_8BIT) {
                                         iRetVal = uSHELL_ERR_VALUE_TOO_BIG;
                                     } else {
-                                        m_sCommand.vb[m_sCommand.iNrNums8++] = (num8_t)numVal;
+                                        psCommand->vb[psCommand->iNrNums8++] = (num8_t)numVal;
                                         ++iNrParamsRead;
                                     }
                                 }
@@ -285,7 +725,7 @@ int Microshell::m_CoreParseCommand(void)
                                 iRetVal = uSHELL_ERR_TOO_MANY_ARGS;
                             }
                             if(uSHELL_ERR_OK != iRetVal) {
-                                m_sCommand.eDataType = uSHELL_DATA_TYPE_8BIT;
+                                psCommand->eDataType = uSHELL_DATA_TYPE_8BIT;
                             }
                         }
                         break;
@@ -293,39 +733,39 @@ int Microshell::m_CoreParseCommand(void)
 #if defined(uSHELL_IMPLEMENTS_NUMBERS_FLOAT)
                     case 'f': {
                             float numVal = 0;
-                            if(m_sCommand.iNrNumsFloat < uSHELL_MAX_PARAMS_FLOAT) {
+                            if(psCommand->iNrNumsFloat < uSHELL_MAX_PARAMS_FLOAT) {
                                 if(false == asc2float(pstrToken, &numVal)) {
                                     iRetVal = uSHELL_ERR_INVALID_NUMBER;
                                 } else {
-                                    m_sCommand.vf[m_sCommand.iNrNumsFloat++] = numVal;
+                                    psCommand->vf[psCommand->iNrNumsFloat++] = numVal;
                                     ++iNrParamsRead;
                                 }
                             } else {
                                 iRetVal = uSHELL_ERR_TOO_MANY_ARGS;
                             }
                             if(uSHELL_ERR_OK != iRetVal) {
-                                m_sCommand.eDataType = uSHELL_DATA_TYPE_FLOAT;
+                                psCommand->eDataType = uSHELL_DATA_TYPE_FLOAT;
                             }
                         }
                         break;
 #endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_FLOAT)*/
 #if defined(uSHELL_IMPLEMENTS_STRINGS)
                     case 's': { /* [s]tring <==> (char*) */
-                            if(m_sCommand.iNrStrings < uSHELL_MAX_PARAMS_STRING) {
-                                m_sCommand.vs[m_sCommand.iNrStrings++] = pstrToken;
+                            if(psCommand->iNrStrings < uSHELL_MAX_PARAMS_STRING) {
+                                psCommand->vs[psCommand->iNrStrings++] = pstrToken;
                                 ++iNrParamsRead;
                             } else {
                                 iRetVal = uSHELL_ERR_TOO_MANY_ARGS;
                             }
                             if(uSHELL_ERR_OK != iRetVal) {
-                                m_sCommand.eDataType = uSHELL_DATA_TYPE_STRING;
+                                psCommand->eDataType = uSHELL_DATA_TYPE_STRING;
                             }
                         }
                         break;
 #endif /*defined(uSHELL_IMPLEMENTS_STRINGS)*/
 #if defined(uSHELL_IMPLEMENTS_BOOLEAN)
                     case 'o': { /* b[o]ol <==> bool */
-                            if(m_sCommand.iNrBools < uSHELL_MAX_PARAMS_BOOLEAN) {
+                            if(psCommand->iNrBools < uSHELL_MAX_PARAMS_BOOLEAN) {
                                 BIGNUM_T numVal = 0;
                                 if(false == asc2int(pstrToken, &numVal)) {
                                     iRetVal = uSHELL_ERR_INVALID_NUMBER;
@@ -333,7 +773,7 @@ int Microshell::m_CoreParseCommand(void)
                                     if(numVal > uSHELL_MAX_VALUE_BOOLEAN) {
                                         iRetVal = uSHELL_ERR_VALUE_TOO_BIG;
                                     } else {
-                                        m_sCommand.vo[m_sCommand.iNrBools++] = (bool)numVal;
+                                        psCommand->vo[psCommand->iNrBools++] = (bool)numVal;
                                         ++iNrParamsRead;
                                     }
                                 }
@@ -341,14 +781,14 @@ int Microshell::m_CoreParseCommand(void)
                                 iRetVal = uSHELL_ERR_TOO_MANY_ARGS;
                             }
                             if(uSHELL_ERR_OK != iRetVal) {
-                                m_sCommand.eDataType = uSHELL_DATA_TYPE_BOOL;
+                                psCommand->eDataType = uSHELL_DATA_TYPE_BOOL;
                             }
                         }
                         break;
 #endif /*defined(uSHELL_IMPLEMENTS_BOOLEAN)*/
                     //default: {
                     default: { /* unsuported type or more params than defined */
-                            if(m_sCommand.iTypIndex != iNrParamsExpected) {
+                            if(psCommand->iTypIndex != iNrParamsExpected) {
                                 iRetVal = uSHELL_ERR_WRONG_NUMBER_ARGS;
                             } else {
                                 iRetVal = uSHELL_ERR_PARAM_TYPE_NOT_IMPLEM;
@@ -359,15 +799,15 @@ int Microshell::m_CoreParseCommand(void)
 #if defined(uSHELL_IMPLEMENTS_STRINGS)
 #if (1 == uSHELL_SUPPORTS_SPACED_STRINGS)
                 if(uSHELL_ERR_OK == iRetVal) {
-                    iRetVal = m_CoreHandleBorderedStrings(&pstrToken, &pstrRest, &iNrParamsRead);
+                    iRetVal = m_CoreHandleBorderedStrings(psCommand, &pstrToken, &pstrRest, &iNrParamsRead);
                 }
 #endif /* (1 == uSHELL_SUPPORTS_SPACED_STRINGS) */
 #endif /* defined(uSHELL_IMPLEMENTS_STRINGS) */
             } /* while(...) */
             if(uSHELL_ERR_OK != iRetVal) {
-                m_sCommand.iErrorInfo = m_sCommand.iTypIndex - 1;
+                psCommand->iErrorInfo = psCommand->iTypIndex - 1;
             } else {
-                if(m_sCommand.iTypIndex != iNrParamsExpected) {
+                if(psCommand->iTypIndex != iNrParamsExpected) {
                     iRetVal = uSHELL_ERR_WRONG_NUMBER_ARGS;
                 }
             }
@@ -388,7 +828,7 @@ void  Microshell::m_CorePrintError(const int iError)
 {
     static const char *pstrErrorUnknown = "?";
     static const char *pstrErrorCaption = ": ";
-    static const char *pstrErrorString = nullptr;
+    const char *pstrErrorString = nullptr;
     bool bIsTooManyArgsError = false;
     bool bIsInvalidNumError = false;
     bool bIsNumBigValueError = false;
@@ -402,6 +842,7 @@ void  Microshell::m_CorePrintError(const int iError)
         case uSHELL_ERR_TOO_MANY_ARGS            : { bIsTooManyArgsError = true;} break;
         case uSHELL_ERR_INVALID_NUMBER           : { bIsInvalidNumError  = true;} break;
         case uSHELL_ERR_VALUE_TOO_BIG            : { bIsNumBigValueError = true;} break;
+        case uSHELL_ERR_NO_MEMORY                : { pstrErrorString = "out of memory";}                     break;
         default                                  : { pstrErrorString = pstrErrorUnknown;} break;
     }
     if((true == bIsInvalidNumError) || (true == bIsTooManyArgsError) || (true == bIsNumBigValueError)) {
@@ -420,7 +861,7 @@ void  Microshell::m_CorePrintError(const int iError)
 #if defined(uSHELL_IMPLEMENTS_STRINGS)
 #if (1 == uSHELL_SUPPORTS_SPACED_STRINGS)
 /*----------------------------------------------------------------------------*/
-int Microshell::m_CoreHandleBorderedStrings(char **ppstrToken, char **ppstrRest, int *pIntArgCounter)
+int Microshell::m_CoreHandleBorderedStrings(command_s *psCommand, char **ppstrToken, char **ppstrRest, int *pIntArgCounter)
 {
     int  iRetVal = uSHELL_ERR_OK;
     bool bFound  = false;
@@ -440,9 +881,9 @@ int Microshell::m_CoreHandleBorderedStrings(char **ppstrToken, char **ppstrRest,
             bFound = false;
             **ppstrRest = '\0';
             while(*m_pstrTokenSeparator == *(++(*ppstrRest)));   /* cleanup the trailing separators */
-            if('s' == m_pInst->psFuncDefArray[m_sCommand.iFctIndex].pstrFuncParamDef[(m_sCommand.iTypIndex)++]) {
-                if(m_sCommand.iNrStrings < uSHELL_MAX_PARAMS_STRING) {
-                    m_sCommand.vs[m_sCommand.iNrStrings++] = *ppstrToken;
+            if('s' == m_pInst->psFuncDefArray[psCommand->iFctIndex].pstrFuncParamDef[(psCommand->iTypIndex)++]) {
+                if(psCommand->iNrStrings < uSHELL_MAX_PARAMS_STRING) {
+                    psCommand->vs[psCommand->iNrStrings++] = *ppstrToken;
                     ++(*pIntArgCounter);
                 } else {
                     iRetVal = uSHELL_ERR_TOO_MANY_ARGS;
@@ -455,7 +896,7 @@ int Microshell::m_CoreHandleBorderedStrings(char **ppstrToken, char **ppstrRest,
         }
     }
     if(uSHELL_ERR_OK != iRetVal) {
-        m_sCommand.eDataType = uSHELL_DATA_TYPE_STRING;
+        psCommand->eDataType = uSHELL_DATA_TYPE_STRING;
     }
     return iRetVal;
 } /* m_CoreHandleBorderedStrings() */
@@ -470,7 +911,7 @@ void Microshell::m_CoreSetStringBorder(const char *pstrStringBorder)
     } else {
         m_cStringBorderSymbol = (0 == iLen) ? uSHELL_KEY_QUOTATION_MARK : *pstrStringBorder;
 #if (1 == uSHELL_IMPLEMENTS_SMART_PROMPT)
-        m_pInst->vstrPrompt[uSHELL_PROMPTI_LAST] = m_cStringBorderSymbol;
+        m_vstrPrompt[uSHELL_PROMPTI_LAST] = m_cStringBorderSymbol;
 #endif /*(1 == uSHELL_IMPLEMENTS_SMART_PROMPT)*/
     }
 } /* m_CoreSetStringBorder() */
@@ -516,7 +957,7 @@ inline void Microshell::m_CoreRemoveTrailingSpaces(void)
 void Microshell::m_CoreCmdLineDelete(void)
 {
     m_CoreResetInput(false);
-    uSHELL_PRINTF("\r\033[%dC\033[K", m_pInst->iPromptLength);
+    uSHELL_PRINTF("\r\033[%dC\033[K", m_iPromptLength);
 #if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
     m_AutocomplReset(uSHELL_AUTOCOMPL_RELOAD);
 #endif /* (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE) */
@@ -527,7 +968,7 @@ void Microshell::m_CoreCmdLineDelete(void)
 #if (1 == uSHELL_IMPLEMENTS_SMART_PROMPT)
 inline void Microshell::m_CoreUpdatePrompt(const prompti_e ePromptIndex, const bool bOnOff)
 {
-    m_pInst->vstrPrompt[ePromptIndex] = ((true == bOnOff) ? m_pstrPromptInfo[ePromptIndex] : tolower(m_pstrPromptInfo[ePromptIndex]));
+    m_vstrPrompt[ePromptIndex] = ((true == bOnOff) ? m_pstrPromptInfo[ePromptIndex] : tolower(m_pstrPromptInfo[ePromptIndex]));
 }/* m_CoreUpdatePrompt() */
 #endif /*(1 == uSHELL_IMPLEMENTS_SMART_PROMPT)*/
 
@@ -544,6 +985,16 @@ void Microshell::m_CoreProcessKeyPress(const char cKeyPressed)
         m_sAutocomplete.cCrtKey = cKeyPressed;
     }
 #endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)*/
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_SUGGEST)
+    /* the suggestion lives only while typing, the escape sequences decide for themselves (right arrow accepts it) */
+    if((false == uSHELL_ISPRINT(cKeyPressed)) && (uSHELL_KEY_ESCAPESEQ != cKeyPressed)
+#if (defined(__MINGW32__) || defined(_MSC_VER))
+        && (uSHELL_KEY_ESCAPESEQ1 != cKeyPressed)
+#endif /*(defined(__MINGW32__) || defined(_MSC_VER)) */
+      ) {
+        m_HistorySuggestHide();
+    }
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY_SUGGEST)*/
     switch(cKeyPressed) {
         case uSHELL_KEY_ENTER: {
                 m_CoreHandleKeyEnter();
@@ -557,7 +1008,11 @@ void Microshell::m_CoreProcessKeyPress(const char cKeyPressed)
         case uSHELL_KEY_ESCAPESEQ1:  /* fall through (needed for _MSC_VER for INS/DEL on numeric pad*/
 #endif /*(defined(__MINGW32__) || defined(_MSC_VER)) */
         case uSHELL_KEY_ESCAPESEQ: {
-                m_CoreHandleKeyEscapeSeq();
+#if (defined(__MINGW32__) || defined(_MSC_VER))
+                m_eInputState = uSHELL_INPUT_ESC_KEY;   /* no bracket in the console sequences */
+#else
+                m_eInputState = uSHELL_INPUT_ESC;
+#endif /*(defined(__MINGW32__) || defined(_MSC_VER)) */
             }
             break;
 #if ( defined(SERIAL_TERMINAL) && !defined(__AVR__) )
@@ -608,6 +1063,11 @@ void Microshell::m_CoreProcessKeyPress(const char cKeyPressed)
         m_sAutocomplete.cPrevKey = cKeyPressed;
     }
 #endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)*/
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_SUGGEST)
+    if((true == uSHELL_ISPRINT(cKeyPressed)) || (uSHELL_KEY_BACKSPACE == cKeyPressed)) {
+        m_HistorySuggestShow();
+    }
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY_SUGGEST)*/
     m_CorePutString("\033[?25h"); /* show cursor */
 
 } /* m_CoreProcessKeyPress() */
@@ -631,6 +1091,9 @@ void Microshell::m_CoreHandleKeyEnter(void)
     m_CoreRemoveTrailingSpaces();
     if(m_iInputPos >= 0) {
         m_CorePutString(uSHELL_NEWLINE);
+#if (1 == uSHELL_IMPLEMENTS_JOBS)
+        m_JobsReport();     /* also frees the slots of the finished jobs */
+#endif /*(1 == uSHELL_IMPLEMENTS_JOBS)*/
         if(m_iInputPos > 0) {
             m_CoreExecuteEnterKey();
             m_CoreResetInput(true);
@@ -641,13 +1104,19 @@ void Microshell::m_CoreHandleKeyEnter(void)
 #endif /* (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE) */
         }
     }
+#if (1 == uSHELL_IMPLEMENTS_JOBS)
+    m_JobsReport();
+#endif /*(1 == uSHELL_IMPLEMENTS_JOBS)*/
+    /* a confirmation, the key decoder or a coroutine prints the prompt when done */
+    if(uSHELL_INPUT_KEY == m_eInputState) {
 #if (1 == uSHELL_IMPLEMENTS_DISABLE_ECHO)
-    if(true == m_bEchoOn) {
-        m_CorePrintPrompt();
-    }
+        if(true == m_bEchoOn) {
+            m_CorePrintPrompt();
+        }
 #else
-    m_CorePrintPrompt();
+        m_CorePrintPrompt();
 #endif /* (1 == uSHELL_IMPLEMENTS_DISABLE_ECHO) */
+    }
 } /* m_CoreHandleKeyEnter() */
 
 
@@ -658,6 +1127,9 @@ void Microshell::m_CoreHandleKeyDefault(const char cKeyPressed)
 #if (1 == uSHELL_IMPLEMENTS_EDITMODE)
         if((true == m_bEditMode) && (m_iCursorPos < m_iInputPos)) {
             m_EditInsertUnderCursor(cKeyPressed);
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+            m_AutocomplReInit();    /* the prefix changed, filter it again from scratch */
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)*/
         } else {
 #endif /* (1 == uSHELL_IMPLEMENTS_EDITMODE) */
             if(m_iInputPos < (int)(sizeof(m_pstrInput) - 1)) {
@@ -690,106 +1162,98 @@ void Microshell::m_CoreHandleKeyDefault(const char cKeyPressed)
 
 
 /*----------------------------------------------------------------------------*/
-void Microshell::m_CoreHandleKeyEscapeSeq(void)
+void Microshell::m_CoreHandleKeyEscapeSeq(const char cSeqKey)
 {
-    if(SKIP_BRACKET) {   /* skip the [ */
-        switch(uSHELL_GETCH()) {  /* get the ecape sequence */
+    /* complete sequence, the bracket and the tilde were checked by m_CoreStep() */
+    m_CorePutString("\033[?25l"); /* hide cursor */
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_SUGGEST)
+    if(uSHELL_KEY_ESCAPESEQ_ARROW_RIGHT != cSeqKey) {
+        m_HistorySuggestHide();
+    }
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY_SUGGEST)*/
+    switch(cSeqKey) {
 #if (1 == uSHELL_IMPLEMENTS_EDITMODE) || (1 == uSHELL_IMPLEMENTS_HISTORY)
-            case uSHELL_KEY_ESCAPESEQ_ARROW_UP    : {
-                    m_CoreHandleKeyArrowUpDown(uSHELL_DIR_FORWARD);
-                }
-                break;
-            case uSHELL_KEY_ESCAPESEQ_ARROW_DOWN  : {
-                    m_CoreHandleKeyArrowUpDown(uSHELL_DIR_BACKWARD);
-                }
-                break;
+        case uSHELL_KEY_ESCAPESEQ_ARROW_UP    : {
+                m_CoreHandleKeyArrowUpDown(uSHELL_DIR_FORWARD);
+            }
+            break;
+        case uSHELL_KEY_ESCAPESEQ_ARROW_DOWN  : {
+                m_CoreHandleKeyArrowUpDown(uSHELL_DIR_BACKWARD);
+            }
+            break;
 #endif /*(1 == uSHELL_IMPLEMENTS_EDITMODE) || (1 == uSHELL_IMPLEMENTS_HISTORY) */
 #if (1 == uSHELL_IMPLEMENTS_EDITMODE) || (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
-            case uSHELL_KEY_ESCAPESEQ_ARROW_LEFT  : {
-                    m_CoreHandleKeyArrowLeftRight(uSHELL_DIR_BACKWARD);
-                }
-                break;
-            case uSHELL_KEY_ESCAPESEQ_ARROW_RIGHT : {
-                    m_CoreHandleKeyArrowLeftRight(uSHELL_DIR_FORWARD);
-                }
-                break;
+        case uSHELL_KEY_ESCAPESEQ_ARROW_LEFT  : {
+                m_CoreHandleKeyArrowLeftRight(uSHELL_DIR_BACKWARD);
+            }
+            break;
+        case uSHELL_KEY_ESCAPESEQ_ARROW_RIGHT : {
+                m_CoreHandleKeyArrowLeftRight(uSHELL_DIR_FORWARD);
+            }
+            break;
 #endif /*(1 == uSHELL_IMPLEMENTS_EDITMODE) || defined(uSHELL_IMPLEMENTS_AUTOCOMPLETE) */
-            case uSHELL_KEY_ESCAPESEQ1_DELETE     : {
-                    if(SKIP_TILDE) {
-                        m_CoreHandleKeyDelete();
-                    }
-                }
-                break;
+        case uSHELL_KEY_ESCAPESEQ1_DELETE     : {
+                m_CoreHandleKeyDelete();
+            }
+            break;
 #if (1 == uSHELL_IMPLEMENTS_EDITMODE)
 #if !(defined(__MINGW32__) || defined(_MSC_VER))
-            case uSHELL_KEY_ESCAPESEQ_HOME        : {
-                    m_EditMoveCursor(uSHELL_DIR_HOME);
-                }
-                break;
-            case uSHELL_KEY_ESCAPESEQ_END         : {
-                    m_EditMoveCursor(uSHELL_DIR_END);
-                }
-                break;
+        case uSHELL_KEY_ESCAPESEQ_HOME        : {
+                m_EditMoveCursor(uSHELL_DIR_HOME);
+            }
+            break;
+        case uSHELL_KEY_ESCAPESEQ_END         : {
+                m_EditMoveCursor(uSHELL_DIR_END);
+            }
+            break;
 #endif /*!(defined(__MINGW32__) || defined(_MSC_VER))*/
-            case uSHELL_KEY_ESCAPESEQ1_HOME       : {
-                    if(SKIP_TILDE) {
-                        m_EditMoveCursor(uSHELL_DIR_HOME);
-                    }
-                }
-                break;
-            case uSHELL_KEY_ESCAPESEQ1_END        : {
-                    if(SKIP_TILDE) {
-                        m_EditMoveCursor(uSHELL_DIR_END);
-                    }
-                }
-                break;
+        case uSHELL_KEY_ESCAPESEQ1_HOME       : {
+                m_EditMoveCursor(uSHELL_DIR_HOME);
+            }
+            break;
+        case uSHELL_KEY_ESCAPESEQ1_END        : {
+                m_EditMoveCursor(uSHELL_DIR_END);
+            }
+            break;
 #if !defined(uSHELL_EDIT_MODE_DEFAULT_ACTIVE)
-            case uSHELL_KEY_ESCAPESEQ1_INSERT     : {
-                    if(SKIP_TILDE) {
-                        m_CoreHandleKeyInsert();
-                    }
-                }
-                break;
+        case uSHELL_KEY_ESCAPESEQ1_INSERT     : {
+                m_CoreHandleKeyInsert();
+            }
+            break;
 #else
-            case uSHELL_KEY_ESCAPESEQ1_INSERT     : {
-                    if(SKIP_TILDE) {/*ignore*/}
-                } break;
+        case uSHELL_KEY_ESCAPESEQ1_INSERT     :
+            break; /*ignore */
 #endif /*!defined(uSHELL_EDIT_MODE_DEFAULT_ACTIVE)*/
 #if !(defined(__MINGW32__) || defined(_MSC_VER))
-            case uSHELL_KEY_TILDE                 : {
-                    m_CoreHandleKeyDelete();
-                }
-                break; /*1B5B7E for INS DEL, etc is DEL */
+        case uSHELL_KEY_TILDE                 : {
+                m_CoreHandleKeyDelete();
+            }
+            break; /*1B5B7E for INS DEL, etc is DEL */
 #endif /*!(defined(__MINGW32__) || defined(_MSC_VER))*/
 #else /* not (1 == uSHELL_IMPLEMENTS_EDITMODE), disable keys */
-            case uSHELL_KEY_ESCAPESEQ_HOME        :
-                break; /* disabled */
-            case uSHELL_KEY_ESCAPESEQ_END         :
-                break; /* disabled */
-            case uSHELL_KEY_ESCAPESEQ1_HOME       : {
-                    if(SKIP_TILDE) {}
-                } break; /* disabled */
-            case uSHELL_KEY_ESCAPESEQ1_END        : {
-                    if(SKIP_TILDE) {}
-                } break; /* disabled */
-            case uSHELL_KEY_ESCAPESEQ1_INSERT     : {
-                    if(SKIP_TILDE) {}
-                } break; /* disabled */
+        case uSHELL_KEY_ESCAPESEQ_HOME        :
+            break; /* disabled */
+        case uSHELL_KEY_ESCAPESEQ_END         :
+            break; /* disabled */
+        case uSHELL_KEY_ESCAPESEQ1_HOME       :
+            break; /* disabled */
+        case uSHELL_KEY_ESCAPESEQ1_END        :
+            break; /* disabled */
+        case uSHELL_KEY_ESCAPESEQ1_INSERT     :
+            break; /* disabled */
 #if !(defined(__MINGW32__) || defined(_MSC_VER))
-            case uSHELL_KEY_TILDE                 :
-                break; /* disabled */
+        case uSHELL_KEY_TILDE                 :
+            break; /* disabled */
 #endif /*!(defined(__MINGW32__) || defined(_MSC_VER))*/
 #endif /* (1 == uSHELL_IMPLEMENTS_EDITMODE) */
-            case uSHELL_KEY_ESCAPESEQ1_PAGEUP     : {
-                    if(SKIP_TILDE) {}
-                } break; /* disabled */
-            case uSHELL_KEY_ESCAPESEQ1_PAGEDOWN   : {
-                    if(SKIP_TILDE) {}
-                } break; /* disabled */
-            default:
-                break;
-        } /* switch(uSHELL_GETCH()) */
-    } /* SKIP_BRACKET */
+        case uSHELL_KEY_ESCAPESEQ1_PAGEUP     :
+            break; /* disabled */
+        case uSHELL_KEY_ESCAPESEQ1_PAGEDOWN   :
+            break; /* disabled */
+        default:
+            break;
+    } /* switch(cSeqKey) */
+    m_CorePutString("\033[?25h"); /* show cursor */
 } /* m_CoreHandleKeyEscapeSeq() */
 
 
@@ -829,6 +1293,11 @@ void Microshell::m_CoreHandleKeyArrowUpDown(const dir_e eDir)
 #if (1 == uSHELL_IMPLEMENTS_EDITMODE) || (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
 void Microshell::m_CoreHandleKeyArrowLeftRight(const dir_e eDir)
 {
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_SUGGEST)
+    if((uSHELL_DIR_FORWARD == eDir) && (true == m_HistorySuggestAccept())) {
+        return;
+    }
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY_SUGGEST)*/
 #if (1 == uSHELL_IMPLEMENTS_EDITMODE)
     if(false == m_EditMoveCursor(eDir)) {
 #if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
@@ -855,9 +1324,9 @@ void Microshell::m_CoreHandleKeyInsert(void)
     m_bEditMode = !m_bEditMode;
     if(m_iInputPos > 0) {
 #if (1 == uSHELL_IMPLEMENTS_SMART_PROMPT)
-        uSHELL_PRINTF(FRMT(uSHELL_PROMPT_COLOR, "\r%s\033[%dC"), (m_bEditMode ? m_pstrPromptInfoEditMode : m_pInst->vstrPrompt), m_iInputPos + (m_bEditMode ? (m_pInst->iPromptLength - ((int)(sizeof(m_pstrPromptInfo))) + 1) : 0));
+        uSHELL_PRINTF(FRMT(uSHELL_PROMPT_COLOR, "\r%s\033[%dC"), (m_bEditMode ? m_pstrPromptInfoEditMode : m_vstrPrompt), m_iInputPos + (m_bEditMode ? (m_iPromptLength - ((int)(sizeof(m_pstrPromptInfo))) + 1) : 0));
 #else /* (0 == uSHELL_IMPLEMENTS_SMART_PROMPT) */
-        uSHELL_PRINTF(FRMT(uSHELL_PROMPT_COLOR, "\r%c\033[%dC"), (m_bEditMode ? 'E' : m_pInst->vstrPrompt[0]), (m_iInputPos + (m_pInst->iPromptLength - 1)));
+        uSHELL_PRINTF(FRMT(uSHELL_PROMPT_COLOR, "\r%c\033[%dC"), (m_bEditMode ? 'E' : m_vstrPrompt[0]), (m_iInputPos + (m_iPromptLength - 1)));
 #endif /* (1 == uSHELL_IMPLEMENTS_SMART_PROMPT) */
         if(true == m_bEditMode) {
             m_iCursorPos = m_iInputPos;
@@ -916,15 +1385,19 @@ bool Microshell::m_CoreHandleShortcuts(void)
 {
     bool bRetVal = false;
     char cKey = *m_pstrInput;
-    for(int i = 0; i < m_pInst->iNrShortcuts; ++i) {
+    char *pstrArgs = m_pstrInput;
+    while(uSHELL_KEY_SPACE == *(++pstrArgs));
+
+    /* the core shortcut is handled by the instance, slot 0 of the shared table stays reserved */
+    if('#' == cKey) {
+        m_CoreHandleShortcut_Hash(pstrArgs);
+        bRetVal = true;
+    }
+    for(int i = 1; (false == bRetVal) && (i < m_pInst->iNrShortcuts); ++i) {
         if(cKey == m_pInst->psShortcutsArray[i].cSymbol) {
             if(nullptr != m_pInst->psShortcutsArray[i].pfShortcut) {
-                char *pstrArgs = m_pstrInput;
-                while(uSHELL_KEY_SPACE == *(++pstrArgs));
 #if (1 == uSHELL_IMPLEMENTS_HISTORY)
-                if(i > 0) {
-                    m_HistoryWrite();
-                }
+                m_HistoryWrite();
 #endif /*(1 == uSHELL_IMPLEMENTS_HISTORY) */
                 m_pInst->psShortcutsArray[i].pfShortcut(pstrArgs);
             } else {
@@ -951,9 +1424,7 @@ void Microshell::m_CoreHandleShortcut_Hash(const char *pstrArgs)
     const char cKey = *pstrArgs;
 
     if('\0' != cKey) {
-#if ((0 == uSHELL_IMPLEMENTS_COMMAND_HELP) || (1 == uSHELL_IMPLEMENTS_SHELL_EXIT) || (1 == uSHELL_IMPLEMENTS_KEY_DECODER) || (1 == uSHELL_IMPLEMENTS_DISABLE_ECHO) || (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE) || (1 == uSHELL_IMPLEMENTS_HISTORY))
         bool bNoParams = ('\0' == *(pstrArgs + 1));
-#endif /*((0 == uSHELL_IMPLEMENTS_COMMAND_HELP) || (1 == uSHELL_IMPLEMENTS_SHELL_EXIT) || (1 == uSHELL_IMPLEMENTS_KEY_DECODER) || (1 == uSHELL_IMPLEMENTS_DISABLE_ECHO) || (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE) || (1 == uSHELL_IMPLEMENTS_HISTORY)) */
         switch(cKey) {
 #if (1 == uSHELL_IMPLEMENTS_COMMAND_HELP) /* full info */
             case '#': {
@@ -982,19 +1453,95 @@ void Microshell::m_CoreHandleShortcut_Hash(const char *pstrArgs)
                 }
                 break; /* list commands */
 #endif /*(1 == uSHELL_IMPLEMENTS_COMMAND_HELP) */
-#if (1 == uSHELL_IMPLEMENTS_SHELL_EXIT)
-            case 'q': {
+            case 'm': {
                     if(bNoParams) {
-                        m_CoreExit();
+                        m_CoreShowRamUsage();
                         iError = 0;
                     }
                 }
-                break; /* exit shell */
-#endif /*(1 == uSHELL_IMPLEMENTS_SHELL_EXIT) */
-#if (1 == uSHELL_IMPLEMENTS_KEY_DECODER)
+                break; /* RAM used by this instance */
+#if (1 == uSHELL_IMPLEMENTS_JOBS)
+            case 'j': {
+                    if(bNoParams) {
+                        m_JobsList();
+                        iError = 0;
+                    }
+                }
+                break; /* list jobs */
+            case 'w': {
+                    m_JobsWait(pstrArgs + 1);
+                    iError = 0;
+                }
+                break; /* wait for a job or all */
+            case 'c': {
+                    m_JobsCancel(pstrArgs + 1);
+                    iError = 0;
+                }
+                break; /* cancel a job */
+#endif /*(1 == uSHELL_IMPLEMENTS_JOBS)*/
+#if ((1 == uSHELL_IMPLEMENTS_EXEC_STATS) || (1 == uSHELL_IMPLEMENTS_KEY_LATENCY))
+            case 't': {
+                    m_StatsShow(pstrArgs + 1);
+                    iError = 0;
+                }
+                break; /* execution timing and key latency statistics */
+#endif /*((1 == uSHELL_IMPLEMENTS_EXEC_STATS) || (1 == uSHELL_IMPLEMENTS_KEY_LATENCY))*/
+#if (1 == uSHELL_IMPLEMENTS_BENCH)
+            case 'b': {
+                    m_BenchRun(pstrArgs + 1);
+                    iError = 0;
+                }
+                break; /* command benchmark */
+#endif /*(1 == uSHELL_IMPLEMENTS_BENCH)*/
+#if (1 == uSHELL_IMPLEMENTS_TRACE)
+            case 'x': {
+                    m_TraceShow(pstrArgs + 1);
+                    iError = 0;
+                }
+                break; /* event trace dump */
+#endif /*(1 == uSHELL_IMPLEMENTS_TRACE)*/
+#if (1 == uSHELL_IMPLEMENTS_HEAP_STATS)
+            case 'M': {
+                    m_HeapShow(pstrArgs + 1);
+                    iError = 0;
+                }
+                break; /* heap statistics */
+#endif /*(1 == uSHELL_IMPLEMENTS_HEAP_STATS)*/
+#if (1 == uSHELL_IMPLEMENTS_STACK_USAGE)
+            case 'S': {
+                    m_StackShow(pstrArgs + 1);
+                    iError = 0;
+                }
+                break; /* stack high-water marks */
+#endif /*(1 == uSHELL_IMPLEMENTS_STACK_USAGE)*/
+#if (1 == uSHELL_IMPLEMENTS_UART_STATS)
+            case 'U': {
+                    m_UartShow(pstrArgs + 1);
+                    iError = 0;
+                }
+                break; /* UART counters */
+#endif /*(1 == uSHELL_IMPLEMENTS_UART_STATS)*/
+#if (1 == uSHELL_IMPLEMENTS_UART_CONFIG)
+            case 'B': {
+                    m_UartBaud(pstrArgs + 1);
+                    iError = 0;
+                }
+                break; /* UART rate and format */
+#endif /*(1 == uSHELL_IMPLEMENTS_UART_CONFIG)*/
+#if (1 == uSHELL_IMPLEMENTS_SHELL_EXIT)
+            case 'q': {
+                    if(bNoParams) {
+                        m_CoreExit();
+                        iError = 0;
+                    }
+                }
+                break; /* exit shell */
+#endif /*(1 == uSHELL_IMPLEMENTS_SHELL_EXIT) */
+#if (1 == uSHELL_IMPLEMENTS_KEY_DECODER)
             case 'k': {
                     if(bNoParams) {
-                        keydecoder();
+                        m_CorePutString(":exit:$\n\r");
+                        m_eInputState = uSHELL_INPUT_KEYDECODER;
                         iError = 0;
                     }
                 }
@@ -1132,14 +1679,14 @@ inline void Microshell::m_CoreSetPrompt(const char *pstrPromptExt)
 {
 #if (1 == uSHELL_IMPLEMENTS_SMART_PROMPT)
 #if (defined(uSHELL_IMPLEMENTS_STRINGS) && (1 == uSHELL_SUPPORTS_SPACED_STRINGS))
-    uSHELL_SNPRINTF(m_pInst->vstrPrompt, sizeof(m_pInst->vstrPrompt), "%s%c:%s> ", m_pstrPrompt, m_cStringBorderSymbol, pstrPromptExt);
+    uSHELL_SNPRINTF(m_vstrPrompt, sizeof(m_vstrPrompt), "%s%c:%s> ", m_pstrPrompt, m_cStringBorderSymbol, pstrPromptExt);
 #else
-    uSHELL_SNPRINTF(m_pInst->vstrPrompt, sizeof(m_pInst->vstrPrompt), "%s:%s> ", m_pstrPrompt, pstrPromptExt);
+    uSHELL_SNPRINTF(m_vstrPrompt, sizeof(m_vstrPrompt), "%s:%s> ", m_pstrPrompt, pstrPromptExt);
 #endif
 #else
-    uSHELL_SNPRINTF(m_pInst->vstrPrompt, sizeof(m_pInst->vstrPrompt), "e:%s> ", pstrPromptExt);
+    uSHELL_SNPRINTF(m_vstrPrompt, sizeof(m_vstrPrompt), "e:%s> ", pstrPromptExt);
 #endif /* (1 == uSHELL_IMPLEMENTS_SMART_PROMPT) */
-    m_pInst->iPromptLength = (int)strlen(m_pInst->vstrPrompt);
+    m_iPromptLength = (int)strlen(m_vstrPrompt);
 }
 
 /*==============================================================================
@@ -1149,24 +1696,44 @@ inline void Microshell::m_CoreSetPrompt(const char *pstrPromptExt)
 
 /*----------------------------------------------------------------------------*/
 #if (1 == uSHELL_IMPLEMENTS_CONFIRM_REQUEST)
-bool Microshell::m_CoreConfirmRequest(void)
+void Microshell::m_CoreConfirmRequest(const confirm_e eAction)
 {
-    bool bConfirmed = false;
+    /* the answer comes with the next bytes, the action is executed by m_CoreConfirmAnswer() */
     m_CorePutString("Are you sure? (y/n): ");
-    do {
-        char cRead = uSHELL_GETCH();
-        if('y' == cRead) {
-            uSHELL_PUTCH(cRead);
-            bConfirmed = true;
-            break;
-        } else if('n' == cRead) {
-            uSHELL_PUTCH(cRead);
-            break;
-        }
-    } while(1);
-    m_CorePutString(uSHELL_NEWLINE);
-    return bConfirmed;
+    m_eConfirmAction = eAction;
+    m_eInputState = uSHELL_INPUT_CONFIRM;
 }/* m_CoreConfirmRequest() */
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_CoreConfirmAnswer(const char cAnswer)
+{
+    if(('y' == cAnswer) || ('n' == cAnswer)) {
+        uSHELL_PUTCH(cAnswer);
+        m_CorePutString(uSHELL_NEWLINE);
+        m_eInputState = uSHELL_INPUT_KEY;
+        if('y' == cAnswer) {
+            switch(m_eConfirmAction) {
+#if (1 == uSHELL_IMPLEMENTS_SHELL_EXIT)
+                case uSHELL_CONFIRM_EXIT: {
+                        m_bKeepRunning = false;
+                    }
+                    break;
+#endif /*(1 == uSHELL_IMPLEMENTS_SHELL_EXIT)*/
+#if (1 == uSHELL_IMPLEMENTS_HISTORY)
+                case uSHELL_CONFIRM_HISTORY_RESET: {
+                        m_CircBufDeinit(uSHELL_DEINIT_RESET);
+                        m_CorePrintMessage(3, 6); /* history reset */
+                    }
+                    break;
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY)*/
+                default:
+                    break;
+            }
+        }
+        m_CorePrintPrompt();
+    }
+}/* m_CoreConfirmAnswer() */
 #endif /*(1 == uSHELL_IMPLEMENTS_CONFIRM_REQUEST)*/
 
 
@@ -1175,11 +1742,9 @@ bool Microshell::m_CoreConfirmRequest(void)
 inline void Microshell::m_CoreExit(void)
 {
 #if (1 == uSHELL_IMPLEMENTS_CONFIRM_REQUEST)
-    if(true == m_CoreConfirmRequest()) {
-#endif /* (1 == uSHELL_IMPLEMENTS_CONFIRM_REQUEST)*/
-        m_pInst->bKeepRuning = false;
-#if (1 == uSHELL_IMPLEMENTS_CONFIRM_REQUEST)
-    }
+    m_CoreConfirmRequest(uSHELL_CONFIRM_EXIT);
+#else
+    m_bKeepRunning = false;
 #endif /*(1 == uSHELL_IMPLEMENTS_CONFIRM_REQUEST)*/
 } /* m_CoreExit() */
 #endif /*(1 == uSHELL_IMPLEMENTS_SHELL_EXIT)*/
@@ -1328,9 +1893,9 @@ void Microshell::m_CoreShowCmdsList(void)
 /*----------------------------------------------------------------------------*/
 void Microshell::m_CorePrintMessage(const int iFeatIdx, const int iStatIdx)
 {
-    /*       index:                         0      1               2                 3          4           5           6               7                8              9           10         11              */
-    static const char *pstrFeatArray[] = { "",    "autocomplete", "echo",            "history", "callback", "shortcut", "sub-shortcut", "malloc",        "args",        "command"   "fopen"                    };
-    static const char *pstrStatArray[] = { "off", "on",           "not implemented", "noentry", "failed",   "empty",    "reset",        "uninitialized", "unsupported", "missing",  "nofile", "not registered" };
+    /*       index:                         0      1               2                 3          4           5           6               7                8              9           10         11                12            13       14      15       16 */
+    static const char *pstrFeatArray[] = { "",    "autocomplete", "echo",            "history", "callback", "shortcut", "sub-shortcut", "malloc",        "args",        "command",  "fopen",  "job",            "stats",      "trace", "heap", "stack", "uart" };
+    static const char *pstrStatArray[] = { "off", "on",           "not implemented", "noentry", "failed",   "empty",    "reset",        "uninitialized", "unsupported", "missing",  "nofile", "not registered", "table full" };
     uSHELL_PRINTF(FRMT(uSHELL_WARNING_COLOR, ": %s %s\n"), pstrFeatArray[iFeatIdx], pstrStatArray[iStatIdx]);
 }/* m_CorePrintMessage() */
 
@@ -1339,10 +1904,132 @@ void Microshell::m_CorePrintMessage(const int iFeatIdx, const int iStatIdx)
 /*----------------------------------------------------------------------------*/
 inline void Microshell::m_CorePrintPrompt(void)
 {
-    uSHELL_PRINTF(FRMT(uSHELL_PROMPT_COLOR, "%s"), m_pInst->vstrPrompt);
+    uSHELL_PRINTF(FRMT(uSHELL_PROMPT_COLOR, "%s"), m_vstrPrompt);
 }/*m_CorePrintPrompt() */
 
 
+/*----------------------------------------------------------------------------*/
+void Microshell::m_CoreShowRamUsage(void)
+{
+    uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR, "instance    : %d bytes\n"), (int)sizeof(Microshell));
+    uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR, "  input     : %d\n"), (int)(sizeof(m_pstrInput) + sizeof(m_sCommand)));
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+    uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR, "  autocompl : %d\n"), (int)sizeof(m_sAutocomplete));
+#endif /* (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE) */
+#if (1 == uSHELL_IMPLEMENTS_TRACE)
+    uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR, "  trace     : %d\n"), (int)sizeof(m_vsTrace));
+#endif /* (1 == uSHELL_IMPLEMENTS_TRACE) */
+    uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR, "heap        : %d bytes\n"), (int)(RamUsage() - sizeof(Microshell)));
+    uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR, "total       : %d bytes (command table shared)\n"), (int)RamUsage());
+} /* m_CoreShowRamUsage() */
+
+
+#if ((1 == uSHELL_IMPLEMENTS_JOBS) || (1 == uSHELL_IMPLEMENTS_COROUTINES) || (1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS))
+/*----------------------------------------------------------------------------*/
+void Microshell::m_CoreCopyCommand(command_s *psDst, char *pstrDst, const command_s *psSrc, const char *pstrSrc)
+{
+    /* the copy keeps its own line, the parsed strings are moved into it */
+    memcpy(pstrDst, pstrSrc, uSHELL_MAX_INPUT_BUF_LEN);
+    *psDst = *psSrc;
+    psDst->pstrFctName = pstrDst + (psSrc->pstrFctName - pstrSrc);
+#if defined(uSHELL_IMPLEMENTS_STRINGS)
+    for(unsigned int i = 0; i < psSrc->iNrStrings; ++i) {
+        psDst->vs[i] = pstrDst + (psSrc->vs[i] - pstrSrc);
+    }
+#endif /*defined(uSHELL_IMPLEMENTS_STRINGS)*/
+} /* m_CoreCopyCommand() */
+#endif /*((1 == uSHELL_IMPLEMENTS_JOBS) || (1 == uSHELL_IMPLEMENTS_COROUTINES) || (1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS))*/
+
+
+/*==============================================================================
+                            CORE: INSTANCE I/O
+==============================================================================*/
+
+
+/*----------------------------------------------------------------------------*/
+inline int Microshell::m_CoreGetch(void)
+{
+    return m_psIo->pfGetch(m_psIo->pvCtx);
+} /* m_CoreGetch() */
+
+
+/*----------------------------------------------------------------------------*/
+inline int Microshell::m_CoreTryGetch(void)
+{
+    /* without a non-blocking read the input is checked again at the prompt */
+    return (nullptr != m_psIo->pfTryGetch) ? m_psIo->pfTryGetch(m_psIo->pvCtx) : uSHELL_IO_NO_DATA;
+} /* m_CoreTryGetch() */
+
+
+/*----------------------------------------------------------------------------*/
+inline int Microshell::m_CoreTxFree(void)
+{
+    return (nullptr != m_psIo->pfTxFree) ? m_psIo->pfTxFree(m_psIo->pvCtx) : INT_MAX;
+} /* m_CoreTxFree() */
+
+
+/*----------------------------------------------------------------------------*/
+int Microshell::m_CoreRead(char *pcBuf, const int iMaxLen)
+{
+    /* a backend without bulk read gives one byte per call */
+    if(nullptr != m_psIo->pfRead) {
+        return m_psIo->pfRead(m_psIo->pvCtx, pcBuf, iMaxLen);
+    }
+    const int iKey = (iMaxLen > 0) ? m_CoreTryGetch() : uSHELL_IO_NO_DATA;
+    if(uSHELL_IO_NO_DATA == iKey) {
+        return 0;
+    }
+    pcBuf[0] = (char)iKey;
+    return 1;
+} /* m_CoreRead() */
+
+
+/*----------------------------------------------------------------------------*/
+inline void Microshell::m_CorePutch(const char cChar)
+{
+    m_psIo->pfPutch(m_psIo->pvCtx, cChar);
+} /* m_CorePutch() */
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_CoreWrite(const char *pcBuf, const int iLen)
+{
+    if(nullptr != m_psIo->pfWrite) {
+        m_psIo->pfWrite(m_psIo->pvCtx, pcBuf, iLen);
+    } else {
+        for(int i = 0; i < iLen; ++i) {
+            m_psIo->pfPutch(m_psIo->pvCtx, pcBuf[i]);
+        }
+    }
+} /* m_CoreWrite() */
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_CorePrintf(const char *pstrFormat, ...)
+{
+    char vstrBuffer[uSHELL_PRINTF_BUF_LEN];
+    va_list args;
+
+    va_start(args, pstrFormat);
+    int iLen = uSHELL_VSNPRINTF(vstrBuffer, sizeof(vstrBuffer), pstrFormat, args);
+    va_end(args);
+
+    if(iLen >= (int)sizeof(vstrBuffer)) {
+        iLen = (int)sizeof(vstrBuffer) - 1;   /* truncated */
+    }
+    if(iLen > 0) {
+        m_CoreWrite(vstrBuffer, iLen);
+    }
+} /* m_CorePrintf() */
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_CoreSinkWrite(void *pvShell, const char *pcBuf, const int iLen)
+{
+    static_cast<Microshell*>(pvShell)->m_CoreWrite(pcBuf, iLen);
+} /* m_CoreSinkWrite() */
+
+
 /*==============================================================================
                    HISTORY: CIRCULAR BUFFER IMPLEMENTATION
 ==============================================================================*/
@@ -1352,26 +2039,26 @@ inline void Microshell::m_CorePrintPrompt(void)
 /*----------------------------------------------------------------------------*/
 bool Microshell::m_CircBufInit(void)
 {
-    static bool bInit = false;
     bool bRetVal = true;
 
-    if (!bInit) {
+    /* per instance: the buffer exists once allocated */
+    if (nullptr == m_sCircBuf.ppData) {
         const size_t dataSize = uSHELL_HISTORY_DEPTH * sizeof(void*);
         const size_t sizeSize = uSHELL_HISTORY_DEPTH * sizeof(size_t);
 
-        m_sCircBuf.ppData    = static_cast<void**>(malloc(dataSize));
-        m_sCircBuf.pDataSize = static_cast<size_t*>(malloc(sizeSize));
+        m_sCircBuf.ppData    = static_cast<void**>(uSHELL_MALLOC(dataSize, uSHELL_HEAP_HISTORY_RING));
+        m_sCircBuf.pDataSize = static_cast<size_t*>(uSHELL_MALLOC(sizeSize, uSHELL_HEAP_HISTORY_RING));
 
         if ((nullptr == m_sCircBuf.ppData) || (nullptr == m_sCircBuf.pDataSize)) {
             m_CorePrintMessage(7, 4); // malloc failed
 
             if (nullptr != m_sCircBuf.ppData) {
-                free(m_sCircBuf.ppData);
+                uSHELL_FREE(m_sCircBuf.ppData);
                 m_sCircBuf.ppData = nullptr;
             }
 
             if (nullptr != m_sCircBuf.pDataSize) {
-                free(m_sCircBuf.pDataSize);
+                uSHELL_FREE(m_sCircBuf.pDataSize);
                 m_sCircBuf.pDataSize = nullptr;
             }
 
@@ -1379,8 +2066,12 @@ bool Microshell::m_CircBufInit(void)
         } else {
             memset(m_sCircBuf.ppData, 0, dataSize);
             memset(m_sCircBuf.pDataSize, 0, sizeSize);
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_SUGGEST)
+            if(false == m_HistoryIndexInit()) {
+                m_CorePrintMessage(7, 4); // malloc failed, the history works without suggestions
+            }
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY_SUGGEST)*/
             m_CircBufFlagsReset();
-            bInit = true;
         }
     }
 
@@ -1394,21 +2085,26 @@ void Microshell::m_CircBufFreeMem(const bool bFull)
     if(m_sCircBuf.ppData != nullptr) {
         for(unsigned int i = 0; i < uSHELL_HISTORY_DEPTH; ++i) {
             if(m_sCircBuf.ppData[i] != nullptr) {
-                free(m_sCircBuf.ppData[i]);
+                uSHELL_FREE(m_sCircBuf.ppData[i]);
                 m_sCircBuf.ppData[i] = nullptr;
                 m_sCircBuf.pDataSize[i] = 0;
             }
         }
         if(true == bFull) {
-            free(m_sCircBuf.ppData);
+            uSHELL_FREE(m_sCircBuf.ppData);
             m_sCircBuf.ppData = nullptr;
         }
     }
 
     if((true == bFull) && (nullptr != m_sCircBuf.pDataSize)) {
-        free(m_sCircBuf.pDataSize);
+        uSHELL_FREE(m_sCircBuf.pDataSize);
         m_sCircBuf.pDataSize = nullptr;
     }
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_SUGGEST)
+    if(true == bFull) {
+        m_HistoryIndexDeinit();
+    }
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY_SUGGEST)*/
 } /* m_CircBufFreeMem() */
 
 
@@ -1446,11 +2142,11 @@ bool Microshell::m_CircBufWrite(const void *pElem, const size_t szElemSize)
         bool bMemAllocFailed = false;
 
         if (m_sCircBuf.ppData[m_sCircBuf.iCrtPosWrite] == nullptr) {
-            if (nullptr == (pBuf = malloc(szElemSize))) {
+            if (nullptr == (pBuf = uSHELL_MALLOC(szElemSize, uSHELL_HEAP_HISTORY))) {
                 bMemAllocFailed = true;
             }
         } else if (szElemSize > m_sCircBuf.pDataSize[m_sCircBuf.iCrtPosWrite]) {
-            void *pBufTemp = realloc(m_sCircBuf.ppData[m_sCircBuf.iCrtPosWrite], szElemSize);
+            void *pBufTemp = uSHELL_REALLOC(m_sCircBuf.ppData[m_sCircBuf.iCrtPosWrite], szElemSize, uSHELL_HEAP_HISTORY);
             if (nullptr != pBufTemp) {
                 m_sCircBuf.ppData[m_sCircBuf.iCrtPosWrite] = pBufTemp;
                 pBuf = pBufTemp;
@@ -1465,6 +2161,11 @@ bool Microshell::m_CircBufWrite(const void *pElem, const size_t szElemSize)
             m_CorePrintMessage(7, 4); // Memory allocation failed
             bRetVal = false;
         } else {
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_SUGGEST)
+            if (true == m_sCircBuf.bIsFull) {
+                m_HistoryIndexRemove(m_sCircBuf.iCrtPosWrite);   /* the oldest entry is overwritten */
+            }
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY_SUGGEST)*/
             if (szElemSize < m_sCircBuf.pDataSize[m_sCircBuf.iCrtPosWrite]) {
                 memset((char*)pBuf + szElemSize, 0, m_sCircBuf.pDataSize[m_sCircBuf.iCrtPosWrite] - szElemSize);
             }
@@ -1472,6 +2173,9 @@ bool Microshell::m_CircBufWrite(const void *pElem, const size_t szElemSize)
             memcpy(pBuf, pElem, szElemSize);
             m_sCircBuf.ppData[m_sCircBuf.iCrtPosWrite] = pBuf;
             m_sCircBuf.pDataSize[m_sCircBuf.iCrtPosWrite] = szElemSize;
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_SUGGEST)
+            m_HistoryIndexInsert(m_sCircBuf.iCrtPosWrite);
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY_SUGGEST)*/
             m_sCircBuf.iCrtPosRead = m_sCircBuf.iCrtPosWrite;
             m_sCircBuf.iCrtPosWrite = (m_sCircBuf.iCrtPosWrite + 1) % uSHELL_HISTORY_DEPTH;
 
@@ -1580,6 +2284,9 @@ void Microshell::m_CircBufFlagsReset(void)
     m_sCircBuf.bIsFull      = false;
     m_sCircBuf.bIsEmpty     = true;
     m_sCircBuf.ePrevDir     = uSHELL_DIR_LAST;
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_SUGGEST)
+    m_HistoryIndexClear();
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY_SUGGEST)*/
 } /* m_CircBufFlagsReset() */
 
 
@@ -1648,7 +2355,7 @@ void Microshell::m_HistoryRead(const dir_e eDir)
         m_CoreCmdLineDelete();
         if(true == m_CircBufRead(eDir, m_pstrInput, &szReadLen)) {
             m_iInputPos = (int)(--szReadLen);
-            uSHELL_PRINTF("\r\033[%dC\033[K%s", m_pInst->iPromptLength, m_pstrInput);
+            uSHELL_PRINTF("\r\033[%dC\033[K%s", m_iPromptLength, m_pstrInput);
         }
     }
 } /* m_HistoryRead() */
@@ -1695,11 +2402,13 @@ void Microshell::m_HistoryExecuteEntry(const char *pstrIndex)
 void Microshell::m_HistoryWrite(void)
 {
     if(true == m_sHistory.bEnabled) {
+        uSHELL_TRACE(uSHELL_TRACE_HISTORY_BEGIN, 0);
         if(true == m_CircBufWrite(m_pstrInput, (m_iInputPos + 1))) {
 #if (1 == uSHELL_IMPLEMENTS_SAVE_HISTORY)
             m_HistoryWriteFile();
 #endif /*(1 == uSHELL_IMPLEMENTS_SAVE_HISTORY) */
         }
+        uSHELL_TRACE(uSHELL_TRACE_HISTORY_END, 0);
     }
 } /* m_HistoryWrite() */
 
@@ -1709,12 +2418,10 @@ void Microshell::m_HistoryReset(void)
 {
     if(true == m_sHistory.bInitialized) {
 #if (1 == uSHELL_IMPLEMENTS_CONFIRM_REQUEST)
-        if(true == m_CoreConfirmRequest()) {
-#endif /*(1 == uSHELL_IMPLEMENTS_CONFIRM_REQUEST) */
-            m_CircBufDeinit(uSHELL_DEINIT_RESET);
-            m_CorePrintMessage(3, 6); /* history reset */
-#if (1 == uSHELL_IMPLEMENTS_CONFIRM_REQUEST)
-        }
+        m_CoreConfirmRequest(uSHELL_CONFIRM_HISTORY_RESET);
+#else
+        m_CircBufDeinit(uSHELL_DEINIT_RESET);
+        m_CorePrintMessage(3, 6); /* history reset */
 #endif /*(1 == uSHELL_IMPLEMENTS_CONFIRM_REQUEST) */
     }
 } /* m_HistoryReset() */
@@ -1753,14 +2460,233 @@ void Microshell::m_HistoryEnable(bool bEnable)
 #endif /* (1 == uSHELL_IMPLEMENTS_HISTORY) */
 
 
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_SUGGEST)
+/*==============================================================================
+                   HISTORY: PREFIX INDEX AND INLINE SUGGESTION
+==============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+bool Microshell::m_HistoryIndexInit(void)
+{
+    m_sHistory.psNodes  = static_cast<histNode_s*>(uSHELL_MALLOC(uSHELL_HISTORY_INDEX_NODES * sizeof(histNode_s), uSHELL_HEAP_HISTORY_INDEX));
+    m_sHistory.pu8Depth = static_cast<uint8_t*>(uSHELL_MALLOC(uSHELL_HISTORY_DEPTH * sizeof(uint8_t), uSHELL_HEAP_HISTORY_INDEX));
+    m_sHistory.iSuggestSlot = uSHELL_INVALID_VALUE;
+
+    if((nullptr == m_sHistory.psNodes) || (nullptr == m_sHistory.pu8Depth)) {
+        m_HistoryIndexDeinit();
+        return false;
+    }
+    return true;
+} /* m_HistoryIndexInit() */
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_HistoryIndexDeinit(void)
+{
+    if(nullptr != m_sHistory.psNodes) {
+        uSHELL_FREE(m_sHistory.psNodes);
+        m_sHistory.psNodes = nullptr;
+    }
+    if(nullptr != m_sHistory.pu8Depth) {
+        uSHELL_FREE(m_sHistory.pu8Depth);
+        m_sHistory.pu8Depth = nullptr;
+    }
+} /* m_HistoryIndexDeinit() */
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_HistoryIndexClear(void)
+{
+    if(nullptr != m_sHistory.psNodes) {
+        memset(m_sHistory.psNodes, 0, uSHELL_HISTORY_INDEX_NODES * sizeof(histNode_s));
+        memset(m_sHistory.pu8Depth, 0, uSHELL_HISTORY_DEPTH * sizeof(uint8_t));
+        /* all but the root are free, chained through the sibling link */
+        for(unsigned int i = 1; i < (uSHELL_HISTORY_INDEX_NODES - 1); ++i) {
+            m_sHistory.psNodes[i].u16NextSibling = (uint16_t)(i + 1);
+        }
+        m_sHistory.u16FreeNode = (uSHELL_HISTORY_INDEX_NODES > 1) ? 1 : 0;
+    }
+    m_sHistory.iSuggestSlot = uSHELL_INVALID_VALUE;
+} /* m_HistoryIndexClear() */
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_HistoryIndexInsert(const int iSlot)
+{
+    if(nullptr == m_sHistory.psNodes) {
+        return;
+    }
+    histNode_s *psNodes = m_sHistory.psNodes;
+    const char *pstrEntry = (const char*)m_sCircBuf.ppData[iSlot];
+    int iNode  = 0;
+    int iDepth = 0;
+
+    for(; ('\0' != pstrEntry[iDepth]) && (iDepth < UINT8_MAX); ++iDepth) {
+        int iChild = psNodes[iNode].u16FirstChild;
+        while((0 != iChild) && (pstrEntry[iDepth] != psNodes[iChild].cKey)) {
+            iChild = psNodes[iChild].u16NextSibling;
+        }
+        if(0 == iChild) {
+            if(0 == (iChild = m_sHistory.u16FreeNode)) {
+                break;  /* index full, the rest of the entry is not suggested */
+            }
+            m_sHistory.u16FreeNode = psNodes[iChild].u16NextSibling;
+            psNodes[iChild].u16FirstChild  = 0;
+            psNodes[iChild].u16NextSibling = psNodes[iNode].u16FirstChild;
+            psNodes[iChild].u16Count       = 0;
+            psNodes[iChild].cKey           = pstrEntry[iDepth];
+            psNodes[iNode].u16FirstChild   = (uint16_t)iChild;
+        }
+        psNodes[iChild].u16Count++;
+        psNodes[iChild].u16Slot = (uint16_t)iSlot;    /* the newest entry wins */
+        iNode = iChild;
+    }
+    m_sHistory.pu8Depth[iSlot] = (uint8_t)iDepth;
+} /* m_HistoryIndexInsert() */
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_HistoryIndexRemove(const int iSlot)
+{
+    if(nullptr == m_sHistory.psNodes) {
+        return;
+    }
+    histNode_s *psNodes = m_sHistory.psNodes;
+    const char *pstrEntry = (const char*)m_sCircBuf.ppData[iSlot];
+    int iNode = 0;
+
+    /* only the oldest entry is removed, so no node keeps it as its most recent
+       entry unless the node belongs to this entry alone and is released */
+    for(int iDepth = 0; iDepth < m_sHistory.pu8Depth[iSlot]; ++iDepth) {
+        int iPrev  = 0;
+        int iChild = psNodes[iNode].u16FirstChild;
+        while((0 != iChild) && (pstrEntry[iDepth] != psNodes[iChild].cKey)) {
+            iPrev  = iChild;
+            iChild = psNodes[iChild].u16NextSibling;
+        }
+        if(0 == iChild) {
+            break;
+        }
+        if(1 == psNodes[iChild].u16Count) {
+            /* unlink the branch, below it there is only the chain of this entry */
+            if(0 == iPrev) {
+                psNodes[iNode].u16FirstChild = psNodes[iChild].u16NextSibling;
+            } else {
+                psNodes[iPrev].u16NextSibling = psNodes[iChild].u16NextSibling;
+            }
+            while(0 != iChild) {
+                int iNext = psNodes[iChild].u16FirstChild;
+                psNodes[iChild].u16NextSibling = m_sHistory.u16FreeNode;
+                m_sHistory.u16FreeNode = (uint16_t)iChild;
+                iChild = iNext;
+            }
+            break;
+        }
+        psNodes[iChild].u16Count--;
+        iNode = iChild;
+    }
+    m_sHistory.pu8Depth[iSlot] = 0;
+    if(iSlot == m_sHistory.iSuggestSlot) {
+        m_sHistory.iSuggestSlot = uSHELL_INVALID_VALUE;
+    }
+} /* m_HistoryIndexRemove() */
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_HistorySuggestShow(void)
+{
+    int iSlot = uSHELL_INVALID_VALUE;
+    bool bVisible = (true == m_sHistory.bEnabled) && (nullptr != m_sHistory.psNodes) && (m_iInputPos > 0);
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE)
+    bVisible = bVisible && ((false == m_bEditMode) || (m_iCursorPos == m_iInputPos));
+#endif /*(1 == uSHELL_IMPLEMENTS_EDITMODE)*/
+#if (1 == uSHELL_IMPLEMENTS_DISABLE_ECHO)
+    bVisible = bVisible && (true == m_bEchoOn);
+#endif /*(1 == uSHELL_IMPLEMENTS_DISABLE_ECHO)*/
+
+    /* O(prefix): walk the typed characters down the index */
+    if(true == bVisible) {
+        const histNode_s *psNodes = m_sHistory.psNodes;
+        int iNode = 0;
+        for(int i = 0; i < m_iInputPos; ++i) {
+            iNode = psNodes[iNode].u16FirstChild;
+            while((0 != iNode) && (m_pstrInput[i] != psNodes[iNode].cKey)) {
+                iNode = psNodes[iNode].u16NextSibling;
+            }
+            if(0 == iNode) {
+                break;  /* no entry starts with the input */
+            }
+        }
+        if((0 != iNode) && ((int)strlen((const char*)m_sCircBuf.ppData[psNodes[iNode].u16Slot]) > m_iInputPos)) {
+            iSlot = psNodes[iNode].u16Slot;
+        }
+    }
+
+    /* the typed character overwrote the first character of the same suggestion: nothing to draw */
+    if(iSlot != m_sHistory.iSuggestSlot) {
+        if(uSHELL_INVALID_VALUE != m_sHistory.iSuggestSlot) {
+            m_CorePutString("\033[K");
+        }
+        if(uSHELL_INVALID_VALUE != iSlot) {
+            const char *pstrGhost = (const char*)m_sCircBuf.ppData[iSlot] + m_iInputPos;
+            int iLen = (int)strlen(pstrGhost);
+            if(iLen > (int)(sizeof(m_pstrInput) - 1) - m_iInputPos) {
+                iLen = (int)(sizeof(m_pstrInput) - 1) - m_iInputPos;
+            }
+            m_CorePutString(uSHELL_SUGGEST_COLOR);
+            m_CoreWrite(pstrGhost, iLen);
+            uSHELL_PRINTF(uSHELL_RESET_COLOR "\033[%dD", iLen);
+        }
+        m_sHistory.iSuggestSlot = iSlot;
+    }
+} /* m_HistorySuggestShow() */
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_HistorySuggestHide(void)
+{
+    if(uSHELL_INVALID_VALUE != m_sHistory.iSuggestSlot) {
+        m_CorePutString("\033[K");
+        m_sHistory.iSuggestSlot = uSHELL_INVALID_VALUE;
+    }
+} /* m_HistorySuggestHide() */
+
+
+/*----------------------------------------------------------------------------*/
+bool Microshell::m_HistorySuggestAccept(void)
+{
+    if(uSHELL_INVALID_VALUE == m_sHistory.iSuggestSlot) {
+        return false;
+    }
+    /* the suggestion is already on screen, draw it again in the normal color */
+    const char *pstrGhost = (const char*)m_sCircBuf.ppData[m_sHistory.iSuggestSlot] + m_iInputPos;
+    while(('\0' != *pstrGhost) && (m_iInputPos < (int)(sizeof(m_pstrInput) - 1))) {
+        m_pstrInput[m_iInputPos++] = *pstrGhost;
+        uSHELL_PUTCH(*pstrGhost++);
+    }
+    m_pstrInput[m_iInputPos] = '\0';
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE)
+    if(true == m_bEditMode) {
+        m_iCursorPos = m_iInputPos;
+    }
+#endif /*(1 == uSHELL_IMPLEMENTS_EDITMODE)*/
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+    m_AutocomplReInit();
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)*/
+    m_sHistory.iSuggestSlot = uSHELL_INVALID_VALUE;
+    return true;
+} /* m_HistorySuggestAccept() */
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY_SUGGEST)*/
+
+
 #if ((1 == uSHELL_IMPLEMENTS_HISTORY) && (1 == uSHELL_IMPLEMENTS_SAVE_HISTORY))
 /*----------------------------------------------------------------------------*/
 void Microshell::m_HistoryLoadFromFile(void)
 {
     size_t szLen = 0;
-    if(nullptr != m_pInst->pfileHistory) {
-        rewind(m_pInst->pfileHistory);
-        while(fgets(m_pstrInput, sizeof(m_pstrInput), m_pInst->pfileHistory)) {
+    if(nullptr != m_pfileHistory) {
+        rewind(m_pfileHistory);
+        while(fgets(m_pstrInput, sizeof(m_pstrInput), m_pfileHistory)) {
             szLen = strcspn(m_pstrInput, "\n");
             m_pstrInput[szLen] = 0;
             m_CircBufWrite(m_pstrInput, (szLen + 1));
@@ -1788,7 +2714,7 @@ void Microshell::m_HistoryReload(void)
 void Microshell::m_HistoryInitFile(const char *pstrFileName)
 {
     uSHELL_SNPRINTF(m_pstrInput, sizeof(m_pstrInput), ".hist_%s", pstrFileName);
-    if(nullptr == (m_pInst->pfileHistory = fopen(m_pstrInput, "a+"))) {
+    if(nullptr == (m_pfileHistory = fopen(m_pstrInput, "a+"))) {
         m_CorePrintMessage(10, 4);    /* fopen failed*/
     }
 } /* m_HistoryInitFile() */
@@ -1797,9 +2723,9 @@ void Microshell::m_HistoryInitFile(const char *pstrFileName)
 /*----------------------------------------------------------------------------*/
 void Microshell::m_HistoryWriteFile(void)
 {
-    if(nullptr != m_pInst->pfileHistory) {
-        fwrite(m_pstrInput, sizeof(char), m_iInputPos, m_pInst->pfileHistory);
-        fwrite("\n", sizeof(char), 1, m_pInst->pfileHistory);
+    if(nullptr != m_pfileHistory) {
+        fwrite(m_pstrInput, sizeof(char), m_iInputPos, m_pfileHistory);
+        fwrite("\n", sizeof(char), 1, m_pfileHistory);
     } else {
         m_CorePrintMessage(3, 10);    /* history nofile*/
     }
@@ -1809,9 +2735,9 @@ void Microshell::m_HistoryWriteFile(void)
 /*----------------------------------------------------------------------------*/
 void Microshell::m_HistoryCloseFile(void)
 {
-    if(nullptr != m_pInst->pfileHistory) {
-        fclose(m_pInst->pfileHistory);
-        m_pInst->pfileHistory = nullptr;
+    if(nullptr != m_pfileHistory) {
+        fclose(m_pfileHistory);
+        m_pfileHistory = nullptr;
     }
 } /* m_HistoryCloseFile() */
 #endif /*(1 == uSHELL_IMPLEMENTS_SAVE_HISTORY)*/
@@ -1826,6 +2752,10 @@ void Microshell::m_HistoryCloseFile(void)
 void Microshell::m_AutocomplInit(void)
 {
     m_sAutocomplete.bEnabled = uSHELL_INIT_AUTOCOMPL_MODE;
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPL_RANKING)
+    m_sAutocomplete.iNrRanked = 0;
+    m_sAutocomplete.iNrFront  = 0;
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPL_RANKING)*/
 #if (1 == uSHELL_IMPLEMENTS_SMART_PROMPT)
     m_CoreUpdatePrompt(uSHELL_PROMPTI_AUTOCOMPLETE, m_sAutocomplete.bEnabled);
 #endif /*(1 == uSHELL_IMPLEMENTS_SMART_PROMPT)*/
@@ -1845,13 +2775,19 @@ inline void Microshell::m_AutocomplReInit(void)
 /*----------------------------------------------------------------------------*/
 void Microshell::m_AutocomplReset(bool bReinit)
 {
-    memset(m_pInst->piAutocompleteIndexArray, uSHELL_INVALID_VALUE, m_pInst->iNrFunctions);
+    m_sAutocomplete.iNode            = 0;
     m_sAutocomplete.iSearchPos       = 0;
     m_sAutocomplete.iSavedSearchPos  = 0;
     m_sAutocomplete.iSearchIndex     = 0;
     m_sAutocomplete.bFirstFilter     = true;
     m_sAutocomplete.bFoundExactMatch = false;
     m_sAutocomplete.iNrCrtElems      = 0;
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPL_RANKING)
+    m_sAutocomplete.iNrFront         = 0;
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPL_RANKING)*/
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPL_FUZZY)
+    m_sAutocomplete.bFuzzy           = false;
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPL_FUZZY)*/
     m_AutocomplFill(bReinit);
 } /* m_AutocomplReset() */
 
@@ -1860,43 +2796,32 @@ void Microshell::m_AutocomplReset(bool bReinit)
 void Microshell::m_AutocomplGetCommon(void)
 {
     if(true == m_sAutocomplete.bEnabled) {
-        int  iCount = 0;
-        bool bFound = false;
-        const char *pstrRef = nullptr, *pstrCrt = nullptr;
-        char cRef = '\0', cCrt = '\0';
-
         m_AutocomplFilter();
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPL_FUZZY)
+        if(true == m_sAutocomplete.bFuzzy) {
+            return;     /* the fuzzy candidates share no prefix, they are only cycled */
+        }
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPL_FUZZY)*/
         if(m_sAutocomplete.iNrCrtElems > 0) {
-            if(m_sAutocomplete.iNrCrtElems > 1) {
-                while(false == bFound) {
-                    iCount = 0;
-                    pstrRef = m_pInst->psFuncDefArray[m_pInst->piAutocompleteIndexArray[0]].pstrFctName;
-                    for(int i = 1; i < m_sAutocomplete.iNrCrtElems; ++i) {
-                        pstrCrt = m_pInst->psFuncDefArray[m_pInst->piAutocompleteIndexArray[i]].pstrFctName;
-                        if((cRef = pstrRef[m_sAutocomplete.iSearchPos]) == (cCrt = pstrCrt[m_sAutocomplete.iSearchPos])) {
-                            ++iCount;
-                        }
-                        if(('\0' == cRef) || ('\0' == cCrt)) {
-                            m_sAutocomplete.bFoundExactMatch = true;
-                        }
-                    }
-                    if(++iCount == m_sAutocomplete.iNrCrtElems) {
-                        ++(m_sAutocomplete.iSearchPos);
-                    } else {
-                        bFound = true;
-                    }
-                }
-            } else { /*1 == m_sAutocomplete.iNrCrtElems */
-                m_sAutocomplete.iSearchPos = (int)strlen(m_pInst->psFuncDefArray[m_pInst->piAutocompleteIndexArray[0]].pstrFctName);
-                m_sAutocomplete.bFoundExactMatch = true;
+            const autocomplNode_s *psNodes = m_sAutocomplete.psIndex->psNodes;
+            int iNode = m_sAutocomplete.iNode;
+
+            /* the common prefix goes down as long as the path does not branch,
+               an argument is not completed before its first character is typed */
+            while((m_iInputPos > m_sAutocomplete.iTokenStart) && (false == psNodes[iNode].bTerminal) && (0 != psNodes[iNode].u16FirstChild) &&
+                  (0 == psNodes[psNodes[iNode].u16FirstChild].u16NextSibling) && (m_iInputPos < (int)(sizeof(m_pstrInput) - 1))) {
+                iNode = psNodes[iNode].u16FirstChild;
+                m_pstrInput[m_iInputPos++] = psNodes[iNode].cKey;
+                m_pstrInput[m_iInputPos] = '\0';
+                uSHELL_PUTCH(psNodes[iNode].cKey);
             }
-            for(int i = m_sAutocomplete.iSavedSearchPos; i < m_sAutocomplete.iSearchPos; ++i) {
-                char cCrtChar = (m_pInst->psFuncDefArray[m_pInst->piAutocompleteIndexArray[0]].pstrFctName)[i];
-                m_pstrInput[i] = cCrtChar;
-                ++m_iInputPos;
-                uSHELL_PUTCH(cCrtChar);
+            if(true == psNodes[iNode].bTerminal) {
+                m_sAutocomplete.bFoundExactMatch = true;
             }
-            if(1 == m_sAutocomplete.iNrCrtElems) {
+            m_sAutocomplete.iNode           = iNode;
+            m_sAutocomplete.iSearchPos      = m_iInputPos;
+            m_sAutocomplete.iSavedSearchPos = m_iInputPos;
+            if((1 == m_sAutocomplete.iNrCrtElems) && (m_iInputPos > m_sAutocomplete.iTokenStart)) {
                 m_AutocomplInsEndSpace();
             }
         }
@@ -1931,85 +2856,335 @@ void Microshell::m_AutocomplRead(const dir_e eDir)
             }
             m_sAutocomplete.iSearchIndex = (uSHELL_INVALID_VALUE == m_sAutocomplete.iSearchIndex) ? (m_sAutocomplete.iNrCrtElems - 1) : m_sAutocomplete.iSearchIndex;
             m_sAutocomplete.iSearchIndex %= m_sAutocomplete.iNrCrtElems;
-            uSHELL_PRINTF("\r\033[%dC\033[K", m_pInst->iPromptLength);
+            /* the candidates of the node are contiguous in the sorted array,
+               only the token being completed (command or argument) is replaced */
+            const char *pstrCandidate = m_AutocomplName(m_sAutocomplete.psIndex, m_AutocomplCandidate(m_sAutocomplete.iSearchIndex));
+            const int iTokenStart = m_sAutocomplete.iTokenStart;
+            uSHELL_PRINTF("\r\033[%dC\033[K", m_iPromptLength);
 #if (defined(__MINGW32__) || defined(_MSC_VER))
-            strncpy_s(m_pstrInput, sizeof(m_pstrInput), m_pInst->psFuncDefArray[m_pInst->piAutocompleteIndexArray[m_sAutocomplete.iSearchIndex]].pstrFctName, sizeof(m_pstrInput));
+            strncpy_s(&m_pstrInput[iTokenStart], sizeof(m_pstrInput) - iTokenStart, pstrCandidate, _TRUNCATE);
 #else
-            strncpy(m_pstrInput, m_pInst->psFuncDefArray[m_pInst->piAutocompleteIndexArray[m_sAutocomplete.iSearchIndex]].pstrFctName, sizeof(m_pstrInput));
+            strncpy(&m_pstrInput[iTokenStart], pstrCandidate, sizeof(m_pstrInput) - iTokenStart - 1);
+            m_pstrInput[sizeof(m_pstrInput) - 1] = '\0';
 #endif /*(defined(__MINGW32__) || defined(_MSC_VER))*/
             m_iInputPos = (int)strlen(m_pstrInput);
+            if(m_iInputPos >= (int)(sizeof(m_pstrInput) - 1)) {
+                m_sAutocomplete.bFoundExactMatch = false;    /* no room left for the separator */
+            }
             m_AutocomplInsEndSpace();
-            uSHELL_PRINTF("\r\033[%dC\033[K%s", m_pInst->iPromptLength, m_pstrInput);
+            uSHELL_PRINTF("\r\033[%dC\033[K%s", m_iPromptLength, m_pstrInput);
         }
     }
 } /* m_AutocomplRead() */
 
 
 /*----------------------------------------------------------------------------*/
-void Microshell::m_AutocomplFilter(void)
+inline const char *Microshell::m_AutocomplName(const autocomplIndex_s *psIndex, const int iSortedPos)
 {
-    int iCount = 0, iIndex = 0;
-    int iLimit = (true == m_sAutocomplete.bFirstFilter) ? m_pInst->iNrFunctions : m_sAutocomplete.iNrCrtElems;
-    const char *pstrCrtItem = nullptr;
-
-    m_sAutocomplete.iSavedSearchPos = (int)strlen(m_pstrInput);
-    for(int i = 0; i < iLimit; ++i) {
-        iIndex = (true == m_sAutocomplete.bFirstFilter) ? i : m_pInst->piAutocompleteIndexArray[i];
-        pstrCrtItem = m_pInst->psFuncDefArray[iIndex].pstrFctName;
-        if(0 == strncmp(pstrCrtItem, m_pstrInput, m_sAutocomplete.iSavedSearchPos)) {
-            m_pInst->piAutocompleteIndexArray[iCount++] = iIndex;
-        }
-    }
-    if(true == m_sAutocomplete.bFirstFilter) {
-        m_sAutocomplete.bFirstFilter = false;
-    }
-    m_sAutocomplete.iNrCrtElems = iCount;
-} /* m_AutocomplFilter() */
+    /* the name is the first member of the indexed items */
+    return *(const char * const *)((const char *)psIndex->pvItems + (psIndex->pu16Sorted[iSortedPos] * psIndex->iItemSize));
+} /* m_AutocomplName() */
 
 
 /*----------------------------------------------------------------------------*/
-void Microshell::m_AutocomplFill(const bool bFull)
+int Microshell::m_AutocomplCandidate(const int iSearchIndex)
 {
-    if(true == bFull) {
-        for(int i = 0; i < m_pInst->iNrFunctions; ++i) {
-            m_pInst->piAutocompleteIndexArray[i] = i;
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPL_RANKING)
+    /* the front candidates (ranked or fuzzy matched) come first, then the rest of the range */
+    if(iSearchIndex < m_sAutocomplete.iNrFront) {
+        return m_sAutocomplete.vu16Front[iSearchIndex];
+    }
+    int iPos = m_sAutocomplete.psIndex->psNodes[m_sAutocomplete.iNode].u16RangeLo + (iSearchIndex - m_sAutocomplete.iNrFront);
+    for(int i = 0; i < m_sAutocomplete.iNrFront; ++i) {
+        if(m_sAutocomplete.vu16Skip[i] <= iPos) {
+            ++iPos;
         }
-        m_sAutocomplete.iNrCrtElems = m_pInst->iNrFunctions;
-    } else {
-        m_AutocomplGetCommon();
     }
-} /* m_AutocomplFill() */
+    return iPos;
+#else
+    return m_sAutocomplete.psIndex->psNodes[m_sAutocomplete.iNode].u16RangeLo + iSearchIndex;
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPL_RANKING)*/
+} /* m_AutocomplCandidate() */
 
 
 /*----------------------------------------------------------------------------*/
-void Microshell::m_AutocomplInsEndSpace(void)
+int Microshell::m_AutocomplWalk(const autocomplIndex_s *psIndex, const char *pstrName, const int iLen)
 {
-    if((true == m_sAutocomplete.bFoundExactMatch)) {
-        m_pstrInput[m_iInputPos++] = uSHELL_KEY_SPACE;
-        m_pstrInput[m_iInputPos] = '\0';
-        uSHELL_PUTCH(uSHELL_KEY_SPACE);
+    int iNode = 0;
+    for(int i = 0; (uSHELL_INVALID_VALUE != iNode) && (i < iLen); ++i) {
+        iNode = m_AutocomplChild(psIndex, iNode, pstrName[i]);
     }
-} /* m_AutocomplInsEndSpace() */
+    return iNode;
+} /* m_AutocomplWalk() */
 
 
 /*----------------------------------------------------------------------------*/
-void Microshell::m_AutocomplEnable(const bool bEnable)
+inline int Microshell::m_AutocomplChild(const autocomplIndex_s *psIndex, const int iNode, const char cKey)
 {
-    m_sAutocomplete.bEnabled = bEnable;
-    m_CorePrintMessage(1, (int)bEnable); /* autocomplete on/off */
-#if (1 == uSHELL_IMPLEMENTS_SMART_PROMPT)
-    m_CoreUpdatePrompt(uSHELL_PROMPTI_AUTOCOMPLETE, bEnable);
-#endif /* (1 == uSHELL_IMPLEMENTS_SMART_PROMPT) */
-}/* m_AutocomplEnable() */
-#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)*/
-
-
-/*==============================================================================
-                           EDITMODE IMPLEMENTATION
-==============================================================================*/
+    const autocomplNode_s *psNodes = psIndex->psNodes;
+    int iChild = psNodes[iNode].u16FirstChild;
+    while((0 != iChild) && (cKey != psNodes[iChild].cKey)) {
+        iChild = psNodes[iChild].u16NextSibling;
+    }
+    return (0 != iChild) ? iChild : uSHELL_INVALID_VALUE;
+} /* m_AutocomplChild() */
 
 
-#if (1 == uSHELL_IMPLEMENTS_EDITMODE)
+/*----------------------------------------------------------------------------*/
+void Microshell::m_AutocomplFilter(void)
+{
+    int iLen = (int)strlen(m_pstrInput);
+    int iPos = m_sAutocomplete.iSavedSearchPos;
+
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPL_ARGS)
+    /* the token being completed starts after the last space */
+    int iTokenStart = iLen;
+    while((iTokenStart > 0) && (uSHELL_KEY_SPACE != m_pstrInput[iTokenStart - 1])) {
+        --iTokenStart;
+    }
+    if((true == m_sAutocomplete.bFirstFilter) || (iTokenStart != m_sAutocomplete.iTokenStart)) {
+        m_sAutocomplete.iTokenStart  = iTokenStart;
+        m_sAutocomplete.psIndex      = (0 == iTokenStart) ? m_pInst->psAutocomplIndex : m_AutocomplArgIndex(iTokenStart);
+        m_sAutocomplete.bFirstFilter = true;
+        m_sAutocomplete.bFoundExactMatch = false;   /* the match found was the one of the previous token */
+    }
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPL_ARGS)*/
+
+    if((true == m_sAutocomplete.bFirstFilter) || (iLen < iPos)) {
+        m_sAutocomplete.iNode = (nullptr != m_sAutocomplete.psIndex) ? 0 : uSHELL_INVALID_VALUE;   /* restart from the root */
+        iPos = m_sAutocomplete.iTokenStart;
+        m_sAutocomplete.bFirstFilter = false;
+    }
+    /* descend only over the characters added since the previous filtering */
+    while((uSHELL_INVALID_VALUE != m_sAutocomplete.iNode) && (iPos < iLen)) {
+        m_sAutocomplete.iNode = m_AutocomplChild(m_sAutocomplete.psIndex, m_sAutocomplete.iNode, m_pstrInput[iPos++]);
+    }
+    m_sAutocomplete.iSavedSearchPos = iLen;
+    if(uSHELL_INVALID_VALUE != m_sAutocomplete.iNode) {
+        const autocomplNode_s *psNode = &m_sAutocomplete.psIndex->psNodes[m_sAutocomplete.iNode];
+        m_sAutocomplete.iNrCrtElems = psNode->u16RangeHi - psNode->u16RangeLo;
+    } else {
+        m_sAutocomplete.iNrCrtElems = 0;
+    }
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPL_FUZZY)
+    /* no command starts with the typed prefix, look for the most used ones containing it */
+    if((uSHELL_INVALID_VALUE == m_sAutocomplete.iNode) && (m_pInst->psAutocomplIndex == m_sAutocomplete.psIndex)) {
+        m_AutocomplFuzzy(iLen);
+        return;
+    }
+    m_sAutocomplete.bFuzzy = false;
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPL_FUZZY)*/
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPL_RANKING)
+    m_AutocomplRankFront();
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPL_RANKING)*/
+} /* m_AutocomplFilter() */
+
+
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPL_RANKING)
+/*----------------------------------------------------------------------------*/
+void Microshell::m_AutocomplRankUpdate(const int iFctIndex)
+{
+    const autocomplIndex_s *psCommands = m_pInst->psAutocomplIndex;
+    const char *pstrName = m_pInst->psFuncDefArray[iFctIndex].pstrFctName;
+    const int iNode = m_AutocomplWalk(psCommands, pstrName, (int)strlen(pstrName));
+    if(uSHELL_INVALID_VALUE == iNode) {
+        return;
+    }
+    const uint16_t u16SortedPos = psCommands->psNodes[iNode].u16RangeLo;
+    autocomplRank_s *psRank = m_sAutocomplete.vsRank;
+    int i = 0;
+
+    while((i < m_sAutocomplete.iNrRanked) && (u16SortedPos != psRank[i].u16SortedPos)) {
+        ++i;
+    }
+    if(i == m_sAutocomplete.iNrRanked) {
+        if(m_sAutocomplete.iNrRanked < (int)uSHELL_AUTOCOMPL_RANK_SLOTS) {
+            psRank[m_sAutocomplete.iNrRanked++].u16Hits = 0;
+        } else {
+            --i;    /* the least used slot is taken over and its counter inherited (space saving) */
+        }
+        psRank[i].u16SortedPos = u16SortedPos;
+    }
+    if(UINT16_MAX == psRank[i].u16Hits) {
+        for(int j = 0; j < m_sAutocomplete.iNrRanked; ++j) {
+            psRank[j].u16Hits >>= 1;    /* age the counters instead of saturating */
+        }
+    }
+    ++psRank[i].u16Hits;
+
+    /* keep the table ordered, most used first */
+    while((i > 0) && (psRank[i - 1].u16Hits < psRank[i].u16Hits)) {
+        autocomplRank_s sTmp = psRank[i - 1];
+        psRank[i - 1] = psRank[i];
+        psRank[i] = sTmp;
+        --i;
+    }
+} /* m_AutocomplRankUpdate() */
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_AutocomplRankFront(void)
+{
+    int iNrFront = 0;
+
+    if((m_pInst->psAutocomplIndex == m_sAutocomplete.psIndex) && (uSHELL_INVALID_VALUE != m_sAutocomplete.iNode)) {
+        const autocomplNode_s *psNode = &m_sAutocomplete.psIndex->psNodes[m_sAutocomplete.iNode];
+        int iExact = uSHELL_INVALID_VALUE;
+        if(true == psNode->bTerminal) {
+            iExact = psNode->u16RangeLo;    /* the typed name stays the first candidate */
+            m_sAutocomplete.vu16Front[iNrFront++] = psNode->u16RangeLo;
+        }
+        for(int i = 0; i < m_sAutocomplete.iNrRanked; ++i) {
+            const int iPos = m_sAutocomplete.vsRank[i].u16SortedPos;
+            if((iPos >= psNode->u16RangeLo) && (iPos < psNode->u16RangeHi) && (iPos != iExact)) {
+                m_sAutocomplete.vu16Front[iNrFront++] = (uint16_t)iPos;
+            }
+        }
+        /* ascending copy, skipped when the rest of the range is cycled */
+        for(int i = 0; i < iNrFront; ++i) {
+            int j = i;
+            while((j > 0) && (m_sAutocomplete.vu16Skip[j - 1] > m_sAutocomplete.vu16Front[i])) {
+                m_sAutocomplete.vu16Skip[j] = m_sAutocomplete.vu16Skip[j - 1];
+                --j;
+            }
+            m_sAutocomplete.vu16Skip[j] = m_sAutocomplete.vu16Front[i];
+        }
+    }
+    m_sAutocomplete.iNrFront = iNrFront;
+} /* m_AutocomplRankFront() */
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPL_RANKING)*/
+
+
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPL_FUZZY)
+/*----------------------------------------------------------------------------*/
+void Microshell::m_AutocomplFuzzy(const int iLen)
+{
+    const autocomplIndex_s *psCommands = m_pInst->psAutocomplIndex;
+    autocomplRank_s *psRank = m_sAutocomplete.vsRank;
+    int iPos = m_sAutocomplete.iFuzzyPos;
+
+    /* restart when the input was shortened, otherwise match only the added characters */
+    if((false == m_sAutocomplete.bFuzzy) || (iLen < iPos)) {
+        for(int i = 0; i < m_sAutocomplete.iNrRanked; ++i) {
+            psRank[i].u8FuzzyPos  = 0;
+            psRank[i].bFuzzyMatch = true;
+        }
+        iPos = m_sAutocomplete.iTokenStart;
+        m_sAutocomplete.bFuzzy = true;
+    }
+    for(int i = 0; i < m_sAutocomplete.iNrRanked; ++i) {
+        const char *pstrName = m_AutocomplName(psCommands, psRank[i].u16SortedPos);
+        int iNamePos = psRank[i].u8FuzzyPos;
+        for(int k = iPos; (true == psRank[i].bFuzzyMatch) && (k < iLen); ++k) {
+            while(('\0' != pstrName[iNamePos]) && (m_pstrInput[k] != pstrName[iNamePos])) {
+                ++iNamePos;
+            }
+            if('\0' == pstrName[iNamePos]) {
+                psRank[i].bFuzzyMatch = false;
+            } else {
+                ++iNamePos;
+            }
+        }
+        psRank[i].u8FuzzyPos = (uint8_t)((iNamePos < UINT8_MAX) ? iNamePos : UINT8_MAX);
+    }
+    m_sAutocomplete.iFuzzyPos = iLen;
+
+    /* the matching commands are cycled in the ranking order */
+    int iNrFront = 0;
+    for(int i = 0; i < m_sAutocomplete.iNrRanked; ++i) {
+        if(true == psRank[i].bFuzzyMatch) {
+            m_sAutocomplete.vu16Front[iNrFront++] = psRank[i].u16SortedPos;
+        }
+    }
+    m_sAutocomplete.iNrFront    = iNrFront;
+    m_sAutocomplete.iNrCrtElems = iNrFront;
+} /* m_AutocomplFuzzy() */
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPL_FUZZY)*/
+
+
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPL_ARGS)
+/*----------------------------------------------------------------------------*/
+const autocomplIndex_s *Microshell::m_AutocomplArgIndex(const int iTokenStart)
+{
+    const autocomplIndex_s *psCommands = m_pInst->psAutocomplIndex;
+    int iPos  = 0;
+
+    if(nullptr == m_pInst->pfComplete) {
+        return nullptr;
+    }
+
+    /* the command is the first token, resolved over the commands index */
+    while(uSHELL_KEY_SPACE != m_pstrInput[iPos]) {
+        ++iPos;
+    }
+    const int iNode = m_AutocomplWalk(psCommands, m_pstrInput, iPos);
+    if((uSHELL_INVALID_VALUE == iNode) || (false == psCommands->psNodes[iNode].bTerminal)) {
+        return nullptr;
+    }
+    /* a complete name sorts before the longer names sharing its prefix */
+    const int iFctIndex = psCommands->pu16Sorted[psCommands->psNodes[iNode].u16RangeLo];
+
+    /* the argument index is the number of tokens between the command and the completed one */
+    int iArgIndex = 0;
+    for(; iPos < iTokenStart - 1; ++iPos) {
+        if((uSHELL_KEY_SPACE == m_pstrInput[iPos]) && (uSHELL_KEY_SPACE != m_pstrInput[iPos + 1])) {
+            ++iArgIndex;
+        }
+    }
+
+    /* only the arguments expected by the parameters pattern can be completed */
+    const char *pstrParams = m_pInst->psFuncDefArray[iFctIndex].pstrFuncParamDef;
+    if(('v' == pstrParams[0]) || (iArgIndex >= (int)strlen(pstrParams))) {
+        return nullptr;
+    }
+    return m_pInst->pfComplete(iFctIndex, iArgIndex);
+} /* m_AutocomplArgIndex() */
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPL_ARGS)*/
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_AutocomplFill(const bool bFull)
+{
+    if(true == bFull) {
+        m_sAutocomplete.psIndex     = m_pInst->psAutocomplIndex;
+        m_sAutocomplete.iTokenStart = 0;
+        m_sAutocomplete.iNode = 0;   /* the root covers all the commands */
+        m_sAutocomplete.iNrCrtElems = m_pInst->iNrFunctions;
+    } else {
+        m_AutocomplGetCommon();
+    }
+} /* m_AutocomplFill() */
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_AutocomplInsEndSpace(void)
+{
+    if((true == m_sAutocomplete.bFoundExactMatch)) {
+        m_pstrInput[m_iInputPos++] = uSHELL_KEY_SPACE;
+        m_pstrInput[m_iInputPos] = '\0';
+        uSHELL_PUTCH(uSHELL_KEY_SPACE);
+    }
+} /* m_AutocomplInsEndSpace() */
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_AutocomplEnable(const bool bEnable)
+{
+    m_sAutocomplete.bEnabled = bEnable;
+    m_CorePrintMessage(1, (int)bEnable); /* autocomplete on/off */
+#if (1 == uSHELL_IMPLEMENTS_SMART_PROMPT)
+    m_CoreUpdatePrompt(uSHELL_PROMPTI_AUTOCOMPLETE, bEnable);
+#endif /* (1 == uSHELL_IMPLEMENTS_SMART_PROMPT) */
+}/* m_AutocomplEnable() */
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)*/
+
+
+/*==============================================================================
+                           EDITMODE IMPLEMENTATION
+==============================================================================*/
+
+
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE)
 /*----------------------------------------------------------------------------*/
 void Microshell::m_EditMoveCursorDirSteps(const dir_e eDir, const int iSteps)
 {
@@ -2127,7 +3302,7 @@ void Microshell::m_EditDeleteBackwardToHome(void)
             memset(&m_pstrInput[iLen], 0, m_iCursorPos);
             m_iCursorPos = 0;
             m_iInputPos = iLen;
-            uSHELL_PRINTF("\r\033[%dC\033[K%s\033[%dD", m_pInst->iPromptLength, m_pstrInput, iLen);
+            uSHELL_PRINTF("\r\033[%dC\033[K%s\033[%dD", m_iPromptLength, m_pstrInput, iLen);
         } else {
             m_CoreCmdLineDelete();
         }
@@ -2160,60 +3335,1239 @@ void Microshell::m_EditDeleteForwardToEnd(void)
 
 /*----------------------------------------------------------------------------*/
 #if (1 == uSHELL_IMPLEMENTS_KEY_DECODER)
-void Microshell::keydecoder(void)
+void Microshell::keydecoder(const char cRead)
 {
-    char cRead;
-    m_CorePutString(":exit:$\n\r");
-    do {
-        if(uSHELL_KEY_ENTER == (cRead = (char)uSHELL_GETCH())) {
-            uSHELL_PRINTF("%02X\n", uSHELL_KEY_ENTER);
-        } else {
-            uSHELL_PRINTF("%02X|%c ", (unsigned char)cRead, (true == uSHELL_ISPRINT(cRead)) ? cRead : ' ');
-        }
-    } while('$' != cRead);
-    m_CorePutString(uSHELL_NEWLINE);
+    if(uSHELL_KEY_ENTER == cRead) {
+        uSHELL_PRINTF("%02X\n", uSHELL_KEY_ENTER);
+    } else {
+        uSHELL_PRINTF("%02X|%c ", (unsigned char)cRead, (true == uSHELL_ISPRINT(cRead)) ? cRead : ' ');
+    }
+    if('$' == cRead) {
+        m_CorePutString(uSHELL_NEWLINE);
+        m_eInputState = uSHELL_INPUT_KEY;
+        m_CorePrintPrompt();
+    }
 }
 #endif /*(1 == uSHELL_IMPLEMENTS_KEY_DECODER)*/
 
 
+#if (1 == uSHELL_IMPLEMENTS_JOBS)
 /*==============================================================================
-                    PRIVATE VARIABLES INITIALIZATION
+                    JOBS: BACKGROUND EXECUTION
 ==============================================================================*/
 
 
-uShellInst_s *Microshell::m_pInst = nullptr;
-command_s Microshell::m_sCommand = {};
-char Microshell::m_pstrInput[uSHELL_MAX_INPUT_BUF_LEN] = {0};
-int  Microshell::m_iInputPos = 0;
-int  Microshell::m_iCursorPos = 0;
+/*----------------------------------------------------------------------------*/
+bool Microshell::m_JobsIsBackground(void)
+{
+    bool bRetVal = false;
+    if((m_iInputPos > 1) && ('&' == m_pstrInput[m_iInputPos - 1])) {
+        m_pstrInput[--m_iInputPos] = '\0';
+        m_CoreRemoveTrailingSpaces();
+        bRetVal = true;
+    }
+    return bRetVal;
+} /* m_JobsIsBackground() */
 
-#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
-autocomplete_s Microshell::m_sAutocomplete = {};
-#endif /* (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE) */
 
-#if (1 == uSHELL_IMPLEMENTS_HISTORY)
-circbuf_s Microshell::m_sCircBuf = {};
-history_s Microshell::m_sHistory = {};
-#endif /* (1 == uSHELL_IMPLEMENTS_HISTORY) */
+/*----------------------------------------------------------------------------*/
+bool Microshell::m_JobsStartWorkers(void)
+{
+    /* the pool is started with the first job */
+    if(0 == m_iNrWorkers) {
+        pthread_attr_t sAttr;
+        pthread_attr_init(&sAttr);
+        pthread_attr_setstacksize(&sAttr, uSHELL_JOBS_STACK_SIZE);
+        while((m_iNrWorkers < (int)uSHELL_JOBS_WORKERS) && (0 == pthread_create(&m_vWorkers[m_iNrWorkers], &sAttr, m_JobsWorker, this))) {
+            ++m_iNrWorkers;
+        }
+        pthread_attr_destroy(&sAttr);
+    }
+    return (m_iNrWorkers > 0);
+} /* m_JobsStartWorkers() */
 
-#if (1 == uSHELL_IMPLEMENTS_EDITMODE)
-#if defined(uSHELL_EDIT_MODE_DEFAULT_ACTIVE)
-bool Microshell::m_bEditMode = true;
-#else
-bool Microshell::m_bEditMode = false;
-#endif /* !defined(uSHELL_EDIT_MODE_DEFAULT_ACTIVE) */
-#endif /* (1 == uSHELL_IMPLEMENTS_EDITMODE) */
 
-#if (1 == uSHELL_IMPLEMENTS_DISABLE_ECHO)
-bool Microshell::m_bEchoOn = true;
-#endif /* (1 == uSHELL_IMPLEMENTS_DISABLE_ECHO) */
+/*----------------------------------------------------------------------------*/
+void Microshell::m_JobsStopWorkers(void)
+{
+    pthread_mutex_lock(&m_sJobsLock);
+    m_bJobsStop = true;
+    for(unsigned int i = 0; i < uSHELL_JOBS_MAX; ++i) {
+        m_vsJobs[i].bCancel = true;
+    }
+    pthread_cond_broadcast(&m_sJobsCond);
+    pthread_mutex_unlock(&m_sJobsLock);
+
+    for(int i = 0; i < m_iNrWorkers; ++i) {
+        pthread_join(m_vWorkers[i], nullptr);
+    }
+    m_iNrWorkers = 0;
+    m_bJobsStop  = false;
+} /* m_JobsStopWorkers() */
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_JobsSubmit(void)
+{
+    job_s *psJob = nullptr;
+
+    if(true == m_JobsStartWorkers()) {
+        pthread_mutex_lock(&m_sJobsLock);
+        for(unsigned int i = 0; (nullptr == psJob) && (i < uSHELL_JOBS_MAX); ++i) {
+            const jobState_e eState = m_vsJobs[i].eState;
+            if((uSHELL_JOB_FREE == eState) || (((uSHELL_JOB_DONE == eState) || (uSHELL_JOB_CANCELLED == eState)) && (true == m_vsJobs[i].bReported))) {
+                psJob = &m_vsJobs[i];
+            }
+        }
+        if(nullptr != psJob) {
+            m_CoreCopyCommand(&psJob->sCommand, psJob->vstrInput, &m_sCommand, m_pstrInput);
+            psJob->iId       = ++m_iJobsLastId;
+            psJob->iRetVal   = 0;
+            psJob->bCancel   = false;
+            psJob->bReported = false;
+            psJob->eState    = uSHELL_JOB_QUEUED;
+            pthread_cond_broadcast(&m_sJobsCond);
+        }
+        pthread_mutex_unlock(&m_sJobsLock);
+    }
+
+    if(nullptr != psJob) {
+        uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR, "\r[%d] %s\n"), psJob->iId, m_sCommand.pstrFctName);
+    } else {
+        m_CorePrintMessage(11, (0 == m_iNrWorkers) ? 4 : 12);  /* job failed | table full */
+    }
+} /* m_JobsSubmit() */
+
+
+/*----------------------------------------------------------------------------*/
+void *Microshell::m_JobsWorker(void *pvShell)
+{
+    static_cast<Microshell*>(pvShell)->m_JobsWorkerLoop();
+    return nullptr;
+} /* m_JobsWorker() */
+
+
+/** \brief output of a job, queued line by line to the log sink: the shell prints it above the edited line */
+typedef struct {
+    char vstrLine[uSHELL_LOG_MSG_LEN];
+    int  iLen;
+} jobLine_s;
+
+
+/*----------------------------------------------------------------------------*/
+static void uShellJobLineFlush(jobLine_s *psLine)
+{
+    psLine->vstrLine[psLine->iLen] = '\0';
+    uShellLogPut(psLine->vstrLine);     /* counted as dropped when the queue is full */
+    psLine->iLen = 0;
+} /* uShellJobLineFlush() */
+
+
+/*----------------------------------------------------------------------------*/
+static void uShellJobLineWrite(void *pvLine, const char *pcBuf, const int iLen)
+{
+    jobLine_s *psLine = static_cast<jobLine_s*>(pvLine);
+
+    for(int i = 0; i < iLen; ++i) {
+        if('\n' == pcBuf[i]) {
+            uShellJobLineFlush(psLine);
+        } else if('\r' != pcBuf[i]) {
+            psLine->vstrLine[psLine->iLen++] = pcBuf[i];
+            if(psLine->iLen >= (int)(sizeof(psLine->vstrLine) - 1U)) {
+                uShellJobLineFlush(psLine);     /* a longer line is split */
+            }
+        }
+    }
+} /* uShellJobLineWrite() */
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_JobsWorkerLoop(void)
+{
+    pthread_mutex_lock(&m_sJobsLock);
+    while(false == m_bJobsStop) {
+        job_s *psJob = nullptr;
+        for(unsigned int i = 0; i < uSHELL_JOBS_MAX; ++i) {   /* oldest queued job first */
+            if((uSHELL_JOB_QUEUED == m_vsJobs[i].eState) && ((nullptr == psJob) || (m_vsJobs[i].iId < psJob->iId))) {
+                psJob = &m_vsJobs[i];
+            }
+        }
+        if(nullptr == psJob) {
+            pthread_cond_wait(&m_sJobsCond, &m_sJobsLock);
+        } else {
+            psJob->eState = uSHELL_JOB_RUNNING;
+            pthread_mutex_unlock(&m_sJobsLock);
+
+            /* the worker never writes to the transport itself, the shell task owns it */
+            jobLine_s sLine = {};
+            uShellSetCancelToken(&psJob->bCancel);
+            uShellSetPrintSink({ uShellJobLineWrite, &sLine });
+            const int iRetVal = m_pInst->pfExec(&psJob->sCommand);
+            if(sLine.iLen > 0) {
+                uShellJobLineFlush(&sLine);
+            }
+            uShellSetPrintSink({ nullptr, nullptr });
+            uShellSetCancelToken(nullptr);
+
+            pthread_mutex_lock(&m_sJobsLock);
+            psJob->iRetVal = iRetVal;
+            psJob->eState  = (true == psJob->bCancel) ? uSHELL_JOB_CANCELLED : uSHELL_JOB_DONE;
+            pthread_cond_broadcast(&m_sJobsCond);
+        }
+    }
+    pthread_mutex_unlock(&m_sJobsLock);
+} /* m_JobsWorkerLoop() */
+
+
+/*----------------------------------------------------------------------------*/
+job_s *Microshell::m_JobsFind(const int iId)
+{
+    job_s *psJob = nullptr;
+    for(unsigned int i = 0; (nullptr == psJob) && (i < uSHELL_JOBS_MAX); ++i) {
+        if((uSHELL_JOB_FREE != m_vsJobs[i].eState) && (iId == m_vsJobs[i].iId)) {
+            psJob = &m_vsJobs[i];
+        }
+    }
+    return psJob;
+} /* m_JobsFind() */
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_JobsList(void)
+{
+    static const char *pstrStateArray[] = { "", "queued", "running", "done", "cancelled" };
+    int iNrJobs = 0;
+
+    pthread_mutex_lock(&m_sJobsLock);
+    for(unsigned int i = 0; i < uSHELL_JOBS_MAX; ++i) {
+        const job_s *psJob = &m_vsJobs[i];
+        if(uSHELL_JOB_FREE != psJob->eState) {
+            uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR, "[%d] %-10s %15s"), psJob->iId, pstrStateArray[psJob->eState], psJob->sCommand.pstrFctName);
+            if(uSHELL_JOB_DONE == psJob->eState) {
+                uSHELL_PRINTF(" => %d (0x%X)", psJob->iRetVal, psJob->iRetVal);
+            }
+            uSHELL_PRINTF("\n");
+            ++iNrJobs;
+        }
+    }
+    pthread_mutex_unlock(&m_sJobsLock);
+
+    if(0 == iNrJobs) {
+        m_CorePrintMessage(11, 5); /* job empty */
+    }
+} /* m_JobsList() */
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_JobsWait(const char *pstrArgs)
+{
+    BIGNUM_T numVal = 0;
+    const bool bAll = ('\0' == *pstrArgs);
+
+    while(uSHELL_KEY_SPACE == *pstrArgs) {
+        ++pstrArgs;
+    }
+    pthread_mutex_lock(&m_sJobsLock);
+    if((false == bAll) && ((false == asc2int(pstrArgs, &numVal)) || (nullptr == m_JobsFind((int)numVal)))) {
+        pthread_mutex_unlock(&m_sJobsLock);
+        m_CorePrintMessage(11, 3); /* job noentry */
+    } else {
+        /* waits in slices: a job that never checks its cancellation does not keep the console, Ctrl-C or the timeout give it back */
+        struct timespec sStart, sNow;
+        uint32_t u32WaitedMs = 0U;
+        bool bPending = true;
+        clock_gettime(CLOCK_MONOTONIC, &sStart);   /* the other jobs finishing wake the wait up too */
+        while(true == bPending) {
+            bPending = false;
+            for(unsigned int i = 0; i < uSHELL_JOBS_MAX; ++i) {
+                const jobState_e eState = m_vsJobs[i].eState;
+                if(((uSHELL_JOB_QUEUED == eState) || (uSHELL_JOB_RUNNING == eState)) && ((true == bAll) || ((int)numVal == m_vsJobs[i].iId))) {
+                    bPending = true;
+                }
+            }
+            if(true == bPending) {
+                struct timespec sUntil;
+                clock_gettime(CLOCK_REALTIME, &sUntil);
+                sUntil.tv_nsec += (long)uSHELL_JOBS_WAIT_SLICE_MS * 1000000L;
+                if(sUntil.tv_nsec >= 1000000000L) {
+                    sUntil.tv_nsec -= 1000000000L;
+                    ++sUntil.tv_sec;
+                }
+                pthread_cond_timedwait(&m_sJobsCond, &m_sJobsLock, &sUntil);
+                clock_gettime(CLOCK_MONOTONIC, &sNow);
+                u32WaitedMs = (uint32_t)(((sNow.tv_sec - sStart.tv_sec) * 1000) + ((sNow.tv_nsec - sStart.tv_nsec) / 1000000));
+
+                pthread_mutex_unlock(&m_sJobsLock);
+                const int iKey = m_CoreTryGetch();
+                pthread_mutex_lock(&m_sJobsLock);
+                if(uSHELL_KEY_CTRL_C == iKey) {
+                    uSHELL_PRINTF(FRMT(uSHELL_WARNING_COLOR, "\r^C wait interrupted, the job keeps running\n"));
+                    break;
+                }
+                if((0U != uSHELL_JOBS_WAIT_MS) && (u32WaitedMs >= uSHELL_JOBS_WAIT_MS)) {
+                    uSHELL_PRINTF(FRMT(uSHELL_WARNING_COLOR, "\rwait timed out after %u ms, '#c id' cancels the job\n"), (unsigned int)u32WaitedMs);
+                    break;
+                }
+            }
+        }
+        pthread_mutex_unlock(&m_sJobsLock);
+    }
+} /* m_JobsWait() */
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_JobsCancel(const char *pstrArgs)
+{
+    BIGNUM_T numVal = 0;
+    job_s *psJob = nullptr;
+
+    while(uSHELL_KEY_SPACE == *pstrArgs) {
+        ++pstrArgs;
+    }
+    pthread_mutex_lock(&m_sJobsLock);
+    if((true == asc2int(pstrArgs, &numVal)) && (nullptr != (psJob = m_JobsFind((int)numVal)))) {
+        if(uSHELL_JOB_QUEUED == psJob->eState) {
+            psJob->eState = uSHELL_JOB_CANCELLED;   /* never started */
+            pthread_cond_broadcast(&m_sJobsCond);
+        }
+        psJob->bCancel = true;      /* a running command stops at its next check */
+    }
+    pthread_mutex_unlock(&m_sJobsLock);
+
+    if(nullptr == psJob) {
+        m_CorePrintMessage(11, 3); /* job noentry */
+    }
+} /* m_JobsCancel() */
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_JobsReport(void)
+{
+    /* the finished jobs are reported once, before the next prompt */
+    pthread_mutex_lock(&m_sJobsLock);
+    for(unsigned int i = 0; i < uSHELL_JOBS_MAX; ++i) {
+        job_s *psJob = &m_vsJobs[i];
+        if(false == psJob->bReported) {
+            if(uSHELL_JOB_DONE == psJob->eState) {
+                uSHELL_PRINTF(FRMT(uSHELL_SUCCESS_COLOR, "\r[%d] done %s => %d (0x%X)\n"), psJob->iId, psJob->sCommand.pstrFctName, psJob->iRetVal, psJob->iRetVal);
+                psJob->bReported = true;
+            } else if(uSHELL_JOB_CANCELLED == psJob->eState) {
+                uSHELL_PRINTF(FRMT(uSHELL_WARNING_COLOR, "\r[%d] cancelled %s\n"), psJob->iId, psJob->sCommand.pstrFctName);
+                psJob->bReported = true;
+            }
+        }
+    }
+    pthread_mutex_unlock(&m_sJobsLock);
+} /* m_JobsReport() */
+#endif /*(1 == uSHELL_IMPLEMENTS_JOBS)*/
+
+
+#if (1 == uSHELL_IMPLEMENTS_COROUTINES)
+/*==============================================================================
+                    TASKS: COROUTINE COMMANDS
+==============================================================================*/
+
+
+/*----------------------------------------------------------------------------*/
+bool Microshell::m_TaskSpawn(void)
+{
+    bool bRetVal = false;
+
+    if(nullptr != m_pInst->pfSpawn) {
+        /* the coroutine outlives the command line */
+        m_CoreCopyCommand(&m_sTaskCommand, m_vstrTaskInput, &m_sCommand, m_pstrInput);
+        const int iRetVal = m_pInst->pfSpawn(&m_sTaskCommand, &m_sTask);
+        if(uSHELL_ERR_ITEM_NOT_FOUND != iRetVal) {
+            if(uSHELL_ERR_OK == iRetVal) {
+                m_eInputState = uSHELL_INPUT_TASK;
+            } else {
+                m_CorePrintError(iRetVal);
+            }
+            bRetVal = true;
+        }
+    }
+    return bRetVal;
+} /* m_TaskSpawn() */
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_TaskStep(void)
+{
+    /* one chunk at a time, and only if the chunk announced by co_yield fits in the TX path */
+    if(uSHELL_INPUT_TASK == m_eInputState) {
+        if(m_CoreTxFree() >= m_sTask.TxNeeded()) {
+            const printSink_s sPrevSink = uShellSetPrintSink({ m_CoreSinkWrite, this });
+            m_sTask.Resume();
+            uShellSetPrintSink(sPrevSink);
+        }
+        if(true == m_sTask.Done()) {
+            m_TaskEnd(false);
+        }
+    }
+} /* m_TaskStep() */
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_TaskInput(const char cByte)
+{
+    /* the type-ahead is dropped while the coroutine runs */
+    if(uSHELL_KEY_CTRL_C == cByte) {
+        m_TaskEnd(true);
+    }
+} /* m_TaskInput() */
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_TaskEnd(const bool bCancelled)
+{
+    if(true == bCancelled) {
+        uSHELL_PRINTF(FRMT(uSHELL_WARNING_COLOR, "\r^C %s cancelled\n"), m_sTaskCommand.pstrFctName);
+    } else {
+        const int iRetVal = m_sTask.RetVal();
+        if(iRetVal >= 0) {
+            uSHELL_PRINTF(FRMT(uSHELL_SUCCESS_COLOR, "\r=> %d (0x%X)\n"), iRetVal, iRetVal);
+        } else {
+            m_sCommand = m_sTaskCommand;
+            m_CorePrintError(iRetVal);    /* execution errors */
+        }
+    }
+    m_sTask.Destroy();    /* a suspended coroutine is cancelled here */
+    m_eInputState = uSHELL_INPUT_KEY;
+#if (1 == uSHELL_IMPLEMENTS_DISABLE_ECHO)
+    if(true == m_bEchoOn) {
+        m_CorePrintPrompt();
+    }
+#else
+    m_CorePrintPrompt();
+#endif /* (1 == uSHELL_IMPLEMENTS_DISABLE_ECHO) */
+} /* m_TaskEnd() */
+#endif /*(1 == uSHELL_IMPLEMENTS_COROUTINES)*/
+
+
+#if (1 == uSHELL_IMPLEMENTS_LOG_SINK)
+/*==============================================================================
+                    LOG SINK: OUTPUT MULTIPLEXER
+==============================================================================*/
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_LogFlush(void)
+{
+    char vstrMsg[uSHELL_LOG_MSG_LEN];
+
+    /* a question or the key decoder owns the line until answered */
+    bool bFlush = (uSHELL_INPUT_CONFIRM != m_eInputState) && (uSHELL_INPUT_KEYDECODER != m_eInputState);
+    if((true == bFlush) && (true == uShellLogGet(vstrMsg, sizeof(vstrMsg)))) {
+        /* the prompt and the input are redrawn only if they are on the screen */
+        bool bRedraw = true;
+#if (1 == uSHELL_IMPLEMENTS_COROUTINES)
+        bRedraw = bRedraw && (uSHELL_INPUT_TASK != m_eInputState);
+#endif /*(1 == uSHELL_IMPLEMENTS_COROUTINES)*/
+#if (1 == uSHELL_IMPLEMENTS_DISABLE_ECHO)
+        bRedraw = bRedraw && (true == m_bEchoOn);
+#endif /* (1 == uSHELL_IMPLEMENTS_DISABLE_ECHO) */
+
+        /* one burst: erase the line, print the logs, redraw the line */
+        m_CorePutString("\033[?25l\r\033[K"); /* hide cursor, erase line */
+        unsigned int uNrMsgs = 0;
+        do {
+            uSHELL_PRINTF("%s" uSHELL_NEWLINE, vstrMsg);
+        } while((++uNrMsgs < uSHELL_LOG_SLOTS) && (true == uShellLogGet(vstrMsg, sizeof(vstrMsg))));
+        const unsigned int uDropped = uShellLogDropped();
+        if(uDropped > 0) {
+            uSHELL_PRINTF(FRMT(uSHELL_WARNING_COLOR, "[%u log messages dropped]") uSHELL_NEWLINE, uDropped);
+        }
+        if(true == bRedraw) {
+            m_LogRedraw();
+        }
+        m_CorePutString("\033[?25h"); /* show cursor */
+    }
+} /* m_LogFlush() */
+#endif /*(1 == uSHELL_IMPLEMENTS_LOG_SINK)*/
+
+
+#if ((1 == uSHELL_IMPLEMENTS_LOG_SINK) || (1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS))
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_LogRedraw(void)
+{
+    m_CorePrintPrompt();
+    m_CorePutString(m_pstrInput);
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE)
+    if(true == m_bEditMode) {
+#if !defined(uSHELL_EDIT_MODE_DEFAULT_ACTIVE)
+        /* the edit mode marks the prompt, see m_CoreHandleKeyInsert() */
+#if (1 == uSHELL_IMPLEMENTS_SMART_PROMPT)
+        uSHELL_PRINTF(FRMT(uSHELL_PROMPT_COLOR, "\r%s"), m_pstrPromptInfoEditMode);
+#else /* (0 == uSHELL_IMPLEMENTS_SMART_PROMPT) */
+        uSHELL_PRINTF(FRMT(uSHELL_PROMPT_COLOR, "\r%c"), 'E');
+#endif /* (1 == uSHELL_IMPLEMENTS_SMART_PROMPT) */
+#endif /* !defined(uSHELL_EDIT_MODE_DEFAULT_ACTIVE) */
+        uSHELL_PRINTF("\r\033[%dC", m_iPromptLength + m_iCursorPos);
+    }
+#endif /* (1 == uSHELL_IMPLEMENTS_EDITMODE) */
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_SUGGEST)
+    m_sHistory.iSuggestSlot = uSHELL_INVALID_VALUE;    /* erased with the line */
+    m_HistorySuggestShow();
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY_SUGGEST)*/
+} /* m_LogRedraw() */
+#endif /*((1 == uSHELL_IMPLEMENTS_LOG_SINK) || (1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS))*/
+
+
+#if (1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS)
+/*==============================================================================
+                    POSTED COMMANDS: INPUT MULTIPLEXER
+==============================================================================*/
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_PostRun(void)
+{
+    /* a question, the key decoder or a coroutine owns the line until done */
+    bool bRun = (uSHELL_INPUT_CONFIRM != m_eInputState) && (uSHELL_INPUT_KEYDECODER != m_eInputState);
+#if (1 == uSHELL_IMPLEMENTS_COROUTINES)
+    bRun = bRun && (uSHELL_INPUT_TASK != m_eInputState);
+#endif /*(1 == uSHELL_IMPLEMENTS_COROUTINES)*/
+    postedCmd_s *psPosted = (true == bRun) ? m_sPostQueue.Front() : nullptr;
+
+    if(nullptr != psPosted) {
+        bool bRedraw = true;
+#if (1 == uSHELL_IMPLEMENTS_DISABLE_ECHO)
+        bRedraw = (true == m_bEchoOn);
+#endif /* (1 == uSHELL_IMPLEMENTS_DISABLE_ECHO) */
+
+        /* the edited line is kept aside: the commands run above it, then it is redrawn */
+        m_CorePutString("\r\033[K");
+        unsigned int uNrCmds = 0;
+        do {
+            const command_s *psCommand = &psPosted->sParsed.sCommand;
+            uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR, "[posted] %s") uSHELL_NEWLINE, psCommand->pstrFctName);
+            const int iRetVal = m_CoreExec(psCommand);
+            if(iRetVal >= 0) {
+                uSHELL_PRINTF(FRMT(uSHELL_SUCCESS_COLOR, "\r=> %d (0x%X)\n"), iRetVal, iRetVal);
+            } else {
+                m_sCommand = *psCommand;        /* the error names the posted command, not the last typed one */
+                m_CorePrintError(iRetVal);
+            }
+            if(nullptr != psPosted->pfDone) {
+                psPosted->pfDone(psPosted->pvCtx, iRetVal);
+            }
+            m_sPostQueue.Pop();
+        } while((++uNrCmds < uSHELL_POST_SLOTS) && (nullptr != (psPosted = m_sPostQueue.Front())));
+        if(true == bRedraw) {
+            m_LogRedraw();
+        }
+    }
+} /* m_PostRun() */
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_PostFutureDone(void *pvCtx, const int iRetVal)
+{
+    postFuture_s *psFuture = (postFuture_s*)pvCtx;
+
+    psFuture->iRetVal = iRetVal;
+    psFuture->bDone.store(true, std::memory_order_release);
+} /* m_PostFutureDone() */
+#endif /*(1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS)*/
+
+
+#if (1 == uSHELL_IMPLEMENTS_TIME_STATS)
+/*==============================================================================
+                    STATS: EXECUTION TIMING, KEY LATENCY
+==============================================================================*/
+
+
+/*----------------------------------------------------------------------------*/
+inline void Microshell::m_StatsAdd(timeStats_s *psStats, const uint32_t u32Ticks)
+{
+    /* runs after every command and every key: no division, the bucket is half of the bit length */
+    const uint32_t u32Bucket = (0U == u32Ticks) ? 0U : ((33U - (uint32_t)__builtin_clz(u32Ticks)) >> 1);
+
+    ++psStats->u32Count;
+    psStats->u64Sum += u32Ticks;
+    if(u32Ticks < psStats->u32Min) {
+        psStats->u32Min = u32Ticks;
+    }
+    if(u32Ticks > psStats->u32Max) {
+        psStats->u32Max = u32Ticks;
+    }
+    ++psStats->vu32Hist[(u32Bucket < uSHELL_STATS_BUCKETS) ? u32Bucket : (uSHELL_STATS_BUCKETS - 1U)];
+} /* m_StatsAdd() */
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_StatsClear(timeStats_s *psStats, const int iNrStats)
+{
+    memset(psStats, 0, iNrStats * sizeof(timeStats_s));
+    for(int i = 0; i < iNrStats; ++i) {
+        psStats[i].u32Min = UINT32_MAX;
+    }
+} /* m_StatsClear() */
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_StatsPrintTime(const uint64_t u64Ticks)
+{
+    const uint64_t u64Ns = (u64Ticks * 1000U) / uSHELL_TICKS_PER_US;
+
+    if(u64Ns < 10000U) {
+        uSHELL_PRINTF(" %6u ns", (unsigned int)u64Ns);
+    } else if(u64Ns < 10000000U) {
+        uSHELL_PRINTF(" %6u us", (unsigned int)(u64Ns / 1000U));
+    } else {
+        uSHELL_PRINTF(" %6u ms", (unsigned int)(u64Ns / 1000000U));
+    }
+} /* m_StatsPrintTime() */
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_StatsPrintRow(const char *pstrName, const timeStats_s *psStats)
+{
+    uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR, "%15s %8u"), pstrName, (unsigned int)psStats->u32Count);
+    m_StatsPrintTime(psStats->u32Min);
+    m_StatsPrintTime(psStats->u64Sum / psStats->u32Count);
+    m_StatsPrintTime(psStats->u32Max);
+    m_StatsPrintTime(psStats->u64Sum);
+    uSHELL_PRINTF("\n%15s", "<");
+    /* upper bounds of the non empty buckets */
+    for(unsigned int k = 0; k < uSHELL_STATS_BUCKETS; ++k) {
+        if(0U != psStats->vu32Hist[k]) {
+            if(k < (uSHELL_STATS_BUCKETS - 1U)) {
+                m_StatsPrintTime((uint64_t)1U << (2U * k));
+            } else {
+                uSHELL_PRINTF(" %9s", "more");
+            }
+            uSHELL_PRINTF(":%u", (unsigned int)psStats->vu32Hist[k]);
+        }
+    }
+    uSHELL_PRINTF("\n");
+} /* m_StatsPrintRow() */
+#endif /*(1 == uSHELL_IMPLEMENTS_TIME_STATS)*/
+
+
+#if ((1 == uSHELL_IMPLEMENTS_EXEC_STATS) || (1 == uSHELL_IMPLEMENTS_KEY_LATENCY))
+/*----------------------------------------------------------------------------*/
+void Microshell::m_StatsShow(const char *pstrArgs)
+{
+    while(uSHELL_KEY_SPACE == *pstrArgs) {
+        ++pstrArgs;
+    }
+    const char cSort = *pstrArgs;
+    const bool bSingle = ('\0' == cSort) || ('\0' == *(pstrArgs + 1));
+
+    if((false == bSingle) || (nullptr == strchr("nmxrk", cSort))) {
+        m_CorePrintMessage(8, 8); /* args unsupported */
+    } else if('r' == cSort) {
+#if (1 == uSHELL_IMPLEMENTS_EXEC_STATS)
+        if(nullptr != m_psStats) {
+            m_StatsClear(m_psStats, m_pInst->iNrFunctions);
+        }
+#endif /*(1 == uSHELL_IMPLEMENTS_EXEC_STATS)*/
+#if (1 == uSHELL_IMPLEMENTS_KEY_LATENCY)
+        m_StatsClear(m_vsKeyLat, uSHELL_KEYCLASS_LAST);
+#endif /*(1 == uSHELL_IMPLEMENTS_KEY_LATENCY)*/
+        m_CorePrintMessage(12, 6); /* stats reset */
+    } else if('k' == cSort) {
+#if (1 == uSHELL_IMPLEMENTS_KEY_LATENCY)
+        m_StatsShowKeys();
+#else
+        m_CorePrintMessage(8, 8); /* args unsupported */
+#endif /*(1 == uSHELL_IMPLEMENTS_KEY_LATENCY)*/
+    } else {
+#if (1 == uSHELL_IMPLEMENTS_EXEC_STATS)
+        m_StatsShowCommands(cSort);
+#else
+        m_CorePrintMessage(8, 8); /* args unsupported */
+#endif /*(1 == uSHELL_IMPLEMENTS_EXEC_STATS)*/
+    }
+} /* m_StatsShow() */
+#endif /*((1 == uSHELL_IMPLEMENTS_EXEC_STATS) || (1 == uSHELL_IMPLEMENTS_KEY_LATENCY))*/
+
+
+#if (1 == uSHELL_IMPLEMENTS_EXEC_STATS)
+/*----------------------------------------------------------------------------*/
+void Microshell::m_StatsInit(void)
+{
+    m_psStats = (timeStats_s*)uSHELL_MALLOC(m_pInst->iNrFunctions * sizeof(timeStats_s), uSHELL_HEAP_STATS);
+    if(nullptr != m_psStats) {
+        m_StatsClear(m_psStats, m_pInst->iNrFunctions);
+    } else {
+        m_CorePrintMessage(7, 4); /* malloc failed */
+    }
+} /* m_StatsInit() */
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_StatsDeinit(void)
+{
+    uSHELL_FREE(m_psStats);
+    m_psStats = nullptr;
+} /* m_StatsDeinit() */
+
+
+/*----------------------------------------------------------------------------*/
+uint64_t Microshell::m_StatsSortKey(const int iFctIndex, const char cSort)
+{
+    const timeStats_s *psStats = &m_psStats[iFctIndex];
+
+    switch(cSort) {
+        case 'n': return psStats->u32Count;
+        case 'm': return psStats->u64Sum / psStats->u32Count;
+        case 'x': return psStats->u32Max;
+        default : return psStats->u64Sum;
+    }
+} /* m_StatsSortKey() */
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_StatsShowCommands(const char cSort)
+{
+    int *piOrder = nullptr;
+
+    if(nullptr == m_psStats) {
+        m_CorePrintMessage(12, 7); /* stats uninitialized */
+    } else if(nullptr == (piOrder = (int*)uSHELL_MALLOC(m_pInst->iNrFunctions * sizeof(int), uSHELL_HEAP_STATS))) {
+        m_CorePrintMessage(7, 4); /* malloc failed */
+    } else {
+        /* the commands which ran, sorted in descending order of the key */
+        int iNrRows = 0;
+        for(int i = 0; i < m_pInst->iNrFunctions; ++i) {
+            if(0U != m_psStats[i].u32Count) {
+                const uint64_t u64Key = m_StatsSortKey(i, cSort);
+                int iPos = iNrRows++;
+                while((iPos > 0) && (m_StatsSortKey(piOrder[iPos - 1], cSort) < u64Key)) {
+                    piOrder[iPos] = piOrder[iPos - 1];
+                    --iPos;
+                }
+                piOrder[iPos] = i;
+            }
+        }
+        if(0 == iNrRows) {
+            m_CorePrintMessage(12, 5); /* stats empty */
+        } else {
+            uSHELL_PRINTF(FRMT(uSHELL_INFO_HEADER_COLOR, "%15s %8s %9s %9s %9s %9s\n"), "command", "calls", "min", "mean", "max", "total");
+        }
+        for(int iRow = 0; iRow < iNrRows; ++iRow) {
+            m_StatsPrintRow(m_pInst->psFuncDefArray[piOrder[iRow]].pstrFctName, &m_psStats[piOrder[iRow]]);
+        }
+        uSHELL_FREE(piOrder);
+    }
+} /* m_StatsShowCommands() */
+#endif /*(1 == uSHELL_IMPLEMENTS_EXEC_STATS)*/
+
+
+#if (1 == uSHELL_IMPLEMENTS_KEY_LATENCY)
+/*----------------------------------------------------------------------------*/
+keyClass_e Microshell::m_KeyLatClass(const char cByte)
+{
+    /* decided before the byte changes the input state; the prefix of a sequence is not measured */
+    keyClass_e eClass = uSHELL_KEYCLASS_LAST;
+
+    switch(m_eInputState) {
+#if !(defined(__MINGW32__) || defined(_MSC_VER))
+        case uSHELL_INPUT_ESC_TILDE: {
+                eClass = (uSHELL_KEY_TILDE == cByte) ? uSHELL_KEYCLASS_EDIT : uSHELL_KEYCLASS_LAST;
+            }
+            break;
+#endif /*!(defined(__MINGW32__) || defined(_MSC_VER))*/
+        case uSHELL_INPUT_ESC_KEY: {
+                if(true == uSHELL_ESCSEQ_HAS_TILDE(cByte)) {
+                    eClass = uSHELL_KEYCLASS_LAST;
+                } else if((uSHELL_KEY_ESCAPESEQ_ARROW_UP == cByte) || (uSHELL_KEY_ESCAPESEQ_ARROW_DOWN == cByte)) {
+                    eClass = uSHELL_KEYCLASS_HISTORY;
+                } else if((uSHELL_KEY_ESCAPESEQ_ARROW_LEFT == cByte) || (uSHELL_KEY_ESCAPESEQ_ARROW_RIGHT == cByte)) {
+                    eClass = uSHELL_KEYCLASS_AUTOCOMPLETE;
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE)
+                    if(true == m_bEditMode) {
+                        eClass = uSHELL_KEYCLASS_EDIT;
+                    }
+#endif /*(1 == uSHELL_IMPLEMENTS_EDITMODE)*/
+                } else {
+                    eClass = uSHELL_KEYCLASS_EDIT;
+                }
+            }
+            break;
+        case uSHELL_INPUT_KEY: {
+                if(true == uSHELL_ISPRINT(cByte)) {
+                    eClass = uSHELL_KEYCLASS_PRINTABLE;
+                } else if(uSHELL_KEY_ENTER == cByte) {
+                    eClass = uSHELL_KEYCLASS_ENTER;
+                } else if((uSHELL_KEY_ESCAPESEQ == cByte)
+#if (defined(__MINGW32__) || defined(_MSC_VER))
+                          || (uSHELL_KEY_ESCAPESEQ1 == cByte)
+#endif /*(defined(__MINGW32__) || defined(_MSC_VER)) */
+                         ) {
+                    eClass = uSHELL_KEYCLASS_LAST;
+                } else if((uSHELL_KEY_BACKSPACE == cByte) || (uSHELL_KEY_TAB == cByte)
+#if ( defined(SERIAL_TERMINAL) && !defined(__AVR__) )
+                          || (uSHELL_KEY_DELETE == cByte) || (uSHELL_KEY_INSERT == cByte)
+#endif /* ( defined(SERIAL_TERMINAL) && !defined(__AVR__)) ) */
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE)
+                          || (uSHELL_KEY_CTRL_U == cByte) || (uSHELL_KEY_CTRL_K == cByte)
+#endif /* (1 == uSHELL_IMPLEMENTS_EDITMODE) */
+                         ) {
+                    eClass = uSHELL_KEYCLASS_EDIT;
+                } else {
+                    eClass = uSHELL_KEYCLASS_OTHER;
+                }
+            }
+            break;
+        default: {
+                eClass = uSHELL_KEYCLASS_LAST; /* ESC, or the input is taken by a request, a task or the decoder */
+            }
+            break;
+    }
+    return eClass;
+} /* m_KeyLatClass() */
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_StatsShowKeys(void)
+{
+    static const char *vstrNames[uSHELL_KEYCLASS_LAST] = { "printable", "autocomplete", "history", "edit", "enter", "other" };
+    bool bHeader = false;
+
+    for(int i = 0; i < uSHELL_KEYCLASS_LAST; ++i) {
+        if(0U != m_vsKeyLat[i].u32Count) {
+            if(false == bHeader) {
+                uSHELL_PRINTF(FRMT(uSHELL_INFO_HEADER_COLOR, "%15s %8s %9s %9s %9s %9s\n"), "key", "keys", "min", "mean", "max", "total");
+                bHeader = true;
+            }
+            m_StatsPrintRow(vstrNames[i], &m_vsKeyLat[i]);
+        }
+    }
+    if(false == bHeader) {
+        m_CorePrintMessage(12, 5); /* stats empty */
+    }
+} /* m_StatsShowKeys() */
+#endif /*(1 == uSHELL_IMPLEMENTS_KEY_LATENCY)*/
+
+
+#if (1 == uSHELL_IMPLEMENTS_BENCH)
+/*==============================================================================
+                    BENCH: COMMAND BENCHMARK
+==============================================================================*/
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_BenchRun(const char *pstrArgs)
+{
+    /* #b [p] n cmd args : the samples are kept to get the percentiles, only the ticks are read inside the loop */
+    char vstrLine[uSHELL_MAX_INPUT_BUF_LEN];
+    char vstrWork[uSHELL_MAX_INPUT_BUF_LEN];
+    uint32_t *pu32Exec = nullptr;
+    uint32_t *pu32Parse = nullptr;
+    BIGNUM_T numRuns = 0;
+    bool bReparse = false;
+    char *pstrRest = vstrLine;
+
+    strncpy(vstrLine, pstrArgs, uSHELL_MAX_INPUT_BUF_LEN - 1);
+    vstrLine[uSHELL_MAX_INPUT_BUF_LEN - 1] = '\0';
+    char *pstrToken = strtok_ex(pstrRest, m_pstrTokenSeparator, &pstrRest);
+    if((nullptr != pstrToken) && (0 == strcmp(pstrToken, "p"))) {
+        bReparse = true;
+        pstrToken = strtok_ex(pstrRest, m_pstrTokenSeparator, &pstrRest);
+    }
+
+    if((nullptr == pstrToken) || (nullptr == pstrRest) || (false == asc2int(pstrToken, &numRuns)) || (0 == numRuns) || (numRuns > uSHELL_BENCH_MAX_RUNS)) {
+        m_CorePrintMessage(8, 8); /* args unsupported */
+    } else if((nullptr == (pu32Exec = (uint32_t*)uSHELL_MALLOC((size_t)numRuns * sizeof(uint32_t), uSHELL_HEAP_BENCH))) ||
+              ((true == bReparse) && (nullptr == (pu32Parse = (uint32_t*)uSHELL_MALLOC((size_t)numRuns * sizeof(uint32_t), uSHELL_HEAP_BENCH))))) {
+        m_CorePrintMessage(7, 4); /* malloc failed */
+    } else {
+        uint32_t u32NrRuns = (uint32_t)numRuns;
+        uint64_t u64Wall = 0U;
+        int iParse = uSHELL_ERR_OK;
+        int iExec = uSHELL_ERR_OK;
+        bool bOverrun = false;
+
+        /* the parse splits the line in place, a reparse starts from a fresh copy; the errors are reported from m_sCommand */
+        memset(&m_sCommand, 0, sizeof(m_sCommand));
+        strcpy(vstrWork, pstrRest);
+        iParse = m_CoreParseCommand(vstrWork, &m_sCommand);
+#if (1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT)
+        /* every run gets the budget of the command, the first one spending it ends the benchmark */
+        const uint32_t u32BudgetMs = (uSHELL_ERR_OK == iParse) ? m_pInst->pfBudget(m_sCommand.iFctIndex) : 0U;
+        uint32_t u32ElapsedMs = 0U;
+#endif /*(1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT)*/
+        for(uint32_t u32Run = 0U; (uSHELL_ERR_OK == iParse) && (iExec >= 0) && (false == bOverrun) && (u32Run < u32NrRuns); ++u32Run) {
+            uint32_t u32Start = 0U;
+            if(true == bReparse) {
+                memset(&m_sCommand, 0, sizeof(m_sCommand));
+                strcpy(vstrWork, pstrRest);
+                u32Start = uShellTicks();
+                iParse = m_CoreParseCommand(vstrWork, &m_sCommand);
+                pu32Parse[u32Run] = uShellTicks() - u32Start;
+                u64Wall += pu32Parse[u32Run];
+            }
+            if(uSHELL_ERR_OK == iParse) {
+#if (1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT)
+                uShellDeadlineArm(u32BudgetMs);
+#endif /*(1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT)*/
+                const printSink_s sPrevSink = uShellSetPrintSink({ m_CoreSinkWrite, this });
+                u32Start = uShellTicks();
+                iExec = m_pInst->pfExec(&m_sCommand);
+                pu32Exec[u32Run] = uShellTicks() - u32Start;
+                uShellSetPrintSink(sPrevSink);
+                u64Wall += pu32Exec[u32Run];
+#if (1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT)
+                bOverrun = uShellDeadlineDisarm(&u32ElapsedMs);
+                if(true == bOverrun) {
+                    u32NrRuns = u32Run + 1U;    /* the statistics of the runs done */
+                }
+#endif /*(1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT)*/
+            }
+        }
+
+        if(uSHELL_ERR_OK != iParse) {
+            m_CorePrintError(iParse);    /* parsing errors */
+        } else if(iExec < 0) {
+            m_CorePrintError(iExec);     /* execution errors */
+        } else {
+#if (1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT)
+            if(true == bOverrun) {
+                uSHELL_PRINTF(FRMT(uSHELL_WARNING_COLOR, "[overrun] %s: %u ms (budget %u ms), stopped after run %u\n"), m_sCommand.pstrFctName, (unsigned int)u32ElapsedMs, (unsigned int)u32BudgetMs, (unsigned int)u32NrRuns);
+            }
+#endif /*(1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT)*/
+            uSHELL_PRINTF(FRMT(uSHELL_INFO_BODY_COLOR, "%s: %u runs in"), m_sCommand.pstrFctName, (unsigned int)u32NrRuns);
+            m_StatsPrintTime(u64Wall);
+            uSHELL_PRINTF(FRMT(uSHELL_INFO_BODY_COLOR, ", %u runs/s\n"), (unsigned int)(((uint64_t)u32NrRuns * 1000000U * uSHELL_TICKS_PER_US) / ((0U != u64Wall) ? u64Wall : 1U)));
+            uSHELL_PRINTF(FRMT(uSHELL_INFO_HEADER_COLOR, "%15s %9s %9s %9s %9s %9s %9s\n"), "phase", "min", "p50", "p90", "p99", "max", "mean");
+            if(true == bReparse) {
+                m_BenchPrintRow("parse", pu32Parse, u32NrRuns);
+            }
+            m_BenchPrintRow("exec", pu32Exec, u32NrRuns);
+        }
+    }
+    memset(&m_sCommand, 0, sizeof(m_sCommand));    /* it pointed into the local copy of the line */
+    uSHELL_FREE(pu32Parse);
+    uSHELL_FREE(pu32Exec);
+} /* m_BenchRun() */
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_BenchPrintRow(const char *pstrPhase, uint32_t *pu32Samples, const uint32_t u32NrRuns)
+{
+    /* nearest rank percentiles of the sorted samples */
+    uint64_t u64Sum = 0U;
+
+    qsort(pu32Samples, u32NrRuns, sizeof(uint32_t), m_BenchCompare);
+    for(uint32_t i = 0; i < u32NrRuns; ++i) {
+        u64Sum += pu32Samples[i];
+    }
+    uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR, "%15s"), pstrPhase);
+    m_StatsPrintTime(pu32Samples[0]);
+    m_StatsPrintTime(pu32Samples[((u32NrRuns * 50U) - 1U) / 100U]);
+    m_StatsPrintTime(pu32Samples[((u32NrRuns * 90U) - 1U) / 100U]);
+    m_StatsPrintTime(pu32Samples[((u32NrRuns * 99U) - 1U) / 100U]);
+    m_StatsPrintTime(pu32Samples[u32NrRuns - 1U]);
+    m_StatsPrintTime(u64Sum / u32NrRuns);
+    uSHELL_PRINTF("\n");
+} /* m_BenchPrintRow() */
+
+
+/*----------------------------------------------------------------------------*/
+int Microshell::m_BenchCompare(const void *pvA, const void *pvB)
+{
+    const uint32_t u32A = *(const uint32_t*)pvA;
+    const uint32_t u32B = *(const uint32_t*)pvB;
+
+    return (u32A > u32B) - (u32A < u32B);
+} /* m_BenchCompare() */
+#endif /*(1 == uSHELL_IMPLEMENTS_BENCH)*/
+
+
+#if (1 == uSHELL_IMPLEMENTS_TRACE)
+/*----------------------------------------------------------------------------*/
+inline void Microshell::m_TraceRecord(const traceEvent_e eEvent, const uint16_t u16Arg)
+{
+    /* single writer (the shell loop), the oldest record is overwritten */
+    traceRec_s *psRec = &m_vsTrace[m_u32TraceHead & (uSHELL_TRACE_RECORDS - 1U)];
+
+    psRec->u32Ticks   = uShellTicks();
+    psRec->u16Arg     = u16Arg;
+    psRec->u8Event    = (uint8_t)eEvent;
+    psRec->u8Reserved = 0U;
+    ++m_u32TraceHead;
+} /* m_TraceRecord() */
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_TraceShow(const char *pstrArgs)
+{
+    bool bBinaryOk = true;
+#if ((1 == uSHELL_IMPLEMENTS_UART_STATS) || (1 == uSHELL_IMPLEMENTS_UART_CONFIG))
+    /* the dump is raw bytes: with XON/XOFF the terminal would take its 0x11/0x13 as flow control */
+    uart_format_t sFormat;
+    uart_baud_t sRate;
+    uart_config_get(&sFormat, &sRate);
+    bBinaryOk = (UART_FLOW_XON_XOFF != sFormat.flow);
+#endif /*((1 == uSHELL_IMPLEMENTS_UART_STATS) || (1 == uSHELL_IMPLEMENTS_UART_CONFIG))*/
+
+    while(uSHELL_KEY_SPACE == *pstrArgs) {
+        ++pstrArgs;
+    }
+
+    if(('\0' == *pstrArgs) && (false == bBinaryOk)) {
+        uSHELL_PRINTF(FRMT(uSHELL_WARNING_COLOR, "trace : the binary dump needs a console without xon/xoff, i.e. '#B <baud> 8N1 n'\n"));
+    } else if('\0' == *pstrArgs) {
+        m_TraceDump();
+    } else if(('c' == *pstrArgs) && ('\0' == *(pstrArgs + 1))) {
+        m_u32TraceHead = 0U;
+        m_CorePrintMessage(13, 6); /* trace reset */
+    } else {
+        m_CorePrintMessage(8, 8); /* args unsupported */
+    }
+} /* m_TraceShow() */
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_TraceDump(void)
+{
+    /* raw frame (see ushell_core_datatypes.h), found by the host tool in the captured console output */
+    const uint32_t u32NrRecords = (m_u32TraceHead < uSHELL_TRACE_RECORDS) ? m_u32TraceHead : uSHELL_TRACE_RECORDS;
+
+    for(const char *pstrMagic = uSHELL_TRACE_MAGIC; '\0' != *pstrMagic; ++pstrMagic) {
+        m_CorePutch(*pstrMagic);
+    }
+    m_TracePut(uSHELL_TRACE_VERSION, 1);
+    m_TracePut(sizeof(traceRec_s), 1);
+    m_TracePut(u32NrRecords, 2);
+    m_TracePut(uSHELL_TICKS_PER_US, 4);
+    for(uint32_t i = m_u32TraceHead - u32NrRecords; i != m_u32TraceHead; ++i) {
+        const traceRec_s *psRec = &m_vsTrace[i & (uSHELL_TRACE_RECORDS - 1U)];
+        m_TracePut(psRec->u32Ticks, 4);
+        m_TracePut(psRec->u16Arg, 2);
+        m_TracePut(psRec->u8Event, 1);
+        m_TracePut(psRec->u8Reserved, 1);
+    }
+    /* the names resolve the command index of the dispatch events */
+    m_TracePut((uint32_t)m_pInst->iNrFunctions, 2);
+    for(int i = 0; i < m_pInst->iNrFunctions; ++i) {
+        const char *pstrName = m_pInst->psFuncDefArray[i].pstrFctName;
+        do {
+            m_CorePutch(*pstrName);
+        } while('\0' != *pstrName++);
+    }
+    for(const char *pstrEnd = uSHELL_TRACE_END; '\0' != *pstrEnd; ++pstrEnd) {
+        m_CorePutch(*pstrEnd);
+    }
+    uSHELL_PRINTF(uSHELL_NEWLINE);
+} /* m_TraceDump() */
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_TracePut(const uint32_t u32Value, const int iNrBytes)
+{
+    /* little endian, independent of the target */
+    for(int i = 0; i < iNrBytes; ++i) {
+        m_CorePutch((char)((u32Value >> (8 * i)) & 0xFFU));
+    }
+} /* m_TracePut() */
+#endif /*(1 == uSHELL_IMPLEMENTS_TRACE)*/
+
+
+#if (1 == uSHELL_IMPLEMENTS_HEAP_STATS)
+/*==============================================================================
+                    HEAP: ALLOCATIONS OF THE SHELL AND OF ITS COMMANDS
+==============================================================================*/
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_HeapShow(const char *pstrArgs)
+{
+    while(uSHELL_KEY_SPACE == *pstrArgs) {
+        ++pstrArgs;
+    }
+
+    if(('r' == *pstrArgs) && ('\0' == *(pstrArgs + 1))) {
+        uShellHeapResetPeaks();
+        m_CorePrintMessage(14, 6); /* heap reset */
+    } else if('\0' != *pstrArgs) {
+        m_CorePrintMessage(8, 8); /* args unsupported */
+    } else {
+        /* shared by all the instances and the jobs, the rows are read one by one */
+        heapStats_s sHeap;
+        uSHELL_PRINTF(FRMT(uSHELL_INFO_HEADER_COLOR, "%10s %8s %8s %8s %10s %10s\n"), "site", "allocs", "frees", "failed", "current", "peak");
+        for(int i = 0; i <= uSHELL_HEAP_SITE_LAST; ++i) {
+            uShellHeapGet(i, &sHeap);
+            if((0U != sHeap.u32Allocs) || (0U != sHeap.u32Failed) || (uSHELL_HEAP_SITE_LAST == i)) {
+                uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR, "%10s %8u %8u %8u %10u %10u\n"), uShellHeapSiteName(i), (unsigned int)sHeap.u32Allocs, (unsigned int)sHeap.u32Frees,
+                              (unsigned int)sHeap.u32Failed, (unsigned int)sHeap.szCurrent, (unsigned int)sHeap.szPeak);
+            }
+        }
+        const size_t szLargest = uShellHeapLargestFree();
+        if(0U != szLargest) {
+            uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR, "largest free block : %u bytes\n"), (unsigned int)szLargest);
+        } else {
+            uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR, "largest free block : n/a\n"));
+        }
+    }
+} /* m_HeapShow() */
+#endif /*(1 == uSHELL_IMPLEMENTS_HEAP_STATS)*/
+
+
+#if (1 == uSHELL_IMPLEMENTS_STACK_USAGE)
+/*==============================================================================
+                    STACK: HIGH-WATER MARK OF THE COMMANDS
+==============================================================================*/
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_StackInit(void)
+{
+    m_psStack = (stackUse_s*)uSHELL_MALLOC(m_pInst->iNrFunctions * sizeof(stackUse_s), uSHELL_HEAP_STACK);
+    if(nullptr != m_psStack) {
+        memset(m_psStack, 0, m_pInst->iNrFunctions * sizeof(stackUse_s));
+    } else {
+        m_CorePrintMessage(7, 4); /* malloc failed */
+    }
+} /* m_StackInit() */
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_StackDeinit(void)
+{
+    uSHELL_FREE(m_psStack);
+    m_psStack = nullptr;
+} /* m_StackDeinit() */
+
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_StackShow(const char *pstrArgs)
+{
+    while(uSHELL_KEY_SPACE == *pstrArgs) {
+        ++pstrArgs;
+    }
+
+    if(nullptr == m_psStack) {
+        m_CorePrintMessage(15, 7); /* stack uninitialized */
+    } else if(('r' == *pstrArgs) && ('\0' == *(pstrArgs + 1))) {
+        memset(m_psStack, 0, m_pInst->iNrFunctions * sizeof(stackUse_s));
+        m_CorePrintMessage(15, 6); /* stack reset */
+    } else if('\0' != *pstrArgs) {
+        m_CorePrintMessage(8, 8); /* args unsupported */
+    } else {
+        /* the deepest command sizes the stack of the task calling Run() */
+        int iDeepest = uSHELL_INVALID_VALUE;
+        for(int i = 0; i < m_pInst->iNrFunctions; ++i) {
+            const stackUse_s *psStack = &m_psStack[i];
+            if(0U != psStack->u32Calls) {
+                if(uSHELL_INVALID_VALUE == iDeepest) {
+                    uSHELL_PRINTF(FRMT(uSHELL_INFO_HEADER_COLOR, "%15s %8s %10s\n"), "command", "calls", "max stack");
+                    iDeepest = i;
+                }
+                uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR, "%15s %8u %s%9u\n"), m_pInst->psFuncDefArray[i].pstrFctName, (unsigned int)psStack->u32Calls,
+                              (psStack->bSaturated ? ">" : " "), (unsigned int)psStack->u32Max);
+                iDeepest = (psStack->u32Max > m_psStack[iDeepest].u32Max) ? i : iDeepest;
+            }
+        }
+        if(uSHELL_INVALID_VALUE == iDeepest) {
+            m_CorePrintMessage(15, 5); /* stack empty */
+        } else {
+            uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR, "deepest : %s, %u bytes below the dispatcher (up to %u painted)\n"), m_pInst->psFuncDefArray[iDeepest].pstrFctName,
+                          (unsigned int)m_psStack[iDeepest].u32Max, (unsigned int)uSHELL_STACK_PAINT_BYTES);
+        }
+        uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR, "stack free : %u bytes\n"), (unsigned int)uShellStackFree());
+    }
+} /* m_StackShow() */
+#endif /*(1 == uSHELL_IMPLEMENTS_STACK_USAGE)*/
+
+
+#if (1 == uSHELL_IMPLEMENTS_UART_STATS)
+/*----------------------------------------------------------------------------*/
+void Microshell::m_UartShow(const char *pstrArgs)
+{
+    while(uSHELL_KEY_SPACE == *pstrArgs) {
+        ++pstrArgs;
+    }
+
+    if(('r' == *pstrArgs) && ('\0' == *(pstrArgs + 1))) {
+        uart_stats_reset();
+        m_CorePrintMessage(16, 6); /* uart reset */
+    } else if('\0' != *pstrArgs) {
+        m_CorePrintMessage(8, 8); /* args unsupported */
+    } else {
+        uart_stats_t sStats;
+        uart_stats_get(&sStats);
+        uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR, "tx bytes      : %u\n"), (unsigned int)sStats.tx_bytes);
+        uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR, "rx bytes      : %u\n"), (unsigned int)sStats.rx_bytes);
+        uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR, "rx overflows  : %u\n"), (unsigned int)sStats.rx_overflows);
+        uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR, "rx dropped    : %u\n"), (unsigned int)sStats.rx_dropped);
+        uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR, "frame errors  : %u\n"), (unsigned int)sStats.frame_errors);
+        uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR, "parity errors : %u\n"), (unsigned int)sStats.parity_errors);
+        uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR, "rx ring peak  : %u bytes\n"), (unsigned int)sStats.rx_peak);
+        uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR, "xoff sent     : %u\n"), (unsigned int)sStats.xoff_sent);
+        uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR, "xoff received : %u\n"), (unsigned int)sStats.xoff_received);
+        uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR, "tx dropped    : %u\n"), (unsigned int)sStats.tx_dropped);
+        uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR, "tx wait       : %u ms\n"), (unsigned int)(sStats.tx_wait_us / 1000U));
+    }
+} /* m_UartShow() */
+#endif /*(1 == uSHELL_IMPLEMENTS_UART_STATS)*/
+
+
+#if (1 == uSHELL_IMPLEMENTS_UART_CONFIG)
+/*----------------------------------------------------------------------------*/
+void Microshell::m_UartBaud(const char *pstrArgs)
+{
+    /* #B [baud [format [flow]]] : without arguments the current setting is shown */
+    static const char vcFlow[] = { 'n', 'h', 's' };
+    static const char *vstrFlow[] = { "none", "rts/cts", "xon/xoff" };
+    char vstrLine[uSHELL_MAX_INPUT_BUF_LEN];
+    char vstrName[6];
+    char *pstrRest = vstrLine;
+    uart_format_t sFormat;
+    uart_baud_t sRate;
+    BIGNUM_T numBaud = 0;
+
+    uart_config_get(&sFormat, &sRate);
+    strncpy(vstrLine, pstrArgs, uSHELL_MAX_INPUT_BUF_LEN - 1);
+    vstrLine[uSHELL_MAX_INPUT_BUF_LEN - 1] = '\0';
+    char *pstrBaud = strtok_ex(pstrRest, m_pstrTokenSeparator, &pstrRest);
+    char *pstrFormat = (nullptr == pstrBaud) ? nullptr : strtok_ex(pstrRest, m_pstrTokenSeparator, &pstrRest);
+    char *pstrFlow = (nullptr == pstrFormat) ? nullptr : strtok_ex(pstrRest, m_pstrTokenSeparator, &pstrRest);
+    const char *pcFlow = ((nullptr == pstrFlow) || ('\0' == *pstrFlow) || ('\0' != pstrFlow[1])) ? nullptr : (const char*)memchr(vcFlow, *pstrFlow, sizeof(vcFlow));
+
+    if(nullptr == pstrBaud) {
+        uart_format_name(sFormat, vstrName);
+        uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR, "baud    : %u (requested %u, %d ppm)\n"), (unsigned int)sRate.baud, (unsigned int)sRate.requested, (int)sRate.error_ppm);
+        uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR, "divisor : %u + %u/16\n"), (unsigned int)sRate.clkdiv, (unsigned int)sRate.frag);
+        uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR, "format  : %s\n"), vstrName);
+        uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR, "flow    : %s\n"), vstrFlow[sFormat.flow % uSHELL_NR_ELEMS(vstrFlow)]);
+    } else if((nullptr != pstrRest) || ((nullptr != pstrFlow) && (nullptr == pcFlow)) ||
+              (false == asc2int(pstrBaud, &numBaud)) || ((uint64_t)numBaud > 0xFFFFFFFFU) ||
+              (0 != uart_baud_calc(UART_APB_HZ, (uint32_t)numBaud, &sRate)) ||
+              ((nullptr != pstrFormat) && (0 != uart_format_parse(pstrFormat, &sFormat)))) {
+        m_CorePrintMessage(8, 8); /* args unsupported */
+    } else {
+        if(nullptr != pcFlow) {
+            sFormat.flow = (uint8_t)(pcFlow - vcFlow);
+        }
+        uart_format_name(sFormat, vstrName);
+        uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR, "switching to %u %s flow %s (%d ppm), press Enter at the new rate within %u s\n"),
+                      (unsigned int)sRate.baud, vstrName, vstrFlow[sFormat.flow], (int)sRate.error_ppm, (unsigned int)(uSHELL_UART_CONFIRM_MS / 1000U));
+        const int iResult = uart_switch((uint32_t)numBaud, sFormat, uSHELL_UART_CONFIRM_MS);
+        uart_config_get(&sFormat, &sRate);
+        uart_format_name(sFormat, vstrName);
+        if(0 == iResult) {
+            uSHELL_PRINTF(FRMT(uSHELL_SUCCESS_COLOR, "uart : %u %s kept\n"), (unsigned int)sRate.baud, vstrName);
+        } else {
+            uSHELL_PRINTF(FRMT(uSHELL_WARNING_COLOR, "uart : not confirmed, back to %u %s\n"), (unsigned int)sRate.baud, vstrName);
+        }
+    }
+} /* m_UartBaud() */
+#endif /*(1 == uSHELL_IMPLEMENTS_UART_CONFIG)*/
+
+
+/*==============================================================================
+                    PRIVATE VARIABLES INITIALIZATION
+==============================================================================*/
 
-#if (defined(uSHELL_IMPLEMENTS_STRINGS) && (1 == uSHELL_SUPPORTS_SPACED_STRINGS))
-char Microshell::m_cStringBorderSymbol = uSHELL_KEY_QUOTATION_MARK;
-#endif /*(defined(uSHELL_IMPLEMENTS_STRINGS) && (1 == uSHELL_SUPPORTS_SPACED_STRINGS))*/
 
 #if (1 == uSHELL_IMPLEMENTS_SMART_PROMPT)
-#define  uSHELL_PROMPT_TABLE_BEGIN      char Microshell::m_pstrPrompt[uSHELL_PROMPTI_LAST + 1] = ""
+#define  uSHELL_PROMPT_TABLE_BEGIN      const char Microshell::m_pstrPrompt[uSHELL_PROMPTI_LAST + 1] = ""
 #define  uSHELL_PROMPT_CELL(a, b, c)        ":"
 #define  uSHELL_PROMPT_TABLE_END        ;
 #include uSHELL_PROMPT_CONFIG_FILE
@@ -2257,6 +4611,34 @@ char Microshell::m_cStringBorderSymbol = uSHELL_KEY_QUOTATION_MARK;
 #undef   uSHELL_DATA_TYPES_TABLE_END
 
 const char *Microshell::m_pstrCoreShortcutCaption = "\t##|#|i|s : info short|all|i|substr s\n\r"
+                                                    "\t#m : instance RAM usage\n\r"
+#if (1 == uSHELL_IMPLEMENTS_JOBS)
+                                                    "\t#j|w [i]|c i : jobs list|wait|cancel; 'cmd args &' runs in background\n\r"
+#endif /*(1 == uSHELL_IMPLEMENTS_JOBS)*/
+#if (1 == uSHELL_IMPLEMENTS_EXEC_STATS)
+                                                    "\t#t [n|m|x]|r : timing stats by total|calls|mean|max time, reset\n\r"
+#endif /*(1 == uSHELL_IMPLEMENTS_EXEC_STATS)*/
+#if (1 == uSHELL_IMPLEMENTS_KEY_LATENCY)
+                                                    "\t#t k : key to echo latency per key class\n\r"
+#endif /*(1 == uSHELL_IMPLEMENTS_KEY_LATENCY)*/
+#if (1 == uSHELL_IMPLEMENTS_BENCH)
+                                                    "\t#b [p] n cmd args : runs cmd n times parsed once|each time, throughput and percentiles\n\r"
+#endif /*(1 == uSHELL_IMPLEMENTS_BENCH)*/
+#if (1 == uSHELL_IMPLEMENTS_TRACE)
+                                                    "\t#x [c] : event trace binary dump (see ushell_trace2json), clear\n\r"
+#endif /*(1 == uSHELL_IMPLEMENTS_TRACE)*/
+#if (1 == uSHELL_IMPLEMENTS_HEAP_STATS)
+                                                    "\t#M [r] : heap of the shell and its commands per site, reset peaks\n\r"
+#endif /*(1 == uSHELL_IMPLEMENTS_HEAP_STATS)*/
+#if (1 == uSHELL_IMPLEMENTS_STACK_USAGE)
+                                                    "\t#S [r] : stack high-water mark per command, reset\n\r"
+#endif /*(1 == uSHELL_IMPLEMENTS_STACK_USAGE)*/
+#if (1 == uSHELL_IMPLEMENTS_UART_STATS)
+                                                    "\t#U [r] : console UART counters, reset\n\r"
+#endif /*(1 == uSHELL_IMPLEMENTS_UART_STATS)*/
+#if (1 == uSHELL_IMPLEMENTS_UART_CONFIG)
+                                                    "\t#B [baud [8N1 [n|h|s]]] : console UART rate, format and flow control none|rts/cts|xon/xoff, kept by an Enter at the new rate\n\r"
+#endif /*(1 == uSHELL_IMPLEMENTS_UART_CONFIG)*/
 #if (1 == uSHELL_IMPLEMENTS_SHELL_EXIT)
                                                     "\t#q : quit\n\r"
 #endif /* (1 == uSHELL_IMPLEMENTS_SHELL_EXIT) */
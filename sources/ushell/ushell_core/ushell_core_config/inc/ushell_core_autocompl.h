@@ -0,0 +1,133 @@
+#ifndef USHELL_CORE_AUTOCOMPL_H
+#define USHELL_CORE_AUTOCOMPL_H
+
+#include "ushell_core_datatypes.h"
+
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+
+/*
+    The autocomplete index is a prefix trie evaluated by the compiler over a
+    table of names. The names are sorted first and inserted in that order, so
+    the names found below any node occupy a contiguous range of the sorted
+    array: filtering, common prefix and cycling become walks over the trie
+    instead of scans over the whole table, and no RAM is needed.
+
+    The indexed table can hold plain names (const char*) or structures having
+    the name as first member (i.e. fctDef_s).
+
+    usage:
+        static constexpr auto g_sTrie = uSHELL_AUTOCOMPL_TRIE(g_vsFuncDefArray);
+        static const autocomplIndex_s g_sIndex = uSHELL_AUTOCOMPL_INDEX(g_sTrie, g_vsFuncDefArray);
+*/
+
+/** \brief compile time storage of an index over N names using M trie nodes */
+template<int N, int M>
+struct autocomplTrie_t {
+    autocomplNode_s vsNodes[M];
+    uint16_t        vu16Sorted[N];
+    int             iNrNodes;
+};
+
+/** \brief name accessors, the index can be built over any table of names */
+constexpr const char *uShellAutocomplKey(const fctDef_s &sFctDef)
+{
+    return sFctDef.pstrFctName;
+}
+
+constexpr const char *uShellAutocomplKey(const char *pstrName)
+{
+    return pstrName;
+}
+
+/*----------------------------------------------------------------------------*/
+constexpr int uShellAutocomplStrcmp(const char *pstrA, const char *pstrB)
+{
+    while(('\0' != *pstrA) && (*pstrA == *pstrB)) {
+        ++pstrA;
+        ++pstrB;
+    }
+    return ((int)(unsigned char)*pstrA - (int)(unsigned char)*pstrB);
+}
+
+/*----------------------------------------------------------------------------*/
+constexpr int uShellAutocomplStrlen(const char *pstrName)
+{
+    int iLen = 0;
+    while('\0' != pstrName[iLen]) {
+        ++iLen;
+    }
+    return iLen;
+}
+
+/*----------------------------------------------------------------------------*/
+/** \brief upper bound of the nodes: the root plus one node per character */
+template<typename T, int N>
+constexpr int uShellAutocomplMaxNodes(const T (&vItems)[N])
+{
+    int iNrNodes = 1;
+    for(int i = 0; i < N; ++i) {
+        for(const char *p = uShellAutocomplKey(vItems[i]); '\0' != *p; ++p) {
+            ++iNrNodes;
+        }
+    }
+    return iNrNodes;
+}
+
+/*----------------------------------------------------------------------------*/
+template<int M, typename T, int N>
+constexpr autocomplTrie_t<N, M> uShellAutocomplBuild(const T (&vItems)[N])
+{
+    static_assert((N < 0xFFFF) && (M < 0xFFFF), "autocomplete index too big");
+    autocomplTrie_t<N, M> sTrie{};
+
+    /* sort the names (insertion sort, evaluated by the compiler) */
+    for(int i = 0; i < N; ++i) {
+        sTrie.vu16Sorted[i] = (uint16_t)i;
+    }
+    for(int i = 1; i < N; ++i) {
+        uint16_t u16Crt = sTrie.vu16Sorted[i];
+        int j = i - 1;
+        while((j >= 0) && (uShellAutocomplStrcmp(uShellAutocomplKey(vItems[sTrie.vu16Sorted[j]]), uShellAutocomplKey(vItems[u16Crt])) > 0)) {
+            sTrie.vu16Sorted[j + 1] = sTrie.vu16Sorted[j];
+            --j;
+        }
+        sTrie.vu16Sorted[j + 1] = u16Crt;
+    }
+
+    /* insert the sorted names, each node covers [first, last] name passing through it */
+    sTrie.iNrNodes = 1;
+    sTrie.vsNodes[0].u16RangeHi = (uint16_t)N;
+    for(int k = 0; k < N; ++k) {
+        int iNode = 0;
+        for(const char *p = uShellAutocomplKey(vItems[sTrie.vu16Sorted[k]]); '\0' != *p; ++p) {
+            int iChild = sTrie.vsNodes[iNode].u16FirstChild;
+            int iLast  = 0;
+            while((0 != iChild) && (*p != sTrie.vsNodes[iChild].cKey)) {
+                iLast  = iChild;
+                iChild = sTrie.vsNodes[iChild].u16NextSibling;
+            }
+            if(0 == iChild) {
+                iChild = sTrie.iNrNodes++;
+                sTrie.vsNodes[iChild].cKey       = *p;
+                sTrie.vsNodes[iChild].u16RangeLo = (uint16_t)k;
+                if(0 == iLast) {
+                    sTrie.vsNodes[iNode].u16FirstChild = (uint16_t)iChild;
+                } else {
+                    sTrie.vsNodes[iLast].u16NextSibling = (uint16_t)iChild;
+                }
+            }
+            sTrie.vsNodes[iChild].u16RangeHi = (uint16_t)(k + 1);
+            iNode = iChild;
+        }
+        sTrie.vsNodes[iNode].bTerminal = true;
+    }
+    return sTrie;
+}
+
+/** \brief build the trie twice: first to count the nodes, then with the exact size */
+#define uSHELL_AUTOCOMPL_TRIE(items)            uShellAutocomplBuild<uShellAutocomplBuild<uShellAutocomplMaxNodes(items)>(items).iNrNodes>(items)
+#define uSHELL_AUTOCOMPL_INDEX(trie, items)     { (trie).vsNodes, (trie).vu16Sorted, (items), (int)sizeof((items)[0]), (trie).iNrNodes }
+
+#endif /* (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE) */
+
+#endif /* USHELL_CORE_AUTOCOMPL_H */
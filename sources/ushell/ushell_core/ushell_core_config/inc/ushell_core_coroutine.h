@@ -0,0 +1,110 @@
+#ifndef USHELL_CORE_COROUTINE_H
+#define USHELL_CORE_COROUTINE_H
+
+#include "ushell_core_settings.h"
+
+#if (1 == uSHELL_IMPLEMENTS_COROUTINES)
+
+#include <coroutine>
+#include <stddef.h>
+
+/*
+    A coroutine command produces its output in chunks and gives the control
+    back to the shell loop between them. The loop resumes it only when the
+    output path has room for the next chunk, and checks the input (Ctrl-C)
+    meanwhile, so long listings neither block the loop nor the watchdog.
+
+    usage (registered with uSHELL_COROUTINE() in the commands table):
+        uShellTask idump(uint32_t iLines)
+        {
+            for(uint32_t i = 0; i < iLines; ++i) {
+                co_yield 32;                     // resume when 32 bytes of TX are free
+                uSHELL_PRINTF("line %u\n", i);
+            }
+            co_return 0;
+        }
+
+    The frame is allocated by the promise from the shell heap (site
+    uSHELL_HEAP_COMMANDS of '#M', see ushell_core_utils.cpp) and the promise
+    provides get_return_object_on_allocation_failure: when the allocation
+    fails the task is not valid and the command is reported as out of memory.
+*/
+
+/** \brief handle of a coroutine command, owns the coroutine frame */
+class uShellTask
+{
+    public:
+
+        struct promise_type {
+            int iRetVal   = 0;
+            int iTxNeeded = 0;
+
+            static void *operator new(size_t szSize) noexcept;
+            static void operator delete(void *pvFrame) noexcept;
+            static uShellTask get_return_object_on_allocation_failure() noexcept { return uShellTask(); }
+            uShellTask get_return_object() noexcept { return uShellTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_always final_suspend() noexcept { return {}; }
+            std::suspend_always yield_value(const int iBytes) noexcept { iTxNeeded = iBytes; return {}; }
+            void return_value(const int iValue) noexcept { iRetVal = iValue; }
+            void unhandled_exception() noexcept {}
+        };
+
+        uShellTask() noexcept = default;
+        uShellTask(const uShellTask&) = delete;
+        uShellTask &operator=(const uShellTask&) = delete;
+        uShellTask(uShellTask &&sOther) noexcept : m_hCoro(sOther.m_hCoro) { sOther.m_hCoro = nullptr; }
+        uShellTask &operator=(uShellTask &&sOther) noexcept
+        {
+            if(this != &sOther) {
+                Destroy();
+                m_hCoro = sOther.m_hCoro;
+                sOther.m_hCoro = nullptr;
+            }
+            return *this;
+        }
+        ~uShellTask() { Destroy(); }
+
+        /** \brief the frame exists (allocated and not destroyed yet) */
+        bool Valid(void) const { return (nullptr != m_hCoro); }
+
+        /** \brief the coroutine reached co_return */
+        bool Done(void) const { return m_hCoro.done(); }
+
+        /** \brief TX bytes requested by the last co_yield before it can go on */
+        int TxNeeded(void) const { return m_hCoro.promise().iTxNeeded; }
+
+        /** \brief value given to co_return */
+        int RetVal(void) const { return m_hCoro.promise().iRetVal; }
+
+        /** \brief runs the coroutine up to its next co_yield or co_return */
+        void Resume(void) { m_hCoro.resume(); }
+
+        /** \brief runs the coroutine to its end ignoring the TX room (i.e. from a worker or a script) */
+        int Complete(void)
+        {
+            while(false == Done()) {
+                Resume();
+            }
+            return RetVal();
+        }
+
+        /** \brief releases the frame, a suspended coroutine is cancelled (its locals are destroyed) */
+        void Destroy(void)
+        {
+            if(nullptr != m_hCoro) {
+                m_hCoro.destroy();
+                m_hCoro = nullptr;
+            }
+        }
+
+    private:
+
+        explicit uShellTask(const std::coroutine_handle<promise_type> hCoro) noexcept : m_hCoro(hCoro) {}
+
+        std::coroutine_handle<promise_type> m_hCoro = nullptr;
+};
+
+#endif /*(1 == uSHELL_IMPLEMENTS_COROUTINES)*/
+
+#endif /* USHELL_CORE_COROUTINE_H */
@@ -7,7 +7,11 @@
 #endif
 
 #include "ushell_core_settings.h"
+#include "ushell_core_coroutine.h"
 #include <cstddef>
+#if (1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS)
+    #include "ushell_core_mpsc.h"
+#endif /*(1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS)*/
 #if (1 == uSHELL_IMPLEMENTS_SAVE_HISTORY)
     #include <cstdio>
 #endif /*(1 == uSHELL_IMPLEMENTS_SAVE_HISTORY)*/
@@ -32,6 +36,7 @@ enum {
     uSHELL_ERR_TOO_MANY_ARGS             = -7,
     uSHELL_ERR_INVALID_NUMBER            = -8,
     uSHELL_ERR_VALUE_TOO_BIG             = -9,
+    uSHELL_ERR_NO_MEMORY                 = -10,
     uSHELL_ERR_LAST
 };
 
@@ -44,6 +49,27 @@ typedef enum {
 } deinit_e;
 #endif /*(1 == uSHELL_IMPLEMENTS_HISTORY)*/
 
+/** \brief input decoder states, kept between calls so the bytes can arrive in any split */
+typedef enum {
+    uSHELL_INPUT_KEY = 0,       /* plain keys */
+    uSHELL_INPUT_ESC,           /* ESC received, waiting for [ */
+    uSHELL_INPUT_ESC_KEY,       /* waiting for the key of the sequence */
+    uSHELL_INPUT_ESC_TILDE,     /* waiting for the closing ~ */
+    uSHELL_INPUT_CONFIRM,       /* waiting for y/n */
+    uSHELL_INPUT_KEYDECODER,    /* decoding keys until $ */
+    uSHELL_INPUT_TASK,          /* a coroutine command runs, only Ctrl-C is handled */
+    uSHELL_INPUT_LAST
+} input_e;
+
+#if (1 == uSHELL_IMPLEMENTS_CONFIRM_REQUEST)
+/** \brief actions executed once confirmed */
+typedef enum {
+    uSHELL_CONFIRM_EXIT = 0,
+    uSHELL_CONFIRM_HISTORY_RESET,
+    uSHELL_CONFIRM_LAST
+} confirm_e;
+#endif /*(1 == uSHELL_IMPLEMENTS_CONFIRM_REQUEST)*/
+
 #if (1 == uSHELL_IMPLEMENTS_EDITMODE) || (1 == uSHELL_IMPLEMENTS_HISTORY) || (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
 typedef enum {
     uSHELL_DIR_BACKWARD = 0,
@@ -65,14 +91,81 @@ typedef struct {
     bool    bIsEmpty;
 } circbuf_s;
 
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_SUGGEST)
+/** \brief node of the prefix trie over the history entries (node 0 is the root) */
+typedef struct {
+    uint16_t u16FirstChild;
+    uint16_t u16NextSibling;    /* next free node while unused */
+    uint16_t u16Count;          /* history entries passing through the node */
+    uint16_t u16Slot;           /* most recent of them */
+    char     cKey;
+} histNode_s;
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY_SUGGEST)*/
+
 typedef struct {
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_SUGGEST)
+    histNode_s *psNodes;        /* uSHELL_HISTORY_INDEX_NODES */
+    uint8_t    *pu8Depth;       /* indexed characters of every entry */
+    uint16_t    u16FreeNode;
+    int         iSuggestSlot;   /* entry shown as suggestion */
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY_SUGGEST)*/
     bool      bInitialized;
     bool      bEnabled;
 } history_s;
 #endif /*(1 == uSHELL_IMPLEMENTS_HISTORY)*/
 
 #if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+/** \brief autocomplete prefix trie node (generated at compile time) */
+typedef struct {
+    uint16_t u16FirstChild;     /* 0: no child (the root is never a child) */
+    uint16_t u16NextSibling;    /* 0: no sibling */
+    uint16_t u16RangeLo;        /* names below this node: pu16Sorted[lo..hi) */
+    uint16_t u16RangeHi;
+    char     cKey;              /* character on the edge leading to this node */
+    bool     bTerminal;         /* a name ends on this node */
+} autocomplNode_s;
+
+/** \brief read-only view on a generated autocomplete index */
+typedef struct {
+    const autocomplNode_s *psNodes;
+    const uint16_t        *pu16Sorted;
+    const void            *pvItems;     /* indexed table, the name is the first member of an item */
+    int                    iItemSize;
+    int                    iNrNodes;
+} autocomplIndex_s;
+
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPL_ARGS)
+/** \brief argument completion provider: candidate values for an argument of a command */
+typedef const autocomplIndex_s* (*PFCOMPLETE)(const int iFctIndex, const int iArgIndex);
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPL_ARGS)*/
+
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPL_RANKING)
+/** \brief usage counter of a command, only the most used commands keep a slot */
 typedef struct {
+    uint16_t u16SortedPos;  /* position of the command in the sorted commands index */
+    uint16_t u16Hits;
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPL_FUZZY)
+    uint8_t  u8FuzzyPos;    /* characters of the name consumed by the subsequence match */
+    bool     bFuzzyMatch;
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPL_FUZZY)*/
+} autocomplRank_s;
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPL_RANKING)*/
+
+typedef struct {
+    const autocomplIndex_s *psIndex;    /* commands or the values of the completed argument */
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPL_RANKING)
+    autocomplRank_s vsRank[uSHELL_AUTOCOMPL_RANK_SLOTS];       /* most used first */
+    uint16_t vu16Front[uSHELL_AUTOCOMPL_RANK_SLOTS + 1];       /* candidates cycled first */
+    uint16_t vu16Skip[uSHELL_AUTOCOMPL_RANK_SLOTS + 1];        /* the same ones, ascending */
+    int  iNrRanked;
+    int  iNrFront;
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPL_RANKING)*/
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPL_FUZZY)
+    int  iFuzzyPos;         /* input consumed by the subsequence match */
+    bool bFuzzy;
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPL_FUZZY)*/
+    int  iTokenStart;
+    int  iNode;
     int  iNrCrtElems;
     int  iSearchPos;
     int  iSavedSearchPos;
@@ -127,9 +220,132 @@ typedef struct {
     const char* const pstrFuncParamDef;
 } fctDef_s;
 
+#if (1 == uSHELL_IMPLEMENTS_JOBS)
+typedef enum {
+    uSHELL_JOB_FREE = 0,
+    uSHELL_JOB_QUEUED,
+    uSHELL_JOB_RUNNING,
+    uSHELL_JOB_DONE,
+    uSHELL_JOB_CANCELLED,
+    uSHELL_JOB_LAST
+} jobState_e;
+
+/** \brief background job, owns a copy of the parsed command line */
+typedef struct {
+    command_s     sCommand;         /* strings point into vstrInput */
+    char          vstrInput[uSHELL_MAX_INPUT_BUF_LEN];
+    int           iId;
+    int           iRetVal;
+    jobState_e    eState;
+    volatile bool bCancel;          /* cancellation token seen by the command */
+    bool          bReported;
+} job_s;
+#endif /*(1 == uSHELL_IMPLEMENTS_JOBS)*/
+
+#if (1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS)
+/** \brief command parsed ahead of time (see Parse()), it can be posted any number of times */
+typedef struct {
+    command_s     sCommand;         /* strings point into vstrInput */
+    char          vstrInput[uSHELL_MAX_INPUT_BUF_LEN];
+} parsedCmd_s;
+
+/** \brief completion of a posted command, called from the shell loop with the command result */
+typedef void (*PFPOSTDONE)(void *pvCtx, const int iRetVal);
+
+/** \brief result of a posted command: the poster polls bDone, then reads iRetVal */
+typedef struct {
+    std::atomic<bool> bDone;
+    int               iRetVal;
+} postFuture_s;
+
+/** \brief posted command, a slot of the lock-free queue of the instance */
+typedef struct {
+    parsedCmd_s   sParsed;
+    PFPOSTDONE    pfDone;
+    void         *pvCtx;
+} postedCmd_s;
+#endif /*(1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS)*/
+
+#if (1 == uSHELL_IMPLEMENTS_TIME_STATS)
+/** \brief durations in ticks (see uShellTicks()) of a command or of a key class */
+typedef struct {
+    uint32_t      u32Count;
+    uint32_t      u32Min;
+    uint32_t      u32Max;
+    uint64_t      u64Sum;
+    uint32_t      vu32Hist[uSHELL_STATS_BUCKETS];   /* bucket k: [4^(k-1), 4^k) ticks, the last one is open */
+} timeStats_s;
+#endif /*(1 == uSHELL_IMPLEMENTS_TIME_STATS)*/
+
+#if (1 == uSHELL_IMPLEMENTS_KEY_LATENCY)
+/** \brief keys grouped by the path they take through the line editor */
+typedef enum {
+    uSHELL_KEYCLASS_PRINTABLE = 0,      /* echo, autocomplete filtering and history suggestion */
+    uSHELL_KEYCLASS_AUTOCOMPLETE,       /* left/right arrows walking the candidates */
+    uSHELL_KEYCLASS_HISTORY,            /* up/down arrows */
+    uSHELL_KEYCLASS_EDIT,               /* backspace, delete, home/end, insert, ctrl-u/k, arrows in edit mode */
+    uSHELL_KEYCLASS_ENTER,              /* includes the execution of the command */
+    uSHELL_KEYCLASS_OTHER,
+    uSHELL_KEYCLASS_LAST
+} keyClass_e;
+#endif /*(1 == uSHELL_IMPLEMENTS_KEY_LATENCY)*/
+
+#if (1 == uSHELL_IMPLEMENTS_STACK_USAGE)
+/** \brief stack high-water mark of a command */
+typedef struct {
+    uint32_t      u32Calls;
+    uint32_t      u32Max;                       /* bytes below the dispatcher */
+    bool          bSaturated;                   /* the whole painted area was used, u32Max is a lower bound */
+} stackUse_s;
+#endif /*(1 == uSHELL_IMPLEMENTS_STACK_USAGE)*/
+
+#if (1 == uSHELL_IMPLEMENTS_TRACE)
+/** \brief events recorded by the core tracepoints */
+typedef enum {
+    uSHELL_TRACE_KEY = 0,               /* byte received, arg: the byte */
+    uSHELL_TRACE_RENDER,                /* output of the byte done, arg: the byte */
+    uSHELL_TRACE_PARSE_BEGIN,
+    uSHELL_TRACE_PARSE_END,             /* arg: parser result */
+    uSHELL_TRACE_EXEC_BEGIN,            /* dispatch, arg: command index */
+    uSHELL_TRACE_EXEC_END,              /* command returned, arg: return value */
+    uSHELL_TRACE_HISTORY_BEGIN,
+    uSHELL_TRACE_HISTORY_END,
+    uSHELL_TRACE_LAST
+} traceEvent_e;
+
+/** \brief fixed size record of the trace ring, little endian in the dump */
+typedef struct {
+    uint32_t      u32Ticks;
+    uint16_t      u16Arg;
+    uint8_t       u8Event;
+    uint8_t       u8Reserved;
+} traceRec_s;
+
+/*
+    dump frame (#x), all fields little endian:
+        "uSHT" | version:u8 | record size:u8 | records:u16 | ticks per us:u32
+        records, oldest first
+        commands:u16 | names of the commands, '\0' terminated
+        "uEND"
+*/
+#define uSHELL_TRACE_MAGIC          "uSHT"
+#define uSHELL_TRACE_END            "uEND"
+#define uSHELL_TRACE_VERSION        (1U)
+#endif /*(1 == uSHELL_IMPLEMENTS_TRACE)*/
+
 /** \brief command execution function pointer */
 typedef int (*PFEXEC)(const command_s *psCmd);
 
+#if (1 == uSHELL_IMPLEMENTS_COROUTINES)
+/** \brief starts a coroutine command, uSHELL_ERR_ITEM_NOT_FOUND if the command is a plain function */
+typedef int (*PFSPAWN)(const command_s *psCmd, uShellTask *psTask);
+#endif /*(1 == uSHELL_IMPLEMENTS_COROUTINES)*/
+
+#if (1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT)
+/** \brief time budget in ms of a command (0: no limit) */
+typedef uint32_t (*PFBUDGET)(const int iFctIndex);
+#endif /*(1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT)*/
+
 /** \brief shortcut execution function pointer */
 typedef void (*PFSHORTCUT)(const char *pstrArgs);
 
@@ -139,10 +355,24 @@ typedef struct {
     PFSHORTCUT pfShortcut;
 } shortcut_s;
 
-/** \brief main structure */
+/** \brief returned by a non-blocking pfGetch when no byte is available (see Poll()) */
+#define uSHELL_IO_NO_DATA   (-1)
+
+/** \brief I/O backend of a shell instance, pvCtx is passed back to the callbacks */
+typedef struct {
+    int  (*pfGetch)(void *pvCtx);
+    void (*pfPutch)(void *pvCtx, const char cChar);
+    int  (*pfTryGetch)(void *pvCtx);    /* optional: never blocks, uSHELL_IO_NO_DATA when empty */
+    int  (*pfTxFree)(void *pvCtx);      /* optional: room left in the TX path, unbounded if missing */
+    int  (*pfRead)(void *pvCtx, char *pcBuf, int iMaxLen);          /* optional: never blocks, bytes read, the input is taken in chunks */
+    void (*pfWrite)(void *pvCtx, const char *pcBuf, int iLen);      /* optional: the printed text in one call */
+    void  *pvCtx;
+} uShellIo_s;
+
+/** \brief main structure, read-only so it can be shared by several shell instances */
 typedef struct {
     const fctDef_s         *const psFuncDefArray;
-    shortcut_s             *psShortcutsArray;
+    const shortcut_s       *psShortcutsArray;
 #if (1 == uSHELL_IMPLEMENTS_COMMAND_HELP)
     const char* const*      ppstrInfoArray;
 #if (1 == uSHELL_IMPLEMENTS_USER_SHORTCUTS)
@@ -150,22 +380,23 @@ typedef struct {
 #endif /*(1 == uSHELL_IMPLEMENTS_USER_SHORTCUTS)*/
 #endif /*(1 == uSHELL_IMPLEMENTS_COMMAND_HELP)*/
 #if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
-    int                    *piAutocompleteIndexArray;
+    const autocomplIndex_s *psAutocomplIndex;
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPL_ARGS)
+    PFCOMPLETE              pfComplete;
+#endif /* (1 == uSHELL_IMPLEMENTS_AUTOCOMPL_ARGS) */
 #endif /* (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE) */
-#if (1 == uSHELL_IMPLEMENTS_SAVE_HISTORY)
-    FILE                  *pfileHistory;
-#endif /*(1 == uSHELL_IMPLEMENTS_SAVE_HISTORY)*/
-#if (1 == uSHELL_IMPLEMENTS_SHELL_EXIT)
-    bool                    bKeepRuning;
-#endif /*(1 == uSHELL_IMPLEMENTS_SHELL_EXIT)*/
     const int               iNrFunctions;
     const int               iNrShortcuts;
     PFEXEC                  pfExec;
-    char                    vstrPrompt[uSHELL_PROMPT_MAX_LEN];
-    int                     iPromptLength;
+#if (1 == uSHELL_IMPLEMENTS_COROUTINES)
+    PFSPAWN                 pfSpawn;
+#endif /*(1 == uSHELL_IMPLEMENTS_COROUTINES)*/
+#if (1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT)
+    PFBUDGET                pfBudget;
+#endif /*(1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT)*/
 } uShellInst_s;
 
 
-uShellInst_s *pluginEntry(void);
+const uShellInst_s *pluginEntry(void);
 
 #endif /* USHELL_CORE_DATATYPES_H */
\ No newline at end of file
@@ -9,6 +9,7 @@
 #define uSHELL_KEY_COLON                     (0x3A)
 #define uSHELL_KEY_EQUAL                     (0x3D)
 #define uSHELL_KEY_ESCAPE                    (0x1B)
+#define uSHELL_KEY_CTRL_C                    (0x03)
 #define uSHELL_KEY_CTRL_U                    (0x15)
 #define uSHELL_KEY_CTRL_K                    (0x0B)
 #define uSHELL_KEY_QUOTATION_MARK            '"'
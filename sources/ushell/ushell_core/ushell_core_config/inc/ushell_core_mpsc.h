@@ -0,0 +1,102 @@
+#ifndef USHELL_CORE_MPSC_H
+#define USHELL_CORE_MPSC_H
+
+#include <atomic>
+#include <stdint.h>
+
+/*
+    Bounded MPSC queue: a producer claims a position with one CAS on the head
+    and publishes the slot with its sequence, the consumer owns the tail.
+    No lock is taken, so it can be used from ISRs; when full the item is
+    dropped and counted instead of waiting. The sequences are stored relative
+    to the slot index so the zero initialized queue is valid before main().
+
+    usage:
+        uint32_t u32Pos;
+        item_s *psItem = sQueue.Claim(&u32Pos);         // any task or ISR
+        if(nullptr != psItem) {
+            ... fill *psItem ...
+            sQueue.Publish(u32Pos);
+        }
+
+        while(nullptr != (psItem = sQueue.Front())) {   // the single consumer
+            ... use *psItem ...
+            sQueue.Pop();
+        }
+*/
+
+template <typename T, uint32_t N>
+class uShellMpsc
+{
+    static_assert((0U != N) && (0U == (N & (N - 1U))), "the number of slots must be a power of 2");
+
+    public:
+
+        /** \brief producer: reserves the next slot, nullptr (and counted as dropped) when full */
+        T *Claim(uint32_t *pu32Pos)
+        {
+            uint32_t u32Pos = m_u32Head.load(std::memory_order_relaxed);
+            T *psItem = nullptr;
+
+            while (nullptr == psItem) {
+                slot_s *psCrt = &m_vsSlots[u32Pos & (N - 1U)];
+                const int32_t i32Diff = (int32_t)(psCrt->u32Seq.load(std::memory_order_acquire) + (u32Pos & (N - 1U)) - u32Pos);
+                if (0 == i32Diff) {
+                    if (m_u32Head.compare_exchange_weak(u32Pos, u32Pos + 1U, std::memory_order_relaxed)) {
+                        psItem = &psCrt->sItem;
+                    }
+                } else if (i32Diff < 0) {
+                    m_u32Dropped.fetch_add(1U, std::memory_order_relaxed);   /* full: not consumed since the last lap */
+                    return nullptr;
+                } else {
+                    u32Pos = m_u32Head.load(std::memory_order_relaxed);      /* taken by another producer */
+                }
+            }
+            *pu32Pos = u32Pos;
+            return psItem;
+        }
+
+        /** \brief producer: hands the slot filled after Claim() to the consumer */
+        void Publish(const uint32_t u32Pos)
+        {
+            m_vsSlots[u32Pos & (N - 1U)].u32Seq.store(u32Pos + 1U - (u32Pos & (N - 1U)), std::memory_order_release);
+        }
+
+        /** \brief consumer: oldest published item, nullptr if empty or not published yet */
+        T *Front(void)
+        {
+            const uint32_t u32Index = m_u32Tail & (N - 1U);
+            slot_s *psSlot = &m_vsSlots[u32Index];
+
+            return ((psSlot->u32Seq.load(std::memory_order_acquire) + u32Index) == (m_u32Tail + 1U)) ? &psSlot->sItem : nullptr;
+        }
+
+        /** \brief consumer: releases the item returned by Front() to the producers */
+        void Pop(void)
+        {
+            const uint32_t u32Index = m_u32Tail & (N - 1U);
+
+            m_vsSlots[u32Index].u32Seq.store(m_u32Tail + N - u32Index, std::memory_order_release);
+            ++m_u32Tail;
+        }
+
+        /** \brief items dropped since the last call */
+        uint32_t Dropped(void)
+        {
+            return m_u32Dropped.exchange(0U, std::memory_order_relaxed);
+        }
+
+    private:
+
+        struct slot_s {
+            std::atomic<uint32_t> u32Seq{0U};
+            T                     sItem{};
+        };
+
+        slot_s                m_vsSlots[N];
+        std::atomic<uint32_t> m_u32Head{0U};
+        uint32_t              m_u32Tail = 0U;
+        std::atomic<uint32_t> m_u32Dropped{0U};
+};
+
+#endif /* USHELL_CORE_MPSC_H */
@@ -11,13 +11,23 @@ extern "C" {
 
     #include <stdarg.h>
     int uart_getchar        (void);
+    int uart_trygetchar     (void);  /* -1 when nothing was received */
+    int uart_txfree         (void);  /* free bytes in the TX ring */
     void uart_putchar       (char c);
+    int  uart_read          (void *buf, int maxlen);    /* never blocks, bytes read */
+    int  uart_write         (const void *buf, int len);
     int  uart_printf        (const char *format, ...);
     int  uart_snprintf(char *buf, int maxlen, const char *fmt, ...);
+    int  uart_vsnprintf(char *buf, int maxlen, const char *fmt, va_list args);
     #define uSHELL_PRINTF   uart_printf
     #define uSHELL_SNPRINTF uart_snprintf
+    #define uSHELL_VSNPRINTF uart_vsnprintf
     #define uSHELL_GETCH()  uart_getchar()
     #define uSHELL_PUTCH(x) uart_putchar(x)
+    #define uSHELL_TRYGETCH() uart_trygetchar()
+    #define uSHELL_TXFREE()   uart_txfree()
+    #define uSHELL_READ(b, n)  uart_read((b), (n))
+    #define uSHELL_WRITE(b, n) uart_write((b), (n))
 
 /* linux PC terminal */
 #elif (defined(__GNUC__) && defined(__linux__) && (defined(__x86_64__) || defined(__i386__)))
@@ -26,9 +36,11 @@ extern "C" {
     #include <stdio.h>
     #define uSHELL_PRINTF   printf
     #define uSHELL_SNPRINTF snprintf
+    #define uSHELL_VSNPRINTF vsnprintf
     #define uSHELL_VPRINTF  vprintf
     #define uSHELL_GETCH()  fgetc(stdin)
     #define uSHELL_PUTCH(x) putchar(x)
+    #define uSHELL_WRITE(b, n) fwrite((b), 1, (size_t)(n), stdout)
 
 /* i.e MinGW or Microsoft VisualStudio for Windows terminal */
 #elif (defined(__MINGW32__) || defined(_MSC_VER))
@@ -38,9 +50,11 @@ extern "C" {
     #include <conio.h>
     #define uSHELL_PRINTF    printf
     #define uSHELL_SNPRINTF  snprintf
+    #define uSHELL_VSNPRINTF vsnprintf
     #define uSHELL_VPRINTF   vprintf
     #define uSHELL_GETCH()  _getch()
     #define uSHELL_PUTCH(x) _putch(x)
+    #define uSHELL_TRYGETCH() (_kbhit() ? _getch() : -1)
 
 #else /* build environment not defined  */
     #error "Build variant not defined, please define it..."
@@ -3,11 +3,23 @@
 
 #include "ushell_core_settings.h"
 #include <stddef.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdlib.h>
 
 #define uSHELL_ISPRINT(c)  (((c) >= 0x20) && ((c) <= 0x7e))
 
 char *strtok_ex( char *str, const char *delim, char **saveptr );
 
+/* output of the commands: the shell points the sink of the calling thread to the I/O of the instance running them */
+typedef struct {
+    void (*pfWrite)( void *pvCtx, const char *pcBuf, const int iLen );
+    void *pvCtx;
+} printSink_s;
+
+printSink_s uShellSetPrintSink( const printSink_s sSink );              /* returns the previous one, {nullptr, nullptr}: uSHELL_PRINTF */
+int         uShellPrintf( const char *pstrFormat, ... );                /* commands print with it, not with uSHELL_PRINTF */
+
 #if defined(BIGNUM_T)
     bool asc2int( const char *s, BIGNUM_T *pNumber );
     int  dump ( BIGNUM_T address, num32_t length, bool show_address );
@@ -22,4 +34,118 @@ char *strtok_ex( char *str, const char *delim, char **saveptr );
     bool unhexlify( const char *hexstr, uint8_t *output, size_t *out_len);
 #endif /* (1 == uSHELL_IMPLEMENTS_HEXLIFY) */
 
+#if (1 == uSHELL_IMPLEMENTS_JOBS)
+    /* the shell sets the token of the job running on the worker */
+    void uShellSetCancelToken( const volatile bool *pbCancel );
+#endif /* (1 == uSHELL_IMPLEMENTS_JOBS) */
+
+#if ((1 == uSHELL_IMPLEMENTS_JOBS) || (1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT))
+    /* cooperative cancellation: long running commands poll it (job cancelled or time budget exceeded) */
+    bool uShellCancelRequested( void );
+#endif /* ((1 == uSHELL_IMPLEMENTS_JOBS) || (1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT)) */
+
+#if (1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT)
+    /* time budget of the command running on the calling thread */
+    typedef uint32_t (*PFCLOCK)( void );
+    void     uShellSetClock( PFCLOCK pfClockMs );                       /* monotonic ms stand-in (host tests), nullptr: platform clock */
+    uint32_t uShellClockMs( void );
+    void     uShellSetYieldHook( void (*pfYield)(void) );              /* i.e. lets the idle task feed the watchdog */
+    bool     uShellYield( void );                                       /* long commands call it, false once they have to stop */
+    void     uShellDeadlineArm( const uint32_t u32BudgetMs );           /* by the shell around a command, 0: no limit */
+    bool     uShellDeadlineDisarm( uint32_t *pu32ElapsedMs );           /* true if the budget was exceeded */
+#endif /* (1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT) */
+
+#if (1 == uSHELL_IMPLEMENTS_TIME_STATS)
+    /* cheap timestamp for the statistics: CPU cycles on Xtensa (pin the shell task, the counter
+       is per core), us on the host; the differences are valid up to 2^32 ticks, i.e. 17 s at
+       240 MHz and 71 minutes on the host, longer than any command budget */
+#if defined(__xtensa__)
+#if defined(ESP_PLATFORM)
+    #include "sdkconfig.h"
+#endif /* defined(ESP_PLATFORM) */
+#if defined(CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ)
+    #define uSHELL_TICKS_PER_US    (CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ)
+#elif defined(CONFIG_ESP32_DEFAULT_CPU_FREQ_MHZ)
+    #define uSHELL_TICKS_PER_US    (CONFIG_ESP32_DEFAULT_CPU_FREQ_MHZ)
+#else
+    #define uSHELL_TICKS_PER_US    (240U)
+#endif /* defined(CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ) */
+    static inline uint32_t uShellTicks( void )
+    {
+        uint32_t u32Ccount;
+        __asm__ __volatile__("rsr %0, ccount" : "=a"(u32Ccount));
+        return u32Ccount;
+    }
+#else
+    #include <time.h>
+    #define uSHELL_TICKS_PER_US    (1U)
+    static inline uint32_t uShellTicks( void )
+    {
+        struct timespec sNow;
+        clock_gettime(CLOCK_MONOTONIC, &sNow);
+        return (uint32_t)(((uint64_t)sNow.tv_sec * 1000000ULL) + ((uint64_t)sNow.tv_nsec / 1000U));
+    }
+#endif /* defined(__xtensa__) */
+#endif /* (1 == uSHELL_IMPLEMENTS_TIME_STATS) */
+
+#if (1 == uSHELL_IMPLEMENTS_HEAP_STATS)
+    /* heap of the shell and of its commands: every block carries its size and site */
+    typedef enum {
+        uSHELL_HEAP_HISTORY = 0,            /* history lines */
+        uSHELL_HEAP_HISTORY_RING,           /* history slots */
+        uSHELL_HEAP_HISTORY_INDEX,          /* history search index */
+        uSHELL_HEAP_STATS,                  /* timing statistics and their sorting */
+        uSHELL_HEAP_BENCH,                  /* samples of #b */
+        uSHELL_HEAP_STACK,                  /* stack high-water marks */
+        uSHELL_HEAP_COMMANDS,               /* user commands */
+        uSHELL_HEAP_SITE_LAST
+    } heapSite_e;
+
+    typedef struct {
+        uint32_t u32Allocs;
+        uint32_t u32Frees;
+        uint32_t u32Failed;
+        size_t   szCurrent;
+        size_t   szPeak;
+    } heapStats_s;
+
+    void  *uShellMalloc( const size_t szSize, const heapSite_e eSite );
+    void  *uShellRealloc( void *pvPtr, const size_t szSize, const heapSite_e eSite );  /* the block keeps its site */
+    void   uShellFree( void *pvPtr );
+    void   uShellHeapGet( const int iSite, heapStats_s *psStats );  /* uSHELL_HEAP_SITE_LAST: all the sites */
+    const char *uShellHeapSiteName( const int iSite );
+    void   uShellHeapResetPeaks( void );                            /* the peaks restart from the current use */
+    size_t uShellHeapLargestFree( void );                           /* 0 if the platform does not tell */
+
+    #define uSHELL_MALLOC(sz, site)         uShellMalloc((sz), (site))
+    #define uSHELL_REALLOC(p, sz, site)     uShellRealloc((p), (sz), (site))
+    #define uSHELL_FREE(p)                  uShellFree(p)
+#else
+    #define uSHELL_MALLOC(sz, site)         malloc(sz)
+    #define uSHELL_REALLOC(p, sz, site)     realloc((p), (sz))
+    #define uSHELL_FREE(p)                  free(p)
+#endif /* (1 == uSHELL_IMPLEMENTS_HEAP_STATS) */
+
+#if (1 == uSHELL_IMPLEMENTS_STACK_USAGE)
+    /* stack high-water mark: the free stack below the caller is painted, the deepest overwritten word is found after */
+    typedef struct {
+        uint32_t *pu32Low;                  /* painted [pu32Low, pu32High) */
+        uint32_t *pu32High;
+        const void *pvTop;                  /* the usage is measured from here */
+    } stackPaint_s;
+
+    bool   uShellStackPaint( stackPaint_s *psPaint, const void *pvTop );
+    size_t uShellStackUsed( const stackPaint_s *psPaint, bool *pbSaturated );
+    size_t uShellStackFree( void );                                 /* calling task: FreeRTOS low-water mark, host: below the caller */
+#endif /* (1 == uSHELL_IMPLEMENTS_STACK_USAGE) */
+
+#if (1 == uSHELL_IMPLEMENTS_LOG_SINK)
+    /* log sink: lock-free queue filled by any task or ISR, emptied by the shell between keys */
+    bool uShellLogPut( const char *pstrMsg );                           /* ISR safe, false if dropped */
+    bool uShellLogPrintf( const char *pstrFormat, ... );                /* tasks only, formats on the stack */
+    int  uShellLogVprintf( const char *pstrFormat, va_list args );      /* i.e. esp_log_set_vprintf(uShellLogVprintf) */
+    bool uShellLogGet( char *pstrMsg, size_t szSize );                  /* single consumer: the shell */
+    unsigned int uShellLogDropped( void );                              /* dropped since the last call */
+#endif /* (1 == uSHELL_IMPLEMENTS_LOG_SINK) */
+
 #endif /* USHELL_CORE_UTILS_H */
\ No newline at end of file
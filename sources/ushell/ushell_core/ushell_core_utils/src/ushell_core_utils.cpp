@@ -4,6 +4,39 @@
 #include <stddef.h>
 #include <ctype.h>
 #include <stdint.h>
+#include <string.h>
+
+#if (1 == uSHELL_IMPLEMENTS_LOG_SINK)
+#include "ushell_core_mpsc.h"
+#endif /* (1 == uSHELL_IMPLEMENTS_LOG_SINK) */
+
+#if (1 == uSHELL_IMPLEMENTS_COROUTINES)
+#include "ushell_core_coroutine.h"
+#endif /* (1 == uSHELL_IMPLEMENTS_COROUTINES) */
+
+#if (1 == uSHELL_IMPLEMENTS_HEAP_STATS)
+#include <atomic>
+#if defined(ESP_PLATFORM)
+#include "esp_heap_caps.h"
+#endif /* defined(ESP_PLATFORM) */
+#endif /* (1 == uSHELL_IMPLEMENTS_HEAP_STATS) */
+
+#if (1 == uSHELL_IMPLEMENTS_STACK_USAGE)
+#if defined(ESP_PLATFORM)
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#else
+#include <pthread.h>
+#endif /* defined(ESP_PLATFORM) */
+#endif /* (1 == uSHELL_IMPLEMENTS_STACK_USAGE) */
+
+#if (1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT)
+#if defined(ESP_PLATFORM)
+#include "esp_timer.h"
+#else
+#include <time.h>
+#endif /* defined(ESP_PLATFORM) */
+#endif /* (1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT) */
 
 
 /*----------------------------------------------------------------------------*/
@@ -175,19 +208,19 @@ int dump(BIGNUM_T address, num32_t length, bool show_address)
 
     for(int i = 0; i < nr_lines; ++i) {
         int index = i * uSHELL_DUMP_ELEM_PER_LINE;
-        if(show_address) uSHELL_PRINTF("%p | ", (p + index));
+        if(show_address) uShellPrintf("%p | ", (p + index));
 
         for(int k = 0; k < 2; ++k) {
             for(int j = 0; j < uSHELL_DUMP_ELEM_PER_LINE; ++j) {
                 unsigned char crt_byte = *(p + index + j);
                 if((i == nr_lines - 1) && last_line_len && j >= last_line_len)
-                    uSHELL_PRINTF((k == 0) ? "   " : " ");
+                    uShellPrintf((k == 0) ? "   " : " ");
                 else
-                    uSHELL_PRINTF("%c", uSHELL_ISPRINT(crt_byte) ? crt_byte : '.');
+                    uShellPrintf("%c", uSHELL_ISPRINT(crt_byte) ? crt_byte : '.');
             }
-            uSHELL_PRINTF(" | ");
+            uShellPrintf(" | ");
         }
-        uSHELL_PRINTF("\n");
+        uShellPrintf("\n");
     }
     return length;
 }
@@ -239,3 +272,480 @@ bool unhexlify(const char *hexstr, uint8_t *output, size_t *out_len)
     return true;
 }
 #endif /* (1 == uSHELL_IMPLEMENTS_HEXLIFY) */
+
+
+/* sink of the command running on the calling thread, set by the shell */
+static thread_local printSink_s g_sPrintSink = { nullptr, nullptr };
+
+/*----------------------------------------------------------------------------*/
+printSink_s uShellSetPrintSink(const printSink_s sSink)
+{
+    const printSink_s sPrev = g_sPrintSink;
+    g_sPrintSink = sSink;
+    return sPrev;
+}
+
+
+/*----------------------------------------------------------------------------*/
+int uShellPrintf(const char *pstrFormat, ...)
+{
+    char vstrBuffer[uSHELL_PRINTF_BUF_LEN];
+    va_list args;
+
+    va_start(args, pstrFormat);
+    int iLen = uSHELL_VSNPRINTF(vstrBuffer, sizeof(vstrBuffer), pstrFormat, args);
+    va_end(args);
+
+    if (iLen >= (int)sizeof(vstrBuffer)) {
+        iLen = (int)sizeof(vstrBuffer) - 1;   /* truncated */
+    }
+    if (iLen > 0) {
+        if (nullptr != g_sPrintSink.pfWrite) {
+            g_sPrintSink.pfWrite(g_sPrintSink.pvCtx, vstrBuffer, iLen);
+        } else {
+            uSHELL_PRINTF("%s", vstrBuffer);   /* outside of the shell, i.e. a command called directly */
+        }
+    }
+    return iLen;
+}
+
+
+#if (1 == uSHELL_IMPLEMENTS_JOBS)
+/* token of the job running on the calling thread, none for the shell itself */
+static thread_local const volatile bool *g_pbCancelToken = nullptr;
+
+/*----------------------------------------------------------------------------*/
+void uShellSetCancelToken(const volatile bool *pbCancel)
+{
+    g_pbCancelToken = pbCancel;
+}
+
+
+#endif /* (1 == uSHELL_IMPLEMENTS_JOBS) */
+
+
+#if (1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT)
+/* budget of the command running on the calling thread, armed by the shell */
+typedef struct {
+    uint32_t u32Start;
+    uint32_t u32Budget;
+    bool     bArmed;
+    bool     bExpired;
+} deadline_s;
+
+static thread_local deadline_s g_sDeadline = {};
+static PFCLOCK g_pfClockMs = nullptr;
+static void (*g_pfYieldHook)(void) = nullptr;
+
+/*----------------------------------------------------------------------------*/
+void uShellSetClock(PFCLOCK pfClockMs)
+{
+    g_pfClockMs = pfClockMs;
+}
+
+
+/*----------------------------------------------------------------------------*/
+uint32_t uShellClockMs(void)
+{
+    if (nullptr != g_pfClockMs) {
+        return g_pfClockMs();
+    }
+#if defined(ESP_PLATFORM)
+    return (uint32_t)(esp_timer_get_time() / 1000);
+#else
+    struct timespec sNow;
+    clock_gettime(CLOCK_MONOTONIC, &sNow);
+    return (uint32_t)((sNow.tv_sec * 1000) + (sNow.tv_nsec / 1000000));
+#endif /* defined(ESP_PLATFORM) */
+}
+
+
+/*----------------------------------------------------------------------------*/
+void uShellSetYieldHook(void (*pfYield)(void))
+{
+    g_pfYieldHook = pfYield;
+}
+
+
+/*----------------------------------------------------------------------------*/
+bool uShellYield(void)
+{
+    if (nullptr != g_pfYieldHook) {
+        g_pfYieldHook();
+    }
+    return (false == uShellCancelRequested());
+}
+
+
+/*----------------------------------------------------------------------------*/
+void uShellDeadlineArm(const uint32_t u32BudgetMs)
+{
+    g_sDeadline.u32Start  = uShellClockMs();
+    g_sDeadline.u32Budget = u32BudgetMs;
+    g_sDeadline.bArmed    = (0U != u32BudgetMs);
+    g_sDeadline.bExpired  = false;
+}
+
+
+/*----------------------------------------------------------------------------*/
+bool uShellDeadlineDisarm(uint32_t *pu32ElapsedMs)
+{
+    /* a command which never polled the cancellation is reported as well */
+    const uint32_t u32Elapsed = uShellClockMs() - g_sDeadline.u32Start;
+    const bool bOverrun = (true == g_sDeadline.bArmed) && ((true == g_sDeadline.bExpired) || (u32Elapsed > g_sDeadline.u32Budget));
+
+    g_sDeadline.bArmed = false;
+    *pu32ElapsedMs = u32Elapsed;
+    return bOverrun;
+}
+#endif /* (1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT) */
+
+
+#if ((1 == uSHELL_IMPLEMENTS_JOBS) || (1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT))
+/*----------------------------------------------------------------------------*/
+bool uShellCancelRequested(void)
+{
+    bool bCancel = false;
+#if (1 == uSHELL_IMPLEMENTS_JOBS)
+    bCancel = ((nullptr != g_pbCancelToken) && (true == *g_pbCancelToken));
+#endif /* (1 == uSHELL_IMPLEMENTS_JOBS) */
+#if (1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT)
+    if ((false == bCancel) && (true == g_sDeadline.bArmed)) {
+        if ((false == g_sDeadline.bExpired) && ((uShellClockMs() - g_sDeadline.u32Start) >= g_sDeadline.u32Budget)) {
+            g_sDeadline.bExpired = true;    /* sticky: the command keeps seeing it until it returns */
+        }
+        bCancel = g_sDeadline.bExpired;
+    }
+#endif /* (1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT) */
+    return bCancel;
+}
+#endif /* ((1 == uSHELL_IMPLEMENTS_JOBS) || (1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT)) */
+
+
+#if (1 == uSHELL_IMPLEMENTS_HEAP_STATS)
+/* the header keeps the payload aligned as malloc() does */
+typedef union {
+    struct {
+        size_t   szSize;
+        uint32_t u32Site;
+    } s;
+    max_align_t sAlign;
+} heapHeader_u;
+
+/* the shell and the jobs allocate concurrently */
+typedef struct {
+    std::atomic<uint32_t> u32Allocs;
+    std::atomic<uint32_t> u32Frees;
+    std::atomic<uint32_t> u32Failed;
+    std::atomic<size_t>   szCurrent;
+    std::atomic<size_t>   szPeak;
+} heapCounters_s;
+
+static heapCounters_s g_vsHeap[uSHELL_HEAP_SITE_LAST + 1];     /* the last one counts all the sites */
+static const char *g_vstrHeapSites[uSHELL_HEAP_SITE_LAST + 1] = { "history", "hist ring", "hist index", "stats", "bench", "stack", "commands", "total" };
+
+/*----------------------------------------------------------------------------*/
+static void uShellHeapAdd(heapCounters_s *psHeap, const size_t szAdd, const size_t szSub)
+{
+    const size_t szCurrent = psHeap->szCurrent.fetch_add(szAdd - szSub, std::memory_order_relaxed) + szAdd - szSub;
+    size_t szPeak = psHeap->szPeak.load(std::memory_order_relaxed);
+
+    while ((szCurrent > szPeak) && !psHeap->szPeak.compare_exchange_weak(szPeak, szCurrent, std::memory_order_relaxed)) {
+        /* szPeak reloaded, retry */
+    }
+}
+
+
+/*----------------------------------------------------------------------------*/
+static void uShellHeapCount(const uint32_t u32Site, const size_t szAdd, const size_t szSub)
+{
+    uShellHeapAdd(&g_vsHeap[u32Site], szAdd, szSub);
+    uShellHeapAdd(&g_vsHeap[uSHELL_HEAP_SITE_LAST], szAdd, szSub);
+}
+
+
+/*----------------------------------------------------------------------------*/
+void *uShellMalloc(const size_t szSize, const heapSite_e eSite)
+{
+    heapHeader_u *psHeader = (heapHeader_u*)malloc(sizeof(heapHeader_u) + szSize);
+
+    if (nullptr == psHeader) {
+        g_vsHeap[eSite].u32Failed.fetch_add(1U, std::memory_order_relaxed);
+        g_vsHeap[uSHELL_HEAP_SITE_LAST].u32Failed.fetch_add(1U, std::memory_order_relaxed);
+        return nullptr;
+    }
+    psHeader->s.szSize  = szSize;
+    psHeader->s.u32Site = (uint32_t)eSite;
+    g_vsHeap[eSite].u32Allocs.fetch_add(1U, std::memory_order_relaxed);
+    g_vsHeap[uSHELL_HEAP_SITE_LAST].u32Allocs.fetch_add(1U, std::memory_order_relaxed);
+    uShellHeapCount((uint32_t)eSite, szSize, 0U);
+    return psHeader + 1;
+}
+
+
+/*----------------------------------------------------------------------------*/
+void *uShellRealloc(void *pvPtr, const size_t szSize, const heapSite_e eSite)
+{
+    if (nullptr == pvPtr) {
+        return uShellMalloc(szSize, eSite);
+    }
+
+    heapHeader_u *psHeader = (heapHeader_u*)pvPtr - 1;
+    const size_t szOld = psHeader->s.szSize;
+    const uint32_t u32Site = psHeader->s.u32Site;
+    heapHeader_u *psGrown = (heapHeader_u*)realloc(psHeader, sizeof(heapHeader_u) + szSize);
+
+    if (nullptr == psGrown) {
+        g_vsHeap[u32Site].u32Failed.fetch_add(1U, std::memory_order_relaxed);
+        g_vsHeap[uSHELL_HEAP_SITE_LAST].u32Failed.fetch_add(1U, std::memory_order_relaxed);
+        return nullptr;
+    }
+    psGrown->s.szSize = szSize;
+    uShellHeapCount(u32Site, szSize, szOld);
+    return psGrown + 1;
+}
+
+
+/*----------------------------------------------------------------------------*/
+void uShellFree(void *pvPtr)
+{
+    if (nullptr != pvPtr) {
+        heapHeader_u *psHeader = (heapHeader_u*)pvPtr - 1;
+        g_vsHeap[psHeader->s.u32Site].u32Frees.fetch_add(1U, std::memory_order_relaxed);
+        g_vsHeap[uSHELL_HEAP_SITE_LAST].u32Frees.fetch_add(1U, std::memory_order_relaxed);
+        uShellHeapCount(psHeader->s.u32Site, 0U, psHeader->s.szSize);
+        free(psHeader);
+    }
+}
+
+
+/*----------------------------------------------------------------------------*/
+void uShellHeapGet(const int iSite, heapStats_s *psStats)
+{
+    const heapCounters_s *psHeap = &g_vsHeap[iSite];
+
+    psStats->u32Allocs = psHeap->u32Allocs.load(std::memory_order_relaxed);
+    psStats->u32Frees  = psHeap->u32Frees.load(std::memory_order_relaxed);
+    psStats->u32Failed = psHeap->u32Failed.load(std::memory_order_relaxed);
+    psStats->szCurrent = psHeap->szCurrent.load(std::memory_order_relaxed);
+    psStats->szPeak    = psHeap->szPeak.load(std::memory_order_relaxed);
+}
+
+
+/*----------------------------------------------------------------------------*/
+const char *uShellHeapSiteName(const int iSite)
+{
+    return g_vstrHeapSites[iSite];
+}
+
+
+/*----------------------------------------------------------------------------*/
+void uShellHeapResetPeaks(void)
+{
+    for (int i = 0; i <= uSHELL_HEAP_SITE_LAST; ++i) {
+        g_vsHeap[i].szPeak.store(g_vsHeap[i].szCurrent.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+}
+
+
+/*----------------------------------------------------------------------------*/
+size_t uShellHeapLargestFree(void)
+{
+#if defined(ESP_PLATFORM)
+    return heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+#else
+    return 0U;  /* the host allocator grows on demand */
+#endif /* defined(ESP_PLATFORM) */
+}
+#endif /* (1 == uSHELL_IMPLEMENTS_HEAP_STATS) */
+
+
+#if (1 == uSHELL_IMPLEMENTS_STACK_USAGE)
+#define uSHELL_STACK_PATTERN    (0xA5C3A5C3U)
+#define uSHELL_STACK_MARGIN     (256U)      /* kept away from the limit and from the frame of the painter */
+#define uSHELL_STACK_PAINT_MIN  (1024U)     /* first window painted on a thread, grows with the deepest use */
+
+/* the limit does not move during the life of a thread: read once (glibc parses /proc/self/maps for the main thread) */
+static thread_local uint8_t *g_pu8StackLow = nullptr;
+/* painted below the caller: twice the deepest use seen on the thread, uSHELL_STACK_PAINT_BYTES at most */
+static thread_local size_t g_szStackWindow = uSHELL_STACK_PAINT_MIN;
+
+/*----------------------------------------------------------------------------*/
+static uint8_t *uShellStackLimit(void)
+{
+    /* lowest address, the stacks grow down */
+    if (nullptr == g_pu8StackLow) {
+#if defined(ESP_PLATFORM)
+        g_pu8StackLow = (uint8_t*)pxTaskGetStackStart(nullptr);
+#else
+        pthread_attr_t sAttr;
+        void *pvLow = nullptr;
+        size_t szSize = 0U;
+        if (0 == pthread_getattr_np(pthread_self(), &sAttr)) {
+            pthread_attr_getstack(&sAttr, &pvLow, &szSize);
+            pthread_attr_destroy(&sAttr);
+        }
+        g_pu8StackLow = (uint8_t*)pvLow;
+#endif /* defined(ESP_PLATFORM) */
+    }
+    return g_pu8StackLow;
+}
+
+
+/*----------------------------------------------------------------------------*/
+bool uShellStackPaint(stackPaint_s *psPaint, const void *pvTop)
+{
+    volatile uint8_t u8Here = 0U;
+    const uint8_t *pu8Low = uShellStackLimit();
+
+    psPaint->pu32Low = psPaint->pu32High = nullptr;
+    psPaint->pvTop = pvTop;
+    if (nullptr == pu8Low) {
+        return false;
+    }
+
+    /* below this frame, down to the limit or the window of the thread */
+    const uintptr_t uHigh = ((uintptr_t)&u8Here - uSHELL_STACK_MARGIN) & ~(uintptr_t)3U;
+    uintptr_t uLow = ((uintptr_t)pu8Low + uSHELL_STACK_MARGIN + 3U) & ~(uintptr_t)3U;
+    if (uHigh <= uLow) {
+        return false;
+    }
+    if ((uHigh - uLow) > g_szStackWindow) {
+        uLow = uHigh - g_szStackWindow;
+    }
+    psPaint->pu32Low  = (uint32_t*)uLow;
+    psPaint->pu32High = (uint32_t*)uHigh;
+    for (volatile uint32_t *pu32 = psPaint->pu32Low; pu32 < psPaint->pu32High; ++pu32) {
+        *pu32 = uSHELL_STACK_PATTERN;
+    }
+    return true;
+}
+
+
+/*----------------------------------------------------------------------------*/
+size_t uShellStackUsed(const stackPaint_s *psPaint, bool *pbSaturated)
+{
+    const volatile uint32_t *pu32 = psPaint->pu32Low;
+
+    /* the deepest word overwritten since the painting */
+    while ((pu32 < psPaint->pu32High) && (uSHELL_STACK_PATTERN == *pu32)) {
+        ++pu32;
+    }
+    *pbSaturated = (pu32 == psPaint->pu32Low);
+
+    /* the next window covers twice this use, a saturated one doubles: a deeper command is measured from its next call */
+    const size_t szPainted = (size_t)((const uint8_t*)psPaint->pu32High - (const uint8_t*)psPaint->pu32Low);
+    size_t szWant = (true == *pbSaturated) ? (2U * szPainted) : (2U * (size_t)((const uint8_t*)psPaint->pu32High - (const uint8_t*)pu32));
+    szWant = (szWant > uSHELL_STACK_PAINT_BYTES) ? uSHELL_STACK_PAINT_BYTES : szWant;
+    g_szStackWindow = (szWant > g_szStackWindow) ? szWant : g_szStackWindow;
+    return (size_t)((const uint8_t*)psPaint->pvTop - (const uint8_t*)pu32);
+}
+
+
+/*----------------------------------------------------------------------------*/
+size_t uShellStackFree(void)
+{
+#if defined(ESP_PLATFORM)
+    return (size_t)uxTaskGetStackHighWaterMark(nullptr);   /* bytes on ESP-IDF */
+#else
+    volatile uint8_t u8Here = 0U;
+    const uint8_t *pu8Low = uShellStackLimit();
+    return (nullptr != pu8Low) ? (size_t)((const uint8_t*)&u8Here - pu8Low) : 0U;
+#endif /* defined(ESP_PLATFORM) */
+}
+#endif /* (1 == uSHELL_IMPLEMENTS_STACK_USAGE) */
+
+
+#if (1 == uSHELL_IMPLEMENTS_LOG_SINK)
+/* filled by any task or ISR, emptied by the shell (see ushell_core_mpsc.h) */
+typedef struct {
+    char vstrMsg[uSHELL_LOG_MSG_LEN];
+} logMsg_s;
+
+static uShellMpsc<logMsg_s, uSHELL_LOG_SLOTS> g_sLogQueue;
+
+/*----------------------------------------------------------------------------*/
+bool uShellLogPut(const char *pstrMsg)
+{
+    uint32_t u32Pos = 0U;
+    logMsg_s *psMsg = g_sLogQueue.Claim(&u32Pos);
+
+    if (nullptr == psMsg) {
+        return false;
+    }
+
+    size_t szLen = 0;
+    while (('\0' != pstrMsg[szLen]) && (szLen < (uSHELL_LOG_MSG_LEN - 1U))) {
+        psMsg->vstrMsg[szLen] = pstrMsg[szLen];
+        ++szLen;
+    }
+    while ((szLen > 0) && (('\n' == psMsg->vstrMsg[szLen - 1]) || ('\r' == psMsg->vstrMsg[szLen - 1]))) {
+        --szLen;    /* the shell ends the line itself */
+    }
+    psMsg->vstrMsg[szLen] = '\0';
+    g_sLogQueue.Publish(u32Pos);
+    return true;
+}
+
+
+/*----------------------------------------------------------------------------*/
+int uShellLogVprintf(const char *pstrFormat, va_list args)
+{
+    char vstrMsg[uSHELL_LOG_MSG_LEN];
+    const int iLen = uSHELL_VSNPRINTF(vstrMsg, sizeof(vstrMsg), pstrFormat, args);
+
+    return (true == uShellLogPut(vstrMsg)) ? iLen : 0;
+}
+
+
+/*----------------------------------------------------------------------------*/
+bool uShellLogPrintf(const char *pstrFormat, ...)
+{
+    va_list args;
+
+    va_start(args, pstrFormat);
+    const int iLen = uShellLogVprintf(pstrFormat, args);
+    va_end(args);
+
+    return (iLen > 0);
+}
+
+
+/*----------------------------------------------------------------------------*/
+bool uShellLogGet(char *pstrMsg, size_t szSize)
+{
+    const logMsg_s *psMsg = g_sLogQueue.Front();
+
+    if (nullptr == psMsg) {
+        return false;   /* empty, or the producer did not publish it yet */
+    }
+    strncpy(pstrMsg, psMsg->vstrMsg, szSize - 1U);
+    pstrMsg[szSize - 1U] = '\0';
+    g_sLogQueue.Pop();
+    return true;
+}
+
+
+/*----------------------------------------------------------------------------*/
+unsigned int uShellLogDropped(void)
+{
+    return g_sLogQueue.Dropped();
+}
+#endif /* (1 == uSHELL_IMPLEMENTS_LOG_SINK) */
+
+
+#if (1 == uSHELL_IMPLEMENTS_COROUTINES)
+/*----------------------------------------------------------------------------*/
+void *uShellTask::promise_type::operator new(size_t szSize) noexcept
+{
+    /* the frame of a coroutine command is counted with the other allocations of the commands */
+    return uSHELL_MALLOC(szSize, uSHELL_HEAP_COMMANDS);
+}
+
+
+/*----------------------------------------------------------------------------*/
+void uShellTask::promise_type::operator delete(void *pvFrame) noexcept
+{
+    uSHELL_FREE(pvFrame);
+}
+#endif /* (1 == uSHELL_IMPLEMENTS_COROUTINES) */
@@ -11,11 +11,28 @@
 /* major features */
 #define uSHELL_IMPLEMENTS_HISTORY                1
 #define uSHELL_IMPLEMENTS_SAVE_HISTORY           0
+#define uSHELL_IMPLEMENTS_HISTORY_SUGGEST        1  /* inline suggestion from history, right arrow accepts it */
 #define uSHELL_IMPLEMENTS_AUTOCOMPLETE           1
+#define uSHELL_IMPLEMENTS_AUTOCOMPL_ARGS         1  /* complete argument values (see *_completions.cfg) */
+#define uSHELL_IMPLEMENTS_AUTOCOMPL_RANKING      1  /* cycle the most used commands first */
+#define uSHELL_IMPLEMENTS_AUTOCOMPL_FUZZY        1  /* subsequence match over the ranked commands */
 #define uSHELL_IMPLEMENTS_EDITMODE               1
 #define uSHELL_IMPLEMENTS_SMART_PROMPT           1
 #define uSHELL_IMPLEMENTS_COMMAND_HELP           1
 #define uSHELL_IMPLEMENTS_USER_SHORTCUTS         1
+#define uSHELL_IMPLEMENTS_JOBS                   1  /* 'cmd args &' runs on a worker thread (pthreads), prints through the log sink */
+#define uSHELL_IMPLEMENTS_COROUTINES             1  /* C++20 coroutine commands resumed by the shell loop */
+#define uSHELL_IMPLEMENTS_LOG_SINK               1  /* logs of other tasks/ISRs printed above the edited line */
+#define uSHELL_IMPLEMENTS_POSTED_COMMANDS        1  /* commands posted by other tasks/ISRs, run by the shell loop */
+#define uSHELL_IMPLEMENTS_EXEC_TIMEOUT           1  /* per command time budget, cancellation requested on overrun */
+#define uSHELL_IMPLEMENTS_EXEC_STATS             1  /* per command execution timing statistics (#t) */
+#define uSHELL_IMPLEMENTS_KEY_LATENCY            1  /* key to echo latency per key class (#t k) */
+#define uSHELL_IMPLEMENTS_BENCH                  1  /* runs a command N times, throughput and latency percentiles (#b) */
+#define uSHELL_IMPLEMENTS_TRACE                  1  /* binary event trace ring of the core, dumped by #x */
+#define uSHELL_IMPLEMENTS_HEAP_STATS             1  /* heap used by the shell and its commands, per allocation site (#M) */
+#define uSHELL_IMPLEMENTS_STACK_USAGE            1  /* per command stack high-water mark, painted before the call (#S) */
+#define uSHELL_IMPLEMENTS_UART_STATS             1  /* counters of the bare-metal console UART (#U) */
+#define uSHELL_IMPLEMENTS_UART_CONFIG            1  /* rate and format of the console UART switched at runtime (#B) */
 
 /* minor features */
 #define uSHELL_SUPPORTS_COLORS                   1
@@ -49,7 +66,25 @@
 /* implementation specific */
 #define uSHELL_MAX_INPUT_BUF_LEN                 (128U)
 #define uSHELL_PROMPT_MAX_LEN                    (20U)
+#define uSHELL_PRINTF_BUF_LEN                    (256U)     /* per call stack buffer of the instance printf */
+#define uSHELL_POLL_MAX_BYTES                    (32U)      /* bytes consumed by one Poll() */
 #define uSHELL_HISTORY_DEPTH                     (100U)
+#define uSHELL_HISTORY_INDEX_NODES               (1024U)
+#define uSHELL_AUTOCOMPL_RANK_SLOTS              (8U)
+#define uSHELL_JOBS_WORKERS                      (2U)
+#define uSHELL_JOBS_MAX                          (4U)
+#define uSHELL_JOBS_STACK_SIZE                   (4096U)
+#define uSHELL_JOBS_WAIT_MS                      (30000U)   /* '#w' gives the console back after that, 0: no limit */
+#define uSHELL_JOBS_WAIT_SLICE_MS                (50U)      /* '#w' checks Ctrl-C that often */
+#define uSHELL_LOG_SLOTS                         (16U)      /* queued log messages, power of 2 */
+#define uSHELL_LOG_MSG_LEN                       (96U)      /* longer messages are truncated */
+#define uSHELL_POST_SLOTS                        (8U)       /* queued posted commands, power of 2 */
+#define uSHELL_EXEC_TIMEOUT_MS                   (5000U)    /* default budget of a command, 0: no limit */
+#define uSHELL_STATS_BUCKETS                     (16U)      /* histogram of the execution time, x4 per bucket */
+#define uSHELL_BENCH_MAX_RUNS                    (10000U)   /* one 32 bit sample per run is kept for the percentiles */
+#define uSHELL_TRACE_RECORDS                     (256U)     /* 8 bytes per traced event, power of 2 */
+#define uSHELL_STACK_PAINT_BYTES                 (8192U)    /* largest window painted below the dispatcher (it grows with the deepest use), deeper use is reported as saturated */
+#define uSHELL_UART_CONFIRM_MS                   (10000U)   /* an Enter at the new rate keeps it, else the old one is restored */
 #if (1 == uSHELL_SUPPORTS_COLORS)
 #define uSHELL_PROMPT_COLOR                      "\033[96m"     // Bright Cyan
 #define uSHELL_INFO_HEADER_COLOR                 "\033[94m"     // Bright Blue
@@ -61,6 +96,7 @@
 #define uSHELL_INFO_COLOR                        "\033[97m"     // Bright White
 #define uSHELL_WARNING_COLOR                     "\033[35m"     // Magenta
 #define uSHELL_ERROR_COLOR                       "\033[91m"     // Bright Red
+#define uSHELL_SUGGEST_COLOR                     "\033[90m"     // Bright Black (grey)
 #define uSHELL_RESET_COLOR                       "\033[0m"      // Reset to default
 #else /* (0 == uSHELL_SUPPORTS_COLORS) */
 #define uSHELL_PROMPT_COLOR                      ""
@@ -73,6 +109,7 @@
 #define uSHELL_INFO_COLOR                        ""
 #define uSHELL_WARNING_COLOR                     ""
 #define uSHELL_ERROR_COLOR                       ""
+#define uSHELL_SUGGEST_COLOR                     ""
 #define uSHELL_RESET_COLOR                       ""
 #endif /* (1 == uSHELL_SUPPORTS_COLORS) */
 
@@ -108,6 +145,10 @@
     #define uSHELL_IMPLEMENTS_DUMP               0
     #undef  uSHELL_SUPPORTS_COLORS
     #define uSHELL_SUPPORTS_COLORS               0
+    #undef  uSHELL_IMPLEMENTS_JOBS
+    #define uSHELL_IMPLEMENTS_JOBS               0
+    #undef  uSHELL_IMPLEMENTS_COROUTINES
+    #define uSHELL_IMPLEMENTS_COROUTINES         0
 #endif /* (1 == uSHELL_SCRIPT_MODE) */
 
 /* if not explicitely disabled then enable edit mode if autocompl and history are disabled */
@@ -126,6 +167,27 @@
     #define uSHELL_IMPLEMENTS_CONFIRM_REQUEST    0
 #endif /* ((0 == uSHELL_IMPLEMENTS_HISTORY) && (0 == uSHELL_IMPLEMENTS_SHELL_EXIT)) */
 
+#if (0 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+    #undef  uSHELL_IMPLEMENTS_AUTOCOMPL_ARGS
+    #define uSHELL_IMPLEMENTS_AUTOCOMPL_ARGS     0
+    #undef  uSHELL_IMPLEMENTS_AUTOCOMPL_RANKING
+    #define uSHELL_IMPLEMENTS_AUTOCOMPL_RANKING  0
+#endif /*(0 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)*/
+
+/* the fuzzy match runs only over the ranking table */
+#if ((0 == uSHELL_IMPLEMENTS_AUTOCOMPL_RANKING) || (0 == uSHELL_AUTOCOMPL_RANK_SLOTS))
+    #undef  uSHELL_IMPLEMENTS_AUTOCOMPL_RANKING
+    #define uSHELL_IMPLEMENTS_AUTOCOMPL_RANKING  0
+    #undef  uSHELL_IMPLEMENTS_AUTOCOMPL_FUZZY
+    #define uSHELL_IMPLEMENTS_AUTOCOMPL_FUZZY    0
+#endif /*((0 == uSHELL_IMPLEMENTS_AUTOCOMPL_RANKING) || (0 == uSHELL_AUTOCOMPL_RANK_SLOTS))*/
+
+/* the suggestion is drawn in grey after the cursor, it needs the history and the colors */
+#if ((0 == uSHELL_IMPLEMENTS_HISTORY) || (0 == uSHELL_SUPPORTS_COLORS) || (0 == uSHELL_HISTORY_INDEX_NODES))
+    #undef  uSHELL_IMPLEMENTS_HISTORY_SUGGEST
+    #define uSHELL_IMPLEMENTS_HISTORY_SUGGEST    0
+#endif /*((0 == uSHELL_IMPLEMENTS_HISTORY) || (0 == uSHELL_SUPPORTS_COLORS) || (0 == uSHELL_HISTORY_INDEX_NODES))*/
+
 #if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
     #define uSHELL_INIT_AUTOCOMPL_MODE           true /*true:on, false:off*/
     #define uSHELL_AUTOCOMPL_RELOAD              true
@@ -197,6 +259,87 @@
     #endif /* #if (uSHELL_MAX_PARAMS_BOOLEAN > 0)*/
 #endif /* #if (1 == uSHELL_SUPPORTS_BOOLEAN)*/
 
+/* the jobs need pthreads (ESP-IDF, linux, MinGW) and at least one worker */
+#if (defined(_MSC_VER) || defined(__AVR__) || (0 == uSHELL_JOBS_WORKERS) || (0 == uSHELL_JOBS_MAX))
+    #undef  uSHELL_IMPLEMENTS_JOBS
+    #define uSHELL_IMPLEMENTS_JOBS               0
+#endif /*(defined(_MSC_VER) || defined(__AVR__) || (0 == uSHELL_JOBS_WORKERS) || (0 == uSHELL_JOBS_MAX))*/
+
+/* the log sink needs lock-free atomics and a power of 2 number of slots */
+#if (defined(__AVR__) || (0 == uSHELL_LOG_SLOTS) || (0 != (uSHELL_LOG_SLOTS & (uSHELL_LOG_SLOTS - 1U))))
+    #undef  uSHELL_IMPLEMENTS_LOG_SINK
+    #define uSHELL_IMPLEMENTS_LOG_SINK           0
+#endif /*(defined(__AVR__) || (0 == uSHELL_LOG_SLOTS) || (0 != (uSHELL_LOG_SLOTS & (uSHELL_LOG_SLOTS - 1U))))*/
+
+/* the jobs print through the log sink: only the shell task writes to its transport */
+#if (0 == uSHELL_IMPLEMENTS_LOG_SINK)
+    #undef  uSHELL_IMPLEMENTS_JOBS
+    #define uSHELL_IMPLEMENTS_JOBS               0
+#endif /*(0 == uSHELL_IMPLEMENTS_LOG_SINK)*/
+
+/* the posted commands use the same lock-free queue */
+#if (defined(__AVR__) || (0 == uSHELL_POST_SLOTS) || (0 != (uSHELL_POST_SLOTS & (uSHELL_POST_SLOTS - 1U))))
+    #undef  uSHELL_IMPLEMENTS_POSTED_COMMANDS
+    #define uSHELL_IMPLEMENTS_POSTED_COMMANDS    0
+#endif /*(defined(__AVR__) || (0 == uSHELL_POST_SLOTS) || (0 != (uSHELL_POST_SLOTS & (uSHELL_POST_SLOTS - 1U))))*/
+
+/* the heap statistics are updated by the jobs too: lock-free atomics */
+#if defined(__AVR__)
+    #undef  uSHELL_IMPLEMENTS_HEAP_STATS
+    #define uSHELL_IMPLEMENTS_HEAP_STATS         0
+#endif /*defined(__AVR__)*/
+
+/* the stack painting needs the bounds of the stack of the calling task or thread */
+#if !(defined(ESP_PLATFORM) || (defined(__GLIBC__) || (defined(__GNUC__) && defined(__linux__))))
+    #undef  uSHELL_IMPLEMENTS_STACK_USAGE
+    #define uSHELL_IMPLEMENTS_STACK_USAGE        0
+#endif /*!(defined(ESP_PLATFORM) || (defined(__GLIBC__) || (defined(__GNUC__) && defined(__linux__))))*/
+
+/* the UART counters and the rate switch come from the bare-metal driver (libs/uart_access) */
+#if !defined(__xtensa__)
+    #undef  uSHELL_IMPLEMENTS_UART_STATS
+    #define uSHELL_IMPLEMENTS_UART_STATS         0
+    #undef  uSHELL_IMPLEMENTS_UART_CONFIG
+    #define uSHELL_IMPLEMENTS_UART_CONFIG        0
+#endif /*!defined(__xtensa__)*/
+
+/* the time budget needs a monotonic clock and thread local storage */
+#if (defined(_MSC_VER) || defined(__AVR__))
+    #undef  uSHELL_IMPLEMENTS_EXEC_TIMEOUT
+    #define uSHELL_IMPLEMENTS_EXEC_TIMEOUT       0
+#endif /*(defined(_MSC_VER) || defined(__AVR__))*/
+
+/* the timing statistics need the Xtensa cycle counter or a POSIX monotonic clock */
+#if !(defined(__xtensa__) || (defined(__GNUC__) && (defined(__linux__) || defined(__MINGW32__))))
+    #undef  uSHELL_IMPLEMENTS_EXEC_STATS
+    #define uSHELL_IMPLEMENTS_EXEC_STATS         0
+    #undef  uSHELL_IMPLEMENTS_KEY_LATENCY
+    #define uSHELL_IMPLEMENTS_KEY_LATENCY        0
+    #undef  uSHELL_IMPLEMENTS_BENCH
+    #define uSHELL_IMPLEMENTS_BENCH              0
+    #undef  uSHELL_IMPLEMENTS_TRACE
+    #define uSHELL_IMPLEMENTS_TRACE              0
+#endif /*!(defined(__xtensa__) || (defined(__GNUC__) && (defined(__linux__) || defined(__MINGW32__))))*/
+
+/* the trace ring is indexed by a mask */
+#if ((0 == uSHELL_TRACE_RECORDS) || (0 != (uSHELL_TRACE_RECORDS & (uSHELL_TRACE_RECORDS - 1U))))
+    #undef  uSHELL_IMPLEMENTS_TRACE
+    #define uSHELL_IMPLEMENTS_TRACE              0
+#endif /*((0 == uSHELL_TRACE_RECORDS) || (0 != (uSHELL_TRACE_RECORDS & (uSHELL_TRACE_RECORDS - 1U))))*/
+
+/* the execution and the key latency statistics, the bench and the trace share the ticks and the time printout */
+#if ((1 == uSHELL_IMPLEMENTS_EXEC_STATS) || (1 == uSHELL_IMPLEMENTS_KEY_LATENCY) || (1 == uSHELL_IMPLEMENTS_BENCH) || (1 == uSHELL_IMPLEMENTS_TRACE))
+    #define uSHELL_IMPLEMENTS_TIME_STATS         1
+#else
+    #define uSHELL_IMPLEMENTS_TIME_STATS         0
+#endif /*((1 == uSHELL_IMPLEMENTS_EXEC_STATS) || (1 == uSHELL_IMPLEMENTS_KEY_LATENCY) || (1 == uSHELL_IMPLEMENTS_BENCH) || (1 == uSHELL_IMPLEMENTS_TRACE))*/
+
+/* the coroutine commands need a C++20 compiler (i.e. -std=gnu++20, default of ESP-IDF v5) */
+#if !defined(__cpp_impl_coroutine)
+    #undef  uSHELL_IMPLEMENTS_COROUTINES
+    #define uSHELL_IMPLEMENTS_COROUTINES         0
+#endif /*!defined(__cpp_impl_coroutine)*/
+
 #if !(defined(__linux__) || defined(__MINGW32__) || defined(_MSC_VER))
     #undef uSHELL_IMPLEMENTS_SAVE_HISTORY
     #define uSHELL_IMPLEMENTS_SAVE_HISTORY 0
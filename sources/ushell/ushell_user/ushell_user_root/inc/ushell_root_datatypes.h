@@ -7,6 +7,12 @@
 #if (1 == uSHELL_IMPLEMENTS_USER_SHORTCUTS)
 #define uSHELL_USER_SHORTCUTS_CONFIG_FILE        "ushell_root_shortcuts.cfg"
 #endif /*(1 == uSHELL_IMPLEMENTS_USER_SHORTCUTS)*/
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPL_ARGS)
+#define uSHELL_COMPLETIONS_CONFIG_FILE           "ushell_root_completions.cfg"
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPL_ARGS)*/
+#if (1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT)
+#define uSHELL_TIMEOUTS_CONFIG_FILE              "ushell_root_timeouts.cfg"
+#endif /*(1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT)*/
 
 #include "ushell_core_datatypes_user.h"
 
@@ -1,11 +1,27 @@
 #include "ushell_core_settings.h"
 #include "ushell_core_datatypes.h"
 #include "ushell_root_datatypes.h"
+#include "ushell_core_autocompl.h"
 
 
 /* user commands dispatcher */
 static int uShellExecuteCommand( const command_s *psCmd );
 
+#if (1 == uSHELL_IMPLEMENTS_COROUTINES)
+/* user coroutine commands dispatcher */
+static int uShellSpawnCommand( const command_s *psCmd, uShellTask *psTask );
+#endif /*(1 == uSHELL_IMPLEMENTS_COROUTINES)*/
+
+#if (1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT)
+/* time budget provider */
+static uint32_t uShellCommandBudget( const int iFctIndex );
+#endif /*(1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT)*/
+
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPL_ARGS)
+/* arguments completion provider */
+static const autocomplIndex_s *uShellCompleteArgument( const int iFctIndex, const int iArgIndex );
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPL_ARGS)*/
+
 /* disable warnings */
 #if defined (__GNUC__) && defined(__AVR__)
     #pragma GCC diagnostic push
@@ -18,14 +34,16 @@ static int uShellExecuteCommand( const command_s *psCmd );
 #endif /*(defined(__GNUC__) && defined(__xtensa__))*/
 
 /** \brief define array of functions (basic properties) */
-#define  uSHELL_COMMANDS_TABLE_BEGIN                        static const fctDef_s g_vsFuncDefArray[] = {
+#define  uSHELL_COMMANDS_TABLE_BEGIN                        static constexpr fctDef_s g_vsFuncDefArray[] = {
 #define  uSHELL_COMMAND_PARAMS_PATTERN(t)
 #define  uSHELL_COMMAND(a,b,c)                                  { #a, #b },
+#define  uSHELL_COROUTINE(a,b,c)                                { #a, #b },
 #define  uSHELL_COMMANDS_TABLE_END                          };
 #include uSHELL_COMMANDS_CONFIG_FILE
 #undef   uSHELL_COMMANDS_TABLE_BEGIN
 #undef   uSHELL_COMMAND_PARAMS_PATTERN
 #undef   uSHELL_COMMAND
+#undef   uSHELL_COROUTINE
 #undef   uSHELL_COMMANDS_TABLE_END
 
 /** \brief define array of functions (extended properties) */
@@ -50,11 +68,13 @@ static int uShellExecuteCommand( const command_s *psCmd );
 #else
     #error "Build variant not defined, please define it..."
 #endif
+#define  uSHELL_COROUTINE(a,b,c)                                { { .b##_coro = a }, b##_type, true },
 #define  uSHELL_COMMANDS_TABLE_END                          };
 #include uSHELL_COMMANDS_CONFIG_FILE
 #undef   uSHELL_COMMANDS_TABLE_BEGIN
 #undef   uSHELL_COMMAND_PARAMS_PATTERN
 #undef   uSHELL_COMMAND
+#undef   uSHELL_COROUTINE
 #undef   uSHELL_COMMANDS_TABLE_END
 
 /* end of disable warnings */
@@ -67,22 +87,90 @@ static int uShellExecuteCommand( const command_s *psCmd );
     #define  uSHELL_COMMANDS_TABLE_BEGIN                    static const char* const g_vstrInfoArray[] = {
     #define  uSHELL_COMMAND_PARAMS_PATTERN(t)
     #define  uSHELL_COMMAND(a,b,c)                              c,
+    #define  uSHELL_COROUTINE(a,b,c)                            c,
     #define  uSHELL_COMMANDS_TABLE_END                      };
     #include uSHELL_COMMANDS_CONFIG_FILE
     #undef   uSHELL_COMMANDS_TABLE_BEGIN
     #undef   uSHELL_COMMAND_PARAMS_PATTERN
     #undef   uSHELL_COMMAND
+    #undef   uSHELL_COROUTINE
     #undef   uSHELL_COMMANDS_TABLE_END
 #endif /*(1 == uSHELL_IMPLEMENTS_COMMAND_HELP)*/
 
-/* autocomplete index array */
+/* autocomplete index (prefix trie generated at compile time) */
 #if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
-static int g_viAutocompleteIndexArray[uSHELL_NR_ELEMS(g_vsFuncDefArray)] = {0};
+static constexpr auto g_sAutocomplTrie = uSHELL_AUTOCOMPL_TRIE(g_vsFuncDefArray);
+static const autocomplIndex_s g_sAutocomplIndex = uSHELL_AUTOCOMPL_INDEX(g_sAutocomplTrie, g_vsFuncDefArray);
 #endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)*/
 
+#if ((1 == uSHELL_IMPLEMENTS_AUTOCOMPL_ARGS) || (1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT))
+/* index of the functions in the array */
+#define  uSHELL_COMMANDS_TABLE_BEGIN                        enum {
+#define  uSHELL_COMMAND_PARAMS_PATTERN(t)
+#define  uSHELL_COMMAND(a,b,c)                                  uSHELL_FCT_INDEX_##a,
+#define  uSHELL_COROUTINE(a,b,c)                                uSHELL_FCT_INDEX_##a,
+#define  uSHELL_COMMANDS_TABLE_END                          };
+#include uSHELL_COMMANDS_CONFIG_FILE
+#undef   uSHELL_COMMANDS_TABLE_BEGIN
+#undef   uSHELL_COMMAND_PARAMS_PATTERN
+#undef   uSHELL_COMMAND
+#undef   uSHELL_COROUTINE
+#undef   uSHELL_COMMANDS_TABLE_END
+#endif /*((1 == uSHELL_IMPLEMENTS_AUTOCOMPL_ARGS) || (1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT))*/
+
+#if (1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT)
+/* time budgets overriding uSHELL_EXEC_TIMEOUT_MS */
+typedef struct {
+    int                     iFctIndex;
+    uint32_t                u32BudgetMs;
+} budgetBinding_s;
+
+#define  uSHELL_TIMEOUTS_TABLE_BEGIN                        static const budgetBinding_s g_vsBudgetsArray[] = {
+#define  uSHELL_TIMEOUT(a,ms)                                   { uSHELL_FCT_INDEX_##a, ms },
+#define  uSHELL_TIMEOUTS_TABLE_END                              { -1, 0U } };
+#include uSHELL_TIMEOUTS_CONFIG_FILE
+#undef   uSHELL_TIMEOUTS_TABLE_BEGIN
+#undef   uSHELL_TIMEOUT
+#undef   uSHELL_TIMEOUTS_TABLE_END
+#endif /*(1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT)*/
+
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPL_ARGS)
+/* arguments values and their autocomplete indexes (prefix tries generated at compile time) */
+#define  uSHELL_COMPLETIONS_TABLE_BEGIN
+#define  uSHELL_COMPLETION_VALUES(n,...)                    static constexpr const char *g_vstrComplValues_##n[] = { __VA_ARGS__ }; \
+                                                            static constexpr auto g_sComplTrie_##n = uSHELL_AUTOCOMPL_TRIE(g_vstrComplValues_##n); \
+                                                            static const autocomplIndex_s g_sComplIndex_##n = uSHELL_AUTOCOMPL_INDEX(g_sComplTrie_##n, g_vstrComplValues_##n);
+#define  uSHELL_COMPLETION(a,i,n)                           static_assert(('v' != g_vsFuncDefArray[uSHELL_FCT_INDEX_##a].pstrFuncParamDef[0]) && \
+                                                                          ((i) < uShellAutocomplStrlen(g_vsFuncDefArray[uSHELL_FCT_INDEX_##a].pstrFuncParamDef)), \
+                                                                          "completion of " #a ": argument " #i " not in the parameters pattern");
+#define  uSHELL_COMPLETIONS_TABLE_END
+#include uSHELL_COMPLETIONS_CONFIG_FILE
+#undef   uSHELL_COMPLETIONS_TABLE_BEGIN
+#undef   uSHELL_COMPLETION_VALUES
+#undef   uSHELL_COMPLETION
+#undef   uSHELL_COMPLETIONS_TABLE_END
+
+/* arguments bound to values */
+typedef struct {
+    int                     iFctIndex;
+    int                     iArgIndex;
+    const autocomplIndex_s *psIndex;
+} complBinding_s;
+
+#define  uSHELL_COMPLETIONS_TABLE_BEGIN                     static const complBinding_s g_vsComplBindingsArray[] = {
+#define  uSHELL_COMPLETION_VALUES(n,...)
+#define  uSHELL_COMPLETION(a,i,n)                               { uSHELL_FCT_INDEX_##a, i, &g_sComplIndex_##n },
+#define  uSHELL_COMPLETIONS_TABLE_END                           { -1, -1, nullptr } };
+#include uSHELL_COMPLETIONS_CONFIG_FILE
+#undef   uSHELL_COMPLETIONS_TABLE_BEGIN
+#undef   uSHELL_COMPLETION_VALUES
+#undef   uSHELL_COMPLETION
+#undef   uSHELL_COMPLETIONS_TABLE_END
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPL_ARGS)*/
+
 /* user shortcuts array */
 #if (1 == uSHELL_IMPLEMENTS_USER_SHORTCUTS)
-#define  uSHELL_USER_SHORTCUTS_TABLE_BEGIN                  static shortcut_s g_vsShortcutsArray[] = { { ' ', nullptr }
+#define  uSHELL_USER_SHORTCUTS_TABLE_BEGIN                  static const shortcut_s g_vsShortcutsArray[] = { { ' ', nullptr }
 #define  uSHELL_USER_SHORTCUT(a,b,c)                            ,{ a, uShellUserHandleShortcut_##b }
 #define  uSHELL_USER_SHORTCUTS_TABLE_END                    };
 #include uSHELL_USER_SHORTCUTS_CONFIG_FILE
@@ -90,7 +178,7 @@ static int g_viAutocompleteIndexArray[uSHELL_NR_ELEMS(g_vsFuncDefArray)] = {0};
 #undef   uSHELL_USER_SHORTCUT
 #undef   uSHELL_USER_SHORTCUTS_TABLE_END
 #else
-static shortcut_s g_vsShortcutsArray[] =                    { { ' ', nullptr } };
+static const shortcut_s g_vsShortcutsArray[] =                    { { ' ', nullptr } };
 #endif /*(1 == uSHELL_IMPLEMENTS_USER_SHORTCUTS)*/
 
 #if (1 == uSHELL_IMPLEMENTS_USER_SHORTCUTS)
@@ -104,8 +192,8 @@ static shortcut_s g_vsShortcutsArray[] =                    { { ' ', nullptr } }
     #undef   uSHELL_USER_SHORTCUTS_TABLE_END
 #endif /*(1 == uSHELL_IMPLEMENTS_USER_SHORTCUTS)*/
 
-/* partial initialization of the shell instance structure */
-static uShellInst_s sShellInstance = {
+/* shell instance structure, shared read-only by all the shell instances */
+static const uShellInst_s sShellInstance = {
     .psFuncDefArray                                         = g_vsFuncDefArray,
     .psShortcutsArray                                       = g_vsShortcutsArray,
 #if (1 == uSHELL_IMPLEMENTS_COMMAND_HELP)
@@ -115,25 +203,34 @@ static uShellInst_s sShellInstance = {
 #endif /*(1 == uSHELL_IMPLEMENTS_USER_SHORTCUTS)*/
 #endif /* (1 == uSHELL_IMPLEMENTS_COMMAND_HELP) */
 #if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
-    .piAutocompleteIndexArray                               = g_viAutocompleteIndexArray,
+    .psAutocomplIndex                                       = &g_sAutocomplIndex,
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPL_ARGS)
+    .pfComplete                                             = uShellCompleteArgument,
+#endif /* (1 == uSHELL_IMPLEMENTS_AUTOCOMPL_ARGS) */
 #endif /* (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE) */
-#if (1 == uSHELL_IMPLEMENTS_SAVE_HISTORY)
-    .pfileHistory                                           = nullptr,
-#endif /*(1 == uSHELL_IMPLEMENTS_SAVE_HISTORY)*/
-#if (1 == uSHELL_IMPLEMENTS_SHELL_EXIT)
-    .bKeepRuning                                            = true,
-#endif /*(1 == uSHELL_IMPLEMENTS_SHELL_EXIT)*/
     .iNrFunctions                                           = uSHELL_NR_ELEMS(g_vsFuncDefArray),
     .iNrShortcuts                                           = uSHELL_NR_ELEMS(g_vsShortcutsArray),
     .pfExec                                                 = uShellExecuteCommand,
-    .vstrPrompt                                             = {0},
-    .iPromptLength                                          = 0
+#if (1 == uSHELL_IMPLEMENTS_COROUTINES)
+    .pfSpawn                                                = uShellSpawnCommand,
+#endif /*(1 == uSHELL_IMPLEMENTS_COROUTINES)*/
+#if (1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT)
+    .pfBudget                                               = uShellCommandBudget,
+#endif /*(1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT)*/
 };
 
 
 /******************************************************************************/
 static int uShellExecuteCommand( const command_s *psCmd )
 {
+#if (1 == uSHELL_IMPLEMENTS_COROUTINES)
+    /* a coroutine started from a job or from Execute() runs to its end */
+    uShellTask sTask;
+    const int iSpawn = uShellSpawnCommand(psCmd, &sTask);
+    if(uSHELL_ERR_ITEM_NOT_FOUND != iSpawn) {
+        return (uSHELL_ERR_OK == iSpawn) ? sTask.Complete() : iSpawn;
+    }
+#endif /*(1 == uSHELL_IMPLEMENTS_COROUTINES)*/
     /* void:v, (byte)u8:b:vb, (word)u16:w:vw, (int)u32:i:vi, (long)u64:l:vl, float:f:vf, string:s:vs, bool:o:vo */
     switch(g_vsFuncDefExArray[psCmd->iFctIndex].eParamType) {
         case v_type          :return g_vsFuncDefExArray[psCmd->iFctIndex].uFctType.v_fct          ();
@@ -148,8 +245,60 @@ static int uShellExecuteCommand( const command_s *psCmd )
 } /* priv_uShellCoreExecuteCommand() */
 
 
+#if (1 == uSHELL_IMPLEMENTS_COROUTINES)
+/******************************************************************************/
+static int uShellSpawnCommand( const command_s *psCmd, uShellTask *psTask )
+{
+    if(false == g_vsFuncDefExArray[psCmd->iFctIndex].bCoroutine) {
+        return uSHELL_ERR_ITEM_NOT_FOUND;
+    }
+    /* the coroutine gets its own copy of the arguments, the frame is only suspended here */
+    switch(g_vsFuncDefExArray[psCmd->iFctIndex].eParamType) {
+        case v_type          :*psTask = g_vsFuncDefExArray[psCmd->iFctIndex].uFctType.v_coro        (); break;
+        case i_type          :*psTask = g_vsFuncDefExArray[psCmd->iFctIndex].uFctType.i_coro        (psCmd->vi[0]); break;
+        case s_type          :*psTask = g_vsFuncDefExArray[psCmd->iFctIndex].uFctType.s_coro        (psCmd->vs[0]); break;
+        case ii_type         :*psTask = g_vsFuncDefExArray[psCmd->iFctIndex].uFctType.ii_coro       (psCmd->vi[0], psCmd->vi[1]); break;
+        case ss_type         :*psTask = g_vsFuncDefExArray[psCmd->iFctIndex].uFctType.ss_coro       (psCmd->vs[0], psCmd->vs[1]); break;
+        case is_type         :*psTask = g_vsFuncDefExArray[psCmd->iFctIndex].uFctType.is_coro       (psCmd->vi[0], psCmd->vs[0]); break;
+        case lio_type        :*psTask = g_vsFuncDefExArray[psCmd->iFctIndex].uFctType.lio_coro      (psCmd->vl[0], psCmd->vi[0], psCmd->vo[0]); break;
+        default              :return uSHELL_ERR_PARAMS_PATTERN_NOT_IMPLEM;
+    }
+    return (true == psTask->Valid()) ? uSHELL_ERR_OK : uSHELL_ERR_NO_MEMORY;
+} /* uShellSpawnCommand() */
+#endif /*(1 == uSHELL_IMPLEMENTS_COROUTINES)*/
+
+
+#if (1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT)
+/******************************************************************************/
+static uint32_t uShellCommandBudget( const int iFctIndex )
+{
+    for(const budgetBinding_s *psBinding = g_vsBudgetsArray; -1 != psBinding->iFctIndex; ++psBinding) {
+        if(iFctIndex == psBinding->iFctIndex) {
+            return psBinding->u32BudgetMs;
+        }
+    }
+    return uSHELL_EXEC_TIMEOUT_MS;
+} /* uShellCommandBudget() */
+#endif /*(1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT)*/
+
+
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPL_ARGS)
+/******************************************************************************/
+static const autocomplIndex_s *uShellCompleteArgument( const int iFctIndex, const int iArgIndex )
+{
+    /* called only when the completed argument changes, not for every key */
+    for(const complBinding_s *psBinding = g_vsComplBindingsArray; nullptr != psBinding->psIndex; ++psBinding) {
+        if((iFctIndex == psBinding->iFctIndex) && (iArgIndex == psBinding->iArgIndex)) {
+            return psBinding->psIndex;
+        }
+    }
+    return nullptr;
+} /* uShellCompleteArgument() */
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPL_ARGS)*/
+
+
 /******************************************************************************/
-uShellInst_s *pluginEntry( void )
+const uShellInst_s *pluginEntry( void )
 {
     return &sShellInstance;
 }
@@ -1,6 +1,6 @@
 #include "ushell_core_utils.h"
-#include "ushell_core_printout.h"
 #include "ushell_core_settings.h"
+#include "ushell_core_coroutine.h"
 
 #include <stdint.h>
 #include <string.h>
@@ -25,7 +25,7 @@ Note:
 /*---------------------------------------------------------------*/
 int vtest(void)
 {
-    uSHELL_PRINTF("--> vtest()\n");
+    uShellPrintf("--> vtest()\n");
 
     return 0;
 }
@@ -35,42 +35,74 @@ int vhexlify(void)
 {
     int iRetVal = SHELLFCT_RETVAL_ERR;
 
-    uSHELL_PRINTF("--> vhexlify()\n");
+    uShellPrintf("--> vhexlify()\n");
 
     #define TEST_LEN 16U
     const uint8_t pu8InBuf[TEST_LEN] = {0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15};
-    char *pstrOutBuf = (char*)malloc(TEST_LEN*2 + 1);
+    char *pstrOutBuf = (char*)uSHELL_MALLOC(TEST_LEN*2 + 1, uSHELL_HEAP_COMMANDS);
 
     if (nullptr != pstrOutBuf) {
         for (unsigned int i = 0; i < TEST_LEN; ++i) {
-            uSHELL_PRINTF("%d : %d (0x%02X)\n", i, pu8InBuf[i], pu8InBuf[i]);
+            uShellPrintf("%d : %d (0x%02X)\n", i, pu8InBuf[i], pu8InBuf[i]);
         }
 
         hexlify(pu8InBuf, TEST_LEN, pstrOutBuf);
-        uSHELL_PRINTF("result: [%s]\n", pstrOutBuf);
-        free(pstrOutBuf);
+        uShellPrintf("result: [%s]\n", pstrOutBuf);
+        uSHELL_FREE(pstrOutBuf);
         iRetVal = 0;
     } else {
-        uSHELL_PRINTF("malloc failed\n");
+        uShellPrintf("malloc failed\n");
     }
 
     return iRetVal;
 }
 
+#if (1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT)
+/*---------------------------------------------------------------*/
+int vbusy(void)
+{
+    uint32_t u32Loops = 0;
+
+    uShellPrintf("--> vbusy()\n");
+
+    while (true == uShellYield()) {     /* feeds the watchdog, false when the budget is spent */
+        ++u32Loops;
+    }
+    uShellPrintf("stopped after %u loops\n", u32Loops);
+
+    return 0;
+}
+#endif /*(1 == uSHELL_IMPLEMENTS_EXEC_TIMEOUT)*/
+
 /*---------------------------------------------------------------*/
 int itest(uint32_t i)
 {
-    uSHELL_PRINTF("--> itest()\n");
-    uSHELL_PRINTF("i = %u\n", i );
+    uShellPrintf("--> itest()\n");
+    uShellPrintf("i = %u\n", i );
 
     return 0;
 }
 
+#if (1 == uSHELL_IMPLEMENTS_COROUTINES)
+/*---------------------------------------------------------------*/
+uShellTask ilist(uint32_t i)
+{
+    uShellPrintf("--> ilist()\n");
+
+    for (uint32_t iLine = 0; iLine < i; ++iLine) {
+        co_yield 32;    /* the shell resumes it when 32 bytes fit in the TX path */
+        uShellPrintf("line %u / %u\n", iLine + 1, i);
+    }
+
+    co_return 0;
+}
+#endif /*(1 == uSHELL_IMPLEMENTS_COROUTINES)*/
+
 /*---------------------------------------------------------------*/
 int stest(char *s)
 {
-    uSHELL_PRINTF("--> stest()\n");
-    uSHELL_PRINTF("s = %s\n", s );
+    uShellPrintf("--> stest()\n");
+    uShellPrintf("s = %s\n", s );
 
     return 0;
 }
@@ -80,29 +112,29 @@ int sunhexlify(char *s)
 {
     int iRetVal = SHELLFCT_RETVAL_ERR;
 
-    uSHELL_PRINTF("--> sunhexlify()\n");
+    uShellPrintf("--> sunhexlify()\n");
 
     size_t szLen = strlen(s);
     if (0 != szLen) {
-        uint8_t *pu8Buf = (uint8_t*)malloc(szLen/2 + 1);
+        uint8_t *pu8Buf = (uint8_t*)uSHELL_MALLOC(szLen/2 + 1, uSHELL_HEAP_COMMANDS);
 
         if (nullptr != pu8Buf) {
             size_t szOutLen = 0;
 
             if (unhexlify(s, pu8Buf, &szOutLen)) {
                 for (unsigned int i = 0; i < szOutLen; ++i) {
-                    uSHELL_PRINTF("%d : %d (0x%02X)\n", i, pu8Buf[i], pu8Buf[i]);
+                    uShellPrintf("%d : %d (0x%02X)\n", i, pu8Buf[i], pu8Buf[i]);
                 }
                 iRetVal = 0;
             } else {
-                uSHELL_PRINTF("unhexlify failed (len || content)\n");
+                uShellPrintf("unhexlify failed (len || content)\n");
             }
-            free(pu8Buf);
+            uSHELL_FREE(pu8Buf);
         } else {
-            uSHELL_PRINTF("malloc failed\n");
+            uShellPrintf("malloc failed\n");
         }
     } else {
-        uSHELL_PRINTF("empty string\n");
+        uShellPrintf("empty string\n");
     }
 
     return iRetVal;
@@ -111,9 +143,9 @@ int sunhexlify(char *s)
 /*---------------------------------------------------------------*/
 int iitest(uint32_t i1, uint32_t i2)
 {
-    uSHELL_PRINTF("--> iitest()\n");
-    uSHELL_PRINTF("i1 = %d\n", i1 );
-    uSHELL_PRINTF("i2 = %d\n", i2 );
+    uShellPrintf("--> iitest()\n");
+    uShellPrintf("i1 = %d\n", i1 );
+    uShellPrintf("i2 = %d\n", i2 );
 
     return 0;
 }
@@ -121,9 +153,9 @@ int iitest(uint32_t i1, uint32_t i2)
 /*---------------------------------------------------------------*/
 int istest(uint32_t i, char *s)
 {
-    uSHELL_PRINTF("--> istest()\n");
-    uSHELL_PRINTF("i = %d\n", i );
-    uSHELL_PRINTF("s = %s\n", s );
+    uShellPrintf("--> istest()\n");
+    uShellPrintf("i = %d\n", i );
+    uShellPrintf("s = %s\n", s );
 
     return 0;
 }
@@ -131,9 +163,9 @@ int istest(uint32_t i, char *s)
 /*---------------------------------------------------------------*/
 int sstest(char *s1, char *s2)
 {
-    uSHELL_PRINTF("--> sstest()\n");
-    uSHELL_PRINTF("s1 = %s\n", s1 );
-    uSHELL_PRINTF("s2 = %s\n", s2 );
+    uShellPrintf("--> sstest()\n");
+    uShellPrintf("s1 = %s\n", s1 );
+    uShellPrintf("s2 = %s\n", s2 );
 
     return 0;
 }
@@ -141,10 +173,10 @@ int sstest(char *s1, char *s2)
 /*---------------------------------------------------------------*/
 int liotest(uint64_t l, uint32_t i, bool o)
 {
-    uSHELL_PRINTF("--> liotest()\n");
-    uSHELL_PRINTF("l = %ld\n", l );
-    uSHELL_PRINTF("i = %d\n", i );
-    uSHELL_PRINTF("o = %d\n", o );
+    uShellPrintf("--> liotest()\n");
+    uShellPrintf("l = %ld\n", l );
+    uShellPrintf("i = %d\n", i );
+    uShellPrintf("o = %d\n", o );
 
     return 0;
 }
@@ -159,7 +191,7 @@ int liotest(uint64_t l, uint32_t i, bool o)
 
 void uShellUserHandleShortcut_Dot( const char *pstrArgs )
 {
-    uSHELL_PRINTF("[.] registered but not implemented | args[%s]\n", pstrArgs);
+    uShellPrintf("[.] registered but not implemented | args[%s]\n", pstrArgs);
 
 } /* uShellUserHandleShortcut_Dot() */
 
@@ -167,7 +199,7 @@ void uShellUserHandleShortcut_Dot( const char *pstrArgs )
 /******************************************************************************/
 void uShellUserHandleShortcut_Slash( const char *pstrArgs )
 {
-    uSHELL_PRINTF("[/] registered but not implemented | args[%s]\n", pstrArgs);
+    uShellPrintf("[/] registered but not implemented | args[%s]\n", pstrArgs);
 
 } /* uShellUserHandleShortcut_Slash() */
 